@@ -22,7 +22,7 @@ class broadphase final {
 
     void collide_tree(const dynamic_tree &tree, entt::entity entity, const AABB &offset_aabb) const;
     void collide_tree_async(const dynamic_tree &tree, entt::entity entity, const AABB &offset_aabb, size_t result_index);
-    void collide_parallel();
+    void collide_parallel(bool mt);
     void finish_collide();
 
     void on_construct_aabb(entt::registry &, entt::entity);
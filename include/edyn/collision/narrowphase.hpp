@@ -10,11 +10,13 @@
 #include "edyn/comp/position.hpp"
 #include "edyn/comp/orientation.hpp"
 #include "edyn/comp/tag.hpp"
+#include "edyn/comp/rotated_mesh_list.hpp"
 #include "edyn/collision/contact_manifold.hpp"
 #include "edyn/collision/contact_point.hpp"
 #include "edyn/collision/collision_result.hpp"
 #include "edyn/util/collision_util.hpp"
 #include "edyn/context/settings.hpp"
+#include "edyn/sys/update_rotated_meshes.hpp"
 
 namespace edyn {
 
@@ -29,9 +31,22 @@ class narrowphase {
         size_t count {0};
     };
 
+    void prefetch_paged_mesh_pages();
+
+    template<typename Iterator>
+    void update_manifold_rotated_meshes(Iterator begin, Iterator end);
+
     void detect_collision_parallel();
     void detect_collision_parallel_range(unsigned start, unsigned end);
     void finish_detect_collision();
+    void detect_collision_deterministic(bool mt);
+    void detect_collision_deterministic_range(unsigned start, unsigned end);
+
+    template<typename Iterator>
+    void detect_collision_range(Iterator first, unsigned start, unsigned end);
+
+    template<typename Iterator>
+    void finish_detect_collision(Iterator first, size_t count);
     void clear_contact_manifold_events();
 
 public:
@@ -49,11 +64,43 @@ private:
     entt::registry *m_registry;
     std::vector<contact_point_construction_info> m_cp_construction_infos;
     std::vector<contact_point_destruction_info> m_cp_destruction_infos;
+    std::vector<entt::entity> m_rotated_mesh_entities;
+    std::vector<entt::entity> m_deterministic_manifolds;
     size_t m_max_sequential_size {4};
 };
 
+template<typename Iterator>
+void narrowphase::update_manifold_rotated_meshes(Iterator begin, Iterator end) {
+    // Rotated meshes are only needed for collision detection, thus they're
+    // only updated for bodies in a manifold. Bodies that appear in more than
+    // one manifold are skipped after the first update since their orientation
+    // will match the orientation of the rotated mesh.
+    auto rotated_view = m_registry->view<rotated_mesh_list>();
+
+    if (rotated_view.size() == 0) {
+        return;
+    }
+
+    auto manifold_view = m_registry->view<contact_manifold>();
+    m_rotated_mesh_entities.clear();
+
+    for (auto it = begin; it != end; ++it) {
+        auto &manifold = manifold_view.template get<contact_manifold>(*it);
+
+        for (auto body_entity : manifold.body) {
+            if (rotated_view.contains(body_entity)) {
+                m_rotated_mesh_entities.push_back(body_entity);
+            }
+        }
+    }
+
+    update_rotated_meshes(*m_registry, m_rotated_mesh_entities);
+}
+
 template<typename Iterator>
 void narrowphase::update_contact_manifolds(Iterator begin, Iterator end) {
+    update_manifold_rotated_meshes(begin, end);
+
     auto manifold_view = m_registry->view<contact_manifold>();
     auto events_view = m_registry->view<contact_manifold_events>();
     auto body_view = m_registry->view<AABB, shape_index, position, orientation>();
@@ -6,44 +6,124 @@
 #include <iterator>
 #include <numeric>
 #include <algorithm>
-#include "edyn/collision/query_tree.hpp"
+#include <array>
+#include <cmath>
+#include <entt/signal/delegate.hpp>
+#include "edyn/math/geom.hpp"
+#include "edyn/context/task.hpp"
 
 namespace edyn {
 
 constexpr uint32_t EDYN_NULL_NODE = UINT32_MAX;
 
 namespace detail {
+    /**
+     * @brief Splits a set of AABBs in two using a binned surface area
+     * heuristic (SAH). The centers are projected into a fixed number of bins
+     * along each axis and the split between bins which minimizes the sum of
+     * the surface area of each side weighted by their number of objects is
+     * chosen. Runs in linear time.
+     * @param aabb_begin Begin of all AABBs.
+     * @param centers Centers of all AABBs.
+     * @param ids_begin Begin of range of ids of AABBs to be split.
+     * @param ids_end End of range of ids of AABBs to be split.
+     * @return Iterator to the first id of the second set.
+     */
     template<typename Iterator_AABB, typename Iterator_ids>
-    Iterator_ids aabb_set_partition(Iterator_AABB aabb_begin, Iterator_AABB aabb_end,
-                                    Iterator_ids ids_begin, Iterator_ids ids_end,
-                                    const AABB &set_aabb) {
-        auto aabb_size = set_aabb.max - set_aabb.min;
-        auto split_axis_idx = max_index(aabb_size);
-        auto split_pos = set_aabb.center()[split_axis_idx];
-
-        std::sort(ids_begin, ids_end, [&](auto a, auto b) {
-            auto &b0 = *(aabb_begin + a);
-            auto &b1 = *(aabb_begin + b);
-            auto ca = b0.center();
-            auto cb = b1.center();
-            return ca[split_axis_idx] < cb[split_axis_idx];
-        });
+    Iterator_ids aabb_set_partition(Iterator_AABB aabb_begin, const std::vector<vector3> &centers,
+                                    Iterator_ids ids_begin, Iterator_ids ids_end) {
+        constexpr size_t num_bins = 16;
+        constexpr auto empty_aabb = AABB{vector3_max, -vector3_max};
+
+        auto center_min = centers[*ids_begin];
+        auto center_max = center_min;
+
+        for (auto it = ids_begin + 1; it != ids_end; ++it) {
+            center_min = min(center_min, centers[*it]);
+            center_max = max(center_max, centers[*it]);
+        }
+
+        auto best_cost = EDYN_SCALAR_MAX;
+        auto best_axis = size_t{3};
+        auto best_bin = size_t{};
+        auto best_scale = scalar{};
+
+        auto get_bin = [&](uint32_t id, size_t axis, scalar scale) {
+            auto bin = static_cast<size_t>((centers[id][axis] - center_min[axis]) * scale);
+            return std::min(bin, num_bins - 1);
+        };
+
+        for (size_t axis = 0; axis < 3; ++axis) {
+            auto extent = center_max[axis] - center_min[axis];
+
+            if (!(extent > 0)) {
+                continue;
+            }
+
+            auto scale = scalar(num_bins) / extent;
+            auto bin_aabbs = std::array<AABB, num_bins>{};
+            auto bin_counts = std::array<size_t, num_bins>{};
+            bin_aabbs.fill(empty_aabb);
+
+            for (auto it = ids_begin; it != ids_end; ++it) {
+                auto bin = get_bin(*it, axis, scale);
+                bin_aabbs[bin] = enclosing_aabb(bin_aabbs[bin], *(aabb_begin + *it));
+                ++bin_counts[bin];
+            }
+
+            // Sweep from the right to obtain the area and count of the right
+            // side of each split, then sweep from the left to evaluate cost.
+            auto right_areas = std::array<scalar, num_bins - 1>{};
+            auto right_counts = std::array<size_t, num_bins - 1>{};
+            auto right_aabb = empty_aabb;
+            auto right_count = size_t{};
+
+            for (auto i = num_bins - 1; i > 0; --i) {
+                right_aabb = enclosing_aabb(right_aabb, bin_aabbs[i]);
+                right_count += bin_counts[i];
+                right_areas[i - 1] = right_count > 0 ? right_aabb.area() : scalar(0);
+                right_counts[i - 1] = right_count;
+            }
+
+            auto left_aabb = empty_aabb;
+            auto left_count = size_t{};
+
+            for (size_t i = 0; i < num_bins - 1; ++i) {
+                left_aabb = enclosing_aabb(left_aabb, bin_aabbs[i]);
+                left_count += bin_counts[i];
+
+                if (left_count == 0 || right_counts[i] == 0) {
+                    continue;
+                }
 
-        for (auto it = ids_begin; it != ids_end; ++it) {
-            auto &aabb = *(aabb_begin + *it);
-            auto center = aabb.center();
+                auto cost = left_aabb.area() * left_count + right_areas[i] * right_counts[i];
 
-            if (center[split_axis_idx] > split_pos) {
-                return it;
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = i;
+                    best_scale = scale;
+                }
             }
         }
 
-        return ids_begin + std::distance(ids_begin, ids_end) / 2;
+        if (best_axis == 3) {
+            // All centers coincide. Split in half.
+            return ids_begin + std::distance(ids_begin, ids_end) / 2;
+        }
+
+        return std::partition(ids_begin, ids_end, [&](auto id) {
+            return get_bin(id, best_axis, best_scale) <= best_bin;
+        });
     }
 }
 
 class static_tree {
 public:
+    /**
+     * @brief Node used while building the tree. Passed to the `report_leaf`
+     * function in `build`, which must assign the leaf id.
+     */
     struct tree_node {
         AABB aabb;
         uint32_t child1;
@@ -57,77 +137,278 @@ public:
         }
     };
 
+    /**
+     * @brief Compact node stored in the tree. Nodes are laid out in
+     * depth-first order, thus the first child of an internal node immediately
+     * follows its parent. Bounds are quantized to 16-bit integers relative to
+     * the bounds of the parent node and are rounded outwards, which means the
+     * decoded AABB always contains the original AABB.
+     */
+    struct compact_node {
+        static constexpr uint32_t leaf_bit = uint32_t(1) << 31;
+        static constexpr scalar quantization_max = 65535;
+
+        std::array<uint16_t, 3> min;
+        std::array<uint16_t, 3> max;
+        // Index of the second child for internal nodes or the leaf id with
+        // the `leaf_bit` set for leaf nodes.
+        uint32_t data;
+
+        bool leaf() const {
+            return (data & leaf_bit) != 0;
+        }
+
+        uint32_t id() const {
+            EDYN_ASSERT(leaf());
+            return data & ~leaf_bit;
+        }
+
+        uint32_t child2() const {
+            EDYN_ASSERT(!leaf());
+            return data;
+        }
+
+        AABB decode(const AABB &parent_aabb) const {
+            auto scale = (parent_aabb.max - parent_aabb.min) / quantization_max;
+            auto aabb = AABB{};
+
+            // The extremes map exactly onto the parent bounds.
+            for (size_t i = 0; i < 3; ++i) {
+                aabb.min[i] = min[i] == quantization_max ? parent_aabb.max[i] :
+                              parent_aabb.min[i] + scalar(min[i]) * scale[i];
+                aabb.max[i] = max[i] == quantization_max ? parent_aabb.max[i] :
+                              parent_aabb.min[i] + scalar(max[i]) * scale[i];
+            }
+
+            return aabb;
+        }
+    };
+
+    static_assert(sizeof(compact_node) == 16);
+
     AABB root_aabb() const {
         EDYN_ASSERT(!m_nodes.empty());
-        return m_nodes.front().aabb;
+        return m_root_aabb;
     }
 
     bool empty() const {
         return m_nodes.empty();
     }
 
-    const tree_node & get_node(uint32_t id) const {
-        return m_nodes[id];
+    size_t num_nodes() const {
+        return m_nodes.size();
+    }
+
+    /**
+     * @brief Decodes a node. Its bounds are decoded along the path from the
+     * root, thus it takes logarithmic time.
+     * @param node_idx Index of a node in depth-first order, which is less
+     * than `num_nodes()`.
+     * @return Node with its child indices or leaf id.
+     */
+    [[deprecated("The visitors of `query` and `raycast` receive the leaf id instead of a node index.")]]
+    tree_node get_node(uint32_t node_idx) const {
+        EDYN_ASSERT(node_idx < m_nodes.size());
+        auto idx = uint32_t{0};
+        auto aabb = m_nodes[0].decode(m_root_aabb);
+
+        // The subtree of the first child precedes the second child.
+        while (idx != node_idx) {
+            auto &node = m_nodes[idx];
+            EDYN_ASSERT(!node.leaf());
+            idx = node_idx < node.child2() ? idx + 1 : node.child2();
+            aabb = m_nodes[idx].decode(aabb);
+        }
+
+        auto &node = m_nodes[idx];
+        auto result = tree_node{};
+        result.aabb = aabb;
+
+        if (node.leaf()) {
+            result.child1 = EDYN_NULL_NODE;
+            result.id = node.id();
+        } else {
+            result.child1 = idx + 1;
+            result.child2 = node.child2();
+        }
+
+        return result;
     }
 
+    /**
+     * @brief Visits the leaves which intersect the given AABB.
+     * @param aabb Query AABB.
+     * @param func Called with the id of each leaf.
+     */
     template<typename Func>
     void query(const AABB &aabb, Func func) const;
 
+    /**
+     * @brief Visits the leaves which intersect the given segment.
+     * @param p0 First point in the segment.
+     * @param p1 Second point in the segment.
+     * @param func Called with the id of each leaf.
+     */
     template<typename Func>
     void raycast(vector3 p0, vector3 p1, Func func) const;
 
+    /**
+     * @brief Builds the tree from a set of AABBs.
+     * @param aabb_begin Begin of AABBs of the objects in the tree.
+     * @param aabb_end End of AABBs of the objects in the tree.
+     * @param report_leaf Called for each leaf with the leaf node and the range
+     * of ids of the objects it contains. It must assign the node id. All calls
+     * happen in the calling thread after all nodes have been created, in
+     * depth-first order.
+     * @param max_obj_per_leaf Maximum number of objects in a leaf node.
+     * @param enqueue_task_wait Optional function used to build subtrees in
+     * parallel.
+     */
     template<typename Iterator, typename Func>
-    void build(Iterator aabb_begin, Iterator aabb_end, Func &report_leaf, uint32_t max_obj_per_leaf = 1) {
+    void build(Iterator aabb_begin, Iterator aabb_end, Func &report_leaf,
+               uint32_t max_obj_per_leaf = 1, enqueue_task_wait_t *enqueue_task_wait = nullptr) {
         EDYN_ASSERT(aabb_begin != aabb_end);
+        EDYN_ASSERT(max_obj_per_leaf > 0);
 
-        auto count = std::distance(aabb_begin, aabb_end);
+        auto count = static_cast<uint32_t>(std::distance(aabb_begin, aabb_end));
         std::vector<uint32_t> ids(count);
         std::iota(ids.begin(), ids.end(), 0);
 
+        std::vector<vector3> centers;
+        centers.reserve(count);
+
+        for (auto it = aabb_begin; it != aabb_end; ++it) {
+            centers.push_back(it->center());
+        }
+
         // Insert root node.
-        m_nodes.emplace_back();
+        std::vector<tree_node> nodes;
+        nodes.emplace_back();
+
+        // Split the top levels in this thread until there are enough
+        // independent subtrees to be built in parallel.
+        std::vector<build_range> subtrees;
+        subtrees.push_back({0, 0, count});
+
+        if (enqueue_task_wait) {
+            constexpr size_t max_subtrees = 32;
+            constexpr uint32_t min_parallel_count = 1024;
+
+            while (subtrees.size() < max_subtrees) {
+                auto largest = std::max_element(subtrees.begin(), subtrees.end(), [](auto &a, auto &b) {
+                    return a.end - a.begin < b.end - b.begin;
+                });
+                auto range = *largest;
+
+                // Stop where `recurse_build` would have made a leaf so the
+                // result does not depend on whether the build is parallel.
+                if (range.end - range.begin < min_parallel_count ||
+                    range.end - range.begin <= max_obj_per_leaf) {
+                    break;
+                }
+
+                calculate_node_aabb(aabb_begin, ids, nodes[range.node_idx], range);
+                auto middle = split_node(aabb_begin, centers, ids, nodes, range);
+                *largest = {nodes[range.node_idx].child1, range.begin, middle};
+                subtrees.push_back({nodes[range.node_idx].child2, middle, range.end});
+            }
+        }
 
-        recurse_build(aabb_begin, aabb_end, ids.begin(), ids.end(),
-                      0, report_leaf, max_obj_per_leaf);
-    }
+        std::vector<std::vector<tree_node>> subtree_nodes(subtrees.size());
+        std::vector<std::vector<build_range>> subtree_leaves(subtrees.size());
 
-    template<typename Iterator_AABB, typename Iterator_ids, typename Func>
-    void recurse_build(Iterator_AABB aabb_begin, Iterator_AABB aabb_end,
-                       Iterator_ids ids_begin, Iterator_ids ids_end,
-                       size_t node_idx, Func &report_leaf,
-                       uint32_t max_obj_per_leaf) {
-        EDYN_ASSERT(aabb_begin != aabb_end);
+        auto task_func = [&](unsigned start, unsigned end) {
+            for (auto i = start; i < end; ++i) {
+                auto range = subtrees[i];
+                range.node_idx = 0;
+                subtree_nodes[i].emplace_back();
+                recurse_build(aabb_begin, centers, ids, subtree_nodes[i], subtree_leaves[i],
+                              range, max_obj_per_leaf);
+            }
+        };
 
-        AABB set_aabb = *(aabb_begin + *ids_begin);
+        if (enqueue_task_wait && subtrees.size() > 1) {
+            auto task = task_delegate_t(entt::connect_arg_t<&decltype(task_func)::operator()>{}, task_func);
+            (*enqueue_task_wait)(task, subtrees.size());
+        } else {
+            task_func(0, subtrees.size());
+        }
 
-        for (auto it = ids_begin + 1; it != ids_end; ++it) {
-            set_aabb = enclosing_aabb(set_aabb, *(aabb_begin + *it));
+        // Insert subtrees into the tree. The root of each subtree replaces
+        // the node it was built for and the remaining nodes are appended.
+        std::vector<build_range> leaves;
+
+        for (size_t i = 0; i < subtrees.size(); ++i) {
+            auto root_idx = subtrees[i].node_idx;
+            auto offset = static_cast<uint32_t>(nodes.size()) - 1;
+            auto remap = [&](uint32_t idx) {
+                return idx == 0 ? root_idx : offset + idx;
+            };
+
+            auto &sub_nodes = subtree_nodes[i];
+
+            for (size_t j = 0; j < sub_nodes.size(); ++j) {
+                auto node = sub_nodes[j];
+
+                if (!node.leaf()) {
+                    node.child1 = remap(node.child1);
+                    node.child2 = remap(node.child2);
+                }
+
+                if (j == 0) {
+                    nodes[root_idx] = node;
+                } else {
+                    nodes.push_back(node);
+                }
+            }
+
+            for (auto leaf : subtree_leaves[i]) {
+                leaf.node_idx = remap(leaf.node_idx);
+                // Store the index of the leaf range in the node.
+                nodes[leaf.node_idx].id = static_cast<uint32_t>(leaves.size());
+                leaves.push_back(leaf);
+            }
         }
 
-        auto &node = m_nodes[node_idx];
-        node.aabb = set_aabb;
+        // Write compact nodes in depth-first order, quantizing each node's
+        // bounds relative to the decoded bounds of its parent.
+        struct compact_entry {
+            uint32_t node_idx;
+            uint32_t parent_compact_idx;
+            AABB parent_aabb;
+        };
 
-        auto count = std::distance(ids_begin, ids_end);
+        m_root_aabb = nodes.front().aabb;
+        m_nodes.clear();
+        m_nodes.reserve(nodes.size());
 
-        if (count <= max_obj_per_leaf) {
-            node.child1 = EDYN_NULL_NODE;
-            report_leaf(node, ids_begin, ids_end);
-        } else {
-            auto ids_middle = detail::aabb_set_partition(aabb_begin, aabb_end, ids_begin, ids_end, set_aabb);
+        std::vector<compact_entry> stack;
+        stack.push_back({0, EDYN_NULL_NODE, m_root_aabb});
 
-            auto child1 = m_nodes.size();
-            auto child2 = m_nodes.size() + 1;
+        while (!stack.empty()) {
+            auto entry = stack.back();
+            stack.pop_back();
 
-            node.child1 = child1;
-            node.child2 = child2;
+            auto compact_idx = static_cast<uint32_t>(m_nodes.size());
+            auto &node = nodes[entry.node_idx];
+            auto &compact = m_nodes.emplace_back(quantize(node.aabb, entry.parent_aabb));
+            auto aabb = compact.decode(entry.parent_aabb);
 
-            m_nodes.emplace_back();
-            m_nodes.emplace_back();
+            // Point parent to its second child.
+            if (entry.parent_compact_idx != EDYN_NULL_NODE &&
+                entry.parent_compact_idx + 1 != compact_idx) {
+                m_nodes[entry.parent_compact_idx].data = compact_idx;
+            }
 
-            recurse_build(aabb_begin, aabb_end, ids_begin, ids_middle,
-                          child1, report_leaf, max_obj_per_leaf);
-            recurse_build(aabb_begin, aabb_end, ids_middle, ids_end,
-                          child2, report_leaf, max_obj_per_leaf);
+            if (node.leaf()) {
+                auto &range = leaves[node.id];
+                report_leaf(node, ids.begin() + range.begin, ids.begin() + range.end);
+                EDYN_ASSERT((node.id & compact_node::leaf_bit) == 0);
+                m_nodes[compact_idx].data = node.id | compact_node::leaf_bit;
+            } else {
+                stack.push_back({node.child2, compact_idx, aabb});
+                stack.push_back({node.child1, compact_idx, aabb});
+            }
         }
     }
 
@@ -140,19 +421,167 @@ public:
     friend size_t serialization_sizeof(const static_tree &tree);
 
 private:
-    std::vector<tree_node> m_nodes;
+    template<typename TestFunc, typename VisitFunc>
+    void traverse(TestFunc test_func, VisitFunc visit_func) const;
+
+    // Quantizes an AABB relative to the parent AABB rounding outwards.
+    static compact_node quantize(const AABB &aabb, const AABB &parent_aabb) {
+        auto node = compact_node{};
+        node.data = 0;
+
+        for (size_t i = 0; i < 3; ++i) {
+            auto extent = parent_aabb.max[i] - parent_aabb.min[i];
+
+            if (!(extent > 0)) {
+                node.min[i] = 0;
+                node.max[i] = 0;
+                continue;
+            }
+
+            auto to_quantized = compact_node::quantization_max / extent;
+            auto qmin = std::floor((aabb.min[i] - parent_aabb.min[i]) * to_quantized);
+            auto qmax = std::ceil((aabb.max[i] - parent_aabb.min[i]) * to_quantized);
+            node.min[i] = static_cast<uint16_t>(std::clamp(qmin, scalar(0), compact_node::quantization_max));
+            node.max[i] = static_cast<uint16_t>(std::clamp(qmax, scalar(0), compact_node::quantization_max));
+        }
+
+        // Compensate for rounding errors in the decoded values so that the
+        // decoded AABB always contains the original.
+        auto decoded = node.decode(parent_aabb);
+
+        for (size_t i = 0; i < 3; ++i) {
+            while (node.min[i] > 0 && decoded.min[i] > aabb.min[i]) {
+                --node.min[i];
+                decoded = node.decode(parent_aabb);
+            }
+
+            while (node.max[i] < compact_node::quantization_max && decoded.max[i] < aabb.max[i]) {
+                ++node.max[i];
+                decoded = node.decode(parent_aabb);
+            }
+        }
+
+        return node;
+    }
+
+    struct build_range {
+        uint32_t node_idx;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    template<typename Iterator_AABB>
+    static void calculate_node_aabb(Iterator_AABB aabb_begin, const std::vector<uint32_t> &ids,
+                                    tree_node &node, build_range range) {
+        node.aabb = *(aabb_begin + ids[range.begin]);
+
+        for (auto i = range.begin + 1; i < range.end; ++i) {
+            node.aabb = enclosing_aabb(node.aabb, *(aabb_begin + ids[i]));
+        }
+    }
+
+    // Splits the objects of a node in two sets, creates its children and
+    // returns the index of the first id of the second set.
+    template<typename Iterator_AABB>
+    static uint32_t split_node(Iterator_AABB aabb_begin, const std::vector<vector3> &centers,
+                               std::vector<uint32_t> &ids, std::vector<tree_node> &nodes,
+                               build_range range) {
+        auto ids_begin = ids.begin() + range.begin;
+        auto ids_end = ids.begin() + range.end;
+        auto middle = detail::aabb_set_partition(aabb_begin, centers, ids_begin, ids_end);
+
+        auto child1 = static_cast<uint32_t>(nodes.size());
+        auto child2 = child1 + 1;
+        nodes[range.node_idx].child1 = child1;
+        nodes[range.node_idx].child2 = child2;
+        nodes.emplace_back();
+        nodes.emplace_back();
+
+        return static_cast<uint32_t>(std::distance(ids.begin(), middle));
+    }
+
+    template<typename Iterator_AABB>
+    static void recurse_build(Iterator_AABB aabb_begin, const std::vector<vector3> &centers,
+                              std::vector<uint32_t> &ids, std::vector<tree_node> &nodes,
+                              std::vector<build_range> &leaves, build_range range,
+                              uint32_t max_obj_per_leaf) {
+        EDYN_ASSERT(range.begin < range.end);
+        auto &node = nodes[range.node_idx];
+        calculate_node_aabb(aabb_begin, ids, node, range);
+
+        if (range.end - range.begin <= max_obj_per_leaf) {
+            node.child1 = EDYN_NULL_NODE;
+            leaves.push_back(range);
+            return;
+        }
+
+        auto middle = split_node(aabb_begin, centers, ids, nodes, range);
+        // Node reference might have been invalidated.
+        auto child1 = nodes[range.node_idx].child1;
+        auto child2 = nodes[range.node_idx].child2;
+
+        recurse_build(aabb_begin, centers, ids, nodes, leaves, {child1, range.begin, middle}, max_obj_per_leaf);
+        recurse_build(aabb_begin, centers, ids, nodes, leaves, {child2, middle, range.end}, max_obj_per_leaf);
+    }
+
+    std::vector<compact_node> m_nodes;
+    AABB m_root_aabb;
 };
 
+template<typename TestFunc, typename VisitFunc>
+void static_tree::traverse(TestFunc test_func, VisitFunc visit_func) const {
+    if (m_nodes.empty() || !test_func(m_root_aabb)) {
+        return;
+    }
+
+    struct stack_entry {
+        uint32_t node_idx;
+        AABB aabb;
+    };
+
+    std::vector<stack_entry> stack;
+    stack.push_back({0, m_root_aabb});
+
+    while (!stack.empty()) {
+        auto entry = stack.back();
+        stack.pop_back();
+
+        auto &node = m_nodes[entry.node_idx];
+
+        if (node.leaf()) {
+            visit_func(node.id());
+            continue;
+        }
+
+        // Children are decoded relative to the parent and tested before
+        // being pushed onto the stack.
+        auto child1 = entry.node_idx + 1;
+        auto child2 = node.child2();
+        auto aabb1 = m_nodes[child1].decode(entry.aabb);
+        auto aabb2 = m_nodes[child2].decode(entry.aabb);
+
+        if (test_func(aabb2)) {
+            stack.push_back({child2, aabb2});
+        }
+
+        if (test_func(aabb1)) {
+            stack.push_back({child1, aabb1});
+        }
+    }
+}
+
 template<typename Func>
 void static_tree::query(const AABB &aabb, Func func) const {
-    uint32_t root_node_idx = 0;
-    query_tree(*this, root_node_idx, EDYN_NULL_NODE, aabb, func);
+    traverse([&](const AABB &node_aabb) {
+        return intersect(node_aabb, aabb);
+    }, func);
 }
 
 template<typename Func>
 void static_tree::raycast(vector3 p0, vector3 p1, Func func) const {
-    uint32_t root_node_idx = 0;
-    raycast_tree(*this, root_node_idx, EDYN_NULL_NODE, p0, p1, func);
+    traverse([&](const AABB &node_aabb) {
+        return intersect_segment_aabb(p0, p1, node_aabb.min, node_aabb.max);
+    }, func);
 }
 
 }
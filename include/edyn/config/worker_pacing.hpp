@@ -0,0 +1,29 @@
+#ifndef EDYN_CONFIG_WORKER_PACING_HPP
+#define EDYN_CONFIG_WORKER_PACING_HPP
+
+namespace edyn {
+
+/**
+ * @brief How the simulation worker waits between updates in asynchronous
+ * execution mode.
+ */
+enum class worker_pacing {
+    /**
+     * Sleep with millisecond granularity after each update, with the sleep
+     * duration adjusted by a PID controller to approach the fixed delta time
+     * on average.
+     */
+    pid,
+
+    /**
+     * Wait until an absolute deadline which advances by the fixed delta time
+     * after each update. Sleeps until shortly before the deadline and spins
+     * for the remaining time. Incoming messages wake the worker up early so
+     * they're processed without waiting for the next step.
+     */
+    deadline
+};
+
+}
+
+#endif // EDYN_CONFIG_WORKER_PACING_HPP
@@ -4,6 +4,7 @@
 #include <memory>
 #include <variant>
 #include "edyn/config/execution_mode.hpp"
+#include "edyn/config/worker_pacing.hpp"
 #include "edyn/context/task.hpp"
 #include "edyn/context/step_callback.hpp"
 #include "edyn/context/start_thread.hpp"
@@ -16,12 +17,22 @@
 
 namespace edyn {
 
+struct presentation_output;
+
 struct settings {
     scalar fixed_dt {scalar(1.0 / 60)};
     bool paused {false};
     vector3 gravity {gravity_earth};
 
     unsigned max_steps_per_update {10};
+    bool coalesce_substep_updates {false};
+    // Produce the same results regardless of execution mode and number of
+    // worker threads by processing pairs, manifolds and constraints in a
+    // fixed order.
+    bool deterministic {false};
+    // Keep awake entities together in the pools iterated every step, so
+    // they're iterated first and their components are adjacent in memory.
+    bool compact_sleeping_pools {false};
     unsigned num_solver_velocity_iterations {8};
     unsigned num_solver_position_iterations {3};
     unsigned num_restitution_iterations {8};
@@ -29,6 +40,14 @@ struct settings {
 
     edyn::execution_mode execution_mode;
 
+    edyn::worker_pacing worker_pacing {edyn::worker_pacing::pid};
+    // In `worker_pacing::deadline` mode, the worker spins instead of sleeping
+    // for this amount of time in seconds before the deadline.
+    double worker_spin_time {0.0005};
+
+    // Destination of presentation transforms in `update_presentation`.
+    edyn::presentation_output *presentation_output {nullptr};
+
     start_thread_func_t *start_thread_func {&start_thread_func_default};
     enqueue_task_t *enqueue_task {&enqueue_task_default};
     enqueue_task_wait_t *enqueue_task_wait {&enqueue_task_wait_default};
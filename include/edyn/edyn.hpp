@@ -3,7 +3,9 @@
 
 #include "edyn/build_settings.h"
 #include "edyn/config/execution_mode.hpp"
+#include "edyn/config/worker_pacing.hpp"
 #include "edyn/config/solver_iteration_config.hpp"
+#include "edyn/simulation/worker_pacing_stats.hpp"
 #include "math/constants.hpp"
 #include "math/scalar.hpp"
 #include "math/vector3.hpp"
@@ -27,6 +29,8 @@
 #include "comp/shared_comp.hpp"
 #include "comp/present_position.hpp"
 #include "comp/present_orientation.hpp"
+#include "sys/update_presentation.hpp"
+#include "sys/presentation_exporter.hpp"
 #include "constraints/constraint.hpp"
 #include "serialization/s11n.hpp"
 #include "replication/register_external.hpp"
@@ -50,8 +54,8 @@ struct init_config {
     // to use alternative threads.
     // When running in async mode, Edyn needs to start a simulation thread.
     // When running as a network client (i.e. `init_network_client` is called),
-    // Edyn needs to start an extrapolation thread to run latency compensation
-    // in parallel without freezing the simulation.
+    // Edyn needs to start one or more extrapolation threads to run latency
+    // compensation in parallel without freezing the simulation.
     start_thread_func_t *start_thread_func {&start_thread_func_default};
     // Function to run a task on worker threads. Must return immediately after
     // scheduling tasks.
@@ -98,6 +102,81 @@ void set_fixed_dt(entt::registry &registry, scalar dt);
  */
 void set_max_steps_per_update(entt::registry &registry, unsigned);
 
+/**
+ * @brief When multiple steps are performed in the same update, send the
+ * changes to the main thread once at the end instead of after every step.
+ * Only the latest value of each component is sent. Contact events are still
+ * delivered for every step. Only applies in asynchronous execution mode.
+ * @param registry Data source.
+ * @param coalesce Whether to coalesce updates of multiple steps.
+ */
+void set_coalesce_substep_updates(entt::registry &registry, bool coalesce);
+
+/**
+ * @brief Make simulation results independent of the execution mode and number
+ * of worker threads. Broadphase pairs, contact points and constraints are then
+ * processed in a fixed order, at a small cost in performance. Results are
+ * bit-exact only on the same build and platform.
+ * @param registry Data source.
+ * @param deterministic Whether to enable deterministic mode.
+ */
+void set_deterministic(entt::registry &registry, bool deterministic);
+
+/**
+ * @brief Keep awake entities together in the component pools that are visited
+ * every step, where they're iterated first. Pools are partitioned once when
+ * enabled and after that only entities that fall asleep, wake up, are disabled
+ * or enabled, or gain or lose components are moved. Systems still iterate
+ * views which test every entity against the sleeping and disabled tags, but
+ * the components they read are then adjacent in memory. May help when many
+ * bodies are asleep.
+ * @param registry Data source.
+ * @param compact Whether to compact pools.
+ */
+void set_compact_sleeping_pools(entt::registry &registry, bool compact);
+
+/**
+ * @brief Set how the simulation worker paces its updates in asynchronous
+ * execution mode.
+ * @param registry Data source.
+ * @param pacing Pacing mode.
+ */
+void set_worker_pacing(entt::registry &registry, worker_pacing pacing);
+
+/**
+ * @brief Get statistics about how precisely the simulation worker keeps to
+ * the fixed update rate in asynchronous execution mode.
+ * @param registry Data source.
+ * @return Pacing statistics, or default values if not running asynchronously.
+ */
+worker_pacing_stats get_worker_pacing_stats(const entt::registry &registry);
+
+/**
+ * @brief Set a buffer where the presentation transforms of all awake dynamic
+ * rigid bodies are written to in every call to `edyn::update`.
+ * @param registry Data source.
+ * @param output Pointer to caller-owned output, which must remain valid until
+ * replaced. Pass null to stop writing.
+ */
+void set_presentation_output(entt::registry &registry, presentation_output *output);
+
+/**
+ * @brief Enables or disables keeping the presentation transforms of all rigid
+ * bodies in a dense array with stable indices, which can be copied directly
+ * into instance buffers for rendering.
+ * @param registry Data source.
+ * @param enabled Whether to export presentation transforms.
+ */
+void set_presentation_export_enabled(entt::registry &registry, bool enabled);
+
+/**
+ * @brief Get the array of presentation transforms. Export must be enabled via
+ * `set_presentation_export_enabled`.
+ * @param registry Data source.
+ * @return The presentation exporter.
+ */
+presentation_exporter & get_presentation_exporter(entt::registry &registry);
+
 /**
  * @brief Checks if simulation is paused.
  * @param registry Data source.
@@ -4,6 +4,7 @@
 #include "edyn/math/vector3.hpp"
 #include "edyn/comp/aabb.hpp"
 #include <array>
+#include <cmath>
 #include <cstdint>
 
 namespace edyn {
@@ -22,6 +23,108 @@ using triangle_vertices = std::array<vector3, 3>;
 using triangle_edges = std::array<vector3, 3>;
 class triangle_mesh;
 
+/**
+ * Everything collision detection needs to know about a triangle of a
+ * `triangle_mesh`, stored contiguously so a triangle can be processed without
+ * gathering its vertices, normals and edge information from separate arrays.
+ */
+struct alignas(64) packed_triangle {
+    triangle_vertices vertices;
+    vector3 normal;
+
+    // Normal of the face that shares the i-th edge with this triangle.
+    std::array<vector3, 3> adjacent_normals;
+
+    // Vertex and edge indices in the mesh.
+    std::array<uint32_t, 3> vertex_indices;
+    std::array<uint32_t, 3> edge_indices;
+
+    // The i-th bit is set if the i-th edge is convex.
+    uint8_t convex_edges;
+
+    bool is_convex_edge(size_t edge_idx) const {
+        return (convex_edges >> edge_idx) & 1;
+    }
+};
+
+/**
+ * Gathers packed triangles in small batches and forwards those whose plane is
+ * not further than `threshold` from an AABB to `func`, as
+ * `func(uint32_t tri_idx, const packed_triangle &)`. The plane distances of a
+ * batch are computed together in a structure-of-arrays layout the compiler
+ * can vectorize. Triangles are forwarded in the order they were pushed, and
+ * they must remain valid until the batch they belong to is flushed.
+ */
+template<typename Func>
+class packed_triangle_batch {
+public:
+    static constexpr size_t max_size = 8;
+
+    packed_triangle_batch(const AABB &aabb, scalar threshold, Func &func)
+        : m_center((aabb.min + aabb.max) * scalar(0.5))
+        , m_half_extents((aabb.max - aabb.min) * scalar(0.5))
+        , m_threshold(threshold)
+        , m_func(&func)
+    {}
+
+    // Scratch record owned by the batch which can be filled in and then
+    // pushed, for triangles that are not stored anywhere else.
+    packed_triangle & next_storage() {
+        return m_storage[m_count];
+    }
+
+    void push(uint32_t tri_idx, const packed_triangle &tri) {
+        m_triangles[m_count] = &tri;
+        m_indices[m_count] = tri_idx;
+
+        if (++m_count == max_size) {
+            flush();
+        }
+    }
+
+    void flush() {
+        scalar nx[max_size] = {}, ny[max_size] = {}, nz[max_size] = {};
+        scalar d[max_size] = {};
+
+        for (size_t i = 0; i < m_count; ++i) {
+            auto &tri = *m_triangles[i];
+            nx[i] = tri.normal.x;
+            ny[i] = tri.normal.y;
+            nz[i] = tri.normal.z;
+            d[i] = dot(tri.normal, tri.vertices[0]);
+        }
+
+        // Distance between the closest point of the box and each plane.
+        bool separated[max_size];
+
+        for (size_t i = 0; i < max_size; ++i) {
+            auto dist = nx[i] * m_center.x + ny[i] * m_center.y + nz[i] * m_center.z - d[i] -
+                        (std::abs(nx[i]) * m_half_extents.x +
+                         std::abs(ny[i]) * m_half_extents.y +
+                         std::abs(nz[i]) * m_half_extents.z);
+            separated[i] = dist > m_threshold;
+        }
+
+        for (size_t i = 0; i < m_count; ++i) {
+            if (!separated[i]) {
+                (*m_func)(m_indices[i], *m_triangles[i]);
+            }
+        }
+
+        m_count = 0;
+    }
+
+private:
+    vector3 m_center;
+    vector3 m_half_extents;
+    scalar m_threshold;
+    Func *m_func;
+    size_t m_count {0};
+    std::array<packed_triangle, max_size> m_storage;
+    std::array<const packed_triangle *, max_size> m_triangles;
+    std::array<uint32_t, max_size> m_indices;
+};
+
 /**
  * Checks whether point `p` is contained within the infinite prism with
  * triangular base defined by the given `vertices` and direction `normal`.
@@ -55,10 +158,8 @@ AABB get_triangle_aabb(const triangle_vertices &vertices);
 // This is used in triangle mesh collision detection to project a separating
 // axis into the voronoi region of the support feature of a triangle, thus
 // preventing contacts from pointing towards an invalid direction.
-vector3 clip_triangle_separating_axis(vector3 sep_axis, const triangle_mesh &mesh,
-                                      size_t tri_idx, const std::array<vector3, 3> &tri_vertices,
-                                      const vector3 &tri_normal, triangle_feature tri_feature,
-                                      size_t tri_feature_index);
+vector3 clip_triangle_separating_axis(vector3 sep_axis, const packed_triangle &tri,
+                                      triangle_feature tri_feature, size_t tri_feature_index);
 
 }
 
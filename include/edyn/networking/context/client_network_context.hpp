@@ -8,7 +8,7 @@
 #include "edyn/networking/util/client_snapshot_importer.hpp"
 #include "edyn/networking/util/client_snapshot_exporter.hpp"
 #include "edyn/networking/util/clock_sync.hpp"
-#include "edyn/networking/extrapolation/extrapolation_worker.hpp"
+#include "edyn/networking/extrapolation/extrapolation_worker_pool.hpp"
 #include "edyn/networking/extrapolation/extrapolation_modified_comp.hpp"
 #include "edyn/replication/registry_operation.hpp"
 #include <entt/entity/fwd.hpp>
@@ -17,6 +17,7 @@
 #include <entt/signal/sigh.hpp>
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
 
 namespace edyn {
 
@@ -49,9 +50,14 @@ struct client_network_context {
 
     std::shared_ptr<input_state_history_writer> input_history;
 
-    std::unique_ptr<extrapolation_worker> extrapolator;
+    std::unique_ptr<extrapolation_worker_pool> extrapolator;
     std::vector<extrapolation_request> pending_extrapolations;
 
+    // Start time of the latest extrapolation result applied to each entity.
+    // Results from multiple workers can arrive out of order and older ones
+    // are discarded.
+    std::unordered_map<entt::entity, double> extrapolation_start_times;
+
     message_queue_handle<extrapolation_result> message_queue {
         message_dispatcher::global().make_queue<extrapolation_result>("client_side")};
 
@@ -15,6 +15,16 @@ struct extrapolation_request {
     bool should_remap {true};
 };
 
+/**
+ * @brief Snapshot of a request assigned to another extrapolation worker. It
+ * only updates the last known remote state of its entities, which keeps the
+ * state mirrored by all workers up to date.
+ */
+struct extrapolation_remote_state {
+    double start_time;
+    packet::registry_snapshot snapshot;
+};
+
 }
 
 #endif // EDYN_NETWORKING_EXTRAPOLATION_REQUEST_HPP
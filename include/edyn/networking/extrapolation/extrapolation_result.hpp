@@ -14,6 +14,8 @@ struct extrapolation_result {
     std::vector<contact_manifold> manifolds;
     bool terminated_early {false};
     double timestamp;
+    // Start time of the request, i.e. time of the snapshot it started from.
+    double start_time;
 
     void remap(entity_map &emap) {
         ops.remap(emap);
@@ -5,11 +5,13 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <string>
 #include <entt/entity/fwd.hpp>
 #include "edyn/networking/extrapolation/extrapolation_modified_comp.hpp"
 #include "edyn/networking/extrapolation/extrapolation_operation.hpp"
 #include "edyn/networking/extrapolation/extrapolation_request.hpp"
 #include "edyn/networking/extrapolation/extrapolation_result.hpp"
+#include "edyn/core/entity_graph.hpp"
 #include "edyn/dynamics/solver.hpp"
 #include "edyn/replication/entity_map.hpp"
 #include "edyn/simulation/island_manager.hpp"
@@ -26,6 +28,11 @@ struct settings;
 
 class extrapolation_worker final {
 
+    struct pending_request {
+        extrapolation_request request;
+        bool superseded;
+    };
+
     void init();
     void deinit();
     bool begin_extrapolation(const extrapolation_request &);
@@ -34,11 +41,14 @@ class extrapolation_worker final {
     void finish_step();
     void apply_history();
     void finish_extrapolation(const extrapolation_request &);
+    void apply_superseded(const extrapolation_request &);
     void run();
     void extrapolate(const extrapolation_request &);
+    void enqueue(pending_request &&);
 
 public:
-    extrapolation_worker(const settings &settings,
+    extrapolation_worker(const std::string &queue_name,
+                         const settings &settings,
                          const registry_operation_context &reg_op_ctx,
                          const material_mix_table &material_table,
                          make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp);
@@ -54,7 +64,33 @@ public:
     void set_context_settings(std::shared_ptr<input_state_history_reader> input_history,
                               make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp);
 
+    /**
+     * @brief Sends an extrapolation request to this worker.
+     * @param source Identifier of the message queue of the sender.
+     * @param request The extrapolation request.
+     */
+    void request_extrapolation(const message_queue_identifier &source, extrapolation_request &&request);
+
+    /**
+     * @brief Sends the snapshot of a request that was assigned to another
+     * worker, to be stored as the last known remote state of its entities.
+     * @param source Identifier of the message queue of the sender.
+     * @param state The snapshot and its time.
+     */
+    void update_remote_state(const message_queue_identifier &source, extrapolation_remote_state &&state);
+
+    // Number of requests and remote state updates that were sent to this
+    // worker and have not yet been processed.
+    unsigned num_pending_requests() const {
+        return m_num_pending_requests.load(std::memory_order_relaxed);
+    }
+
+    const message_queue_identifier & queue_identifier() const {
+        return m_message_queue.identifier;
+    }
+
     void on_extrapolation_request(message<extrapolation_request> &msg);
+    void on_extrapolation_remote_state(message<extrapolation_remote_state> &msg);
     void on_extrapolation_operation_create(message<extrapolation_operation_create> &msg);
     void on_extrapolation_operation_destroy(message<extrapolation_operation_destroy> &msg);
     void on_set_settings(message<msg::set_settings> &msg);
@@ -74,6 +110,7 @@ private:
 
     message_queue_handle<
         extrapolation_request,
+        extrapolation_remote_state,
         extrapolation_operation_create,
         extrapolation_operation_destroy,
         msg::set_settings,
@@ -83,11 +120,17 @@ private:
 
     std::atomic<bool> m_running {false};
     std::atomic<bool> m_has_messages {false};
+    std::atomic<unsigned> m_num_pending_requests {0};
 
-    std::vector<extrapolation_request> m_requests;
+    std::vector<pending_request> m_requests;
     unsigned m_max_requests {3};
     entt::sparse_set m_owned_entities;
 
+    // Scratch containers reused in every extrapolation.
+    std::vector<entity_graph::index_type> m_node_indices;
+    entt::sparse_set m_snapshot_entities;
+    entt::sparse_set m_entities;
+
     double m_init_time;
     double m_current_time;
     unsigned m_step_count {0};
@@ -0,0 +1,84 @@
+#ifndef EDYN_NETWORKING_EXTRAPOLATION_WORKER_POOL_HPP
+#define EDYN_NETWORKING_EXTRAPOLATION_WORKER_POOL_HPP
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <entt/entity/fwd.hpp>
+#include "edyn/networking/extrapolation/extrapolation_worker.hpp"
+
+namespace edyn {
+
+/**
+ * @brief A set of extrapolation workers, each running in a dedicated thread
+ * with its own registry which mirrors all networked entities. Requests
+ * involving independent sets of entities are extrapolated concurrently while
+ * requests which share entities with a previous request are assigned to the
+ * same worker, which keeps results ordered and allows stale requests to be
+ * superseded by newer ones. The snapshot of each request is also sent to the
+ * other workers so their last known remote state stays up to date.
+ */
+class extrapolation_worker_pool final {
+public:
+    extrapolation_worker_pool(unsigned num_workers,
+                              const settings &settings,
+                              const registry_operation_context &reg_op_ctx,
+                              const material_mix_table &material_table,
+                              make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp);
+
+    void start();
+    void stop();
+
+    void set_settings(const edyn::settings &settings);
+    void set_material_table(const material_mix_table &material_table);
+    void set_registry_operation_context(const registry_operation_context &reg_op_ctx);
+    void set_context_settings(std::shared_ptr<input_state_history_reader> input_history,
+                              make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp);
+
+    /**
+     * @brief Number of workers in this pool.
+     */
+    size_t size() const {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief Message queue identifier of a worker, which is where entity
+     * creation and destruction operations must be sent to. All workers must
+     * receive these operations to stay synchronized.
+     * @param index Worker index.
+     * @return Message queue identifier.
+     */
+    const message_queue_identifier & queue_identifier(size_t index) const {
+        return m_workers[index]->queue_identifier();
+    }
+
+    /**
+     * @brief Send destruction operations to all workers.
+     * @param source Identifier of the message queue of the sender.
+     * @param entities Entities to be destroyed in the main registry space.
+     */
+    void remove_entities(const message_queue_identifier &source,
+                         const std::vector<entt::entity> &entities);
+
+    /**
+     * @brief Assign an extrapolation request to a worker.
+     * @param source Identifier of the message queue of the sender.
+     * @param request The extrapolation request.
+     */
+    void request_extrapolation(const message_queue_identifier &source, extrapolation_request &&request);
+
+private:
+    size_t select_worker(const extrapolation_request &request);
+
+    std::vector<std::unique_ptr<extrapolation_worker>> m_workers;
+
+    // Maps entities to the index of the worker which received the latest
+    // request involving them.
+    std::unordered_map<entt::entity, size_t> m_entity_worker;
+    std::vector<unsigned> m_worker_counts;
+};
+
+}
+
+#endif // EDYN_NETWORKING_EXTRAPOLATION_WORKER_POOL_HPP
@@ -4,10 +4,12 @@
 #include <entt/entity/fwd.hpp>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <type_traits>
 #include <entt/core/type_info.hpp>
 #include <entt/entity/registry.hpp>
+#include "edyn/config/config.h"
 #include "edyn/comp/action_list.hpp"
 #include "edyn/networking/comp/action_history.hpp"
 #include "edyn/networking/packet/registry_snapshot.hpp"
@@ -15,26 +17,150 @@
 namespace edyn {
 
 namespace internal {
+    /**
+     * @brief History of states of one input component of one entity, stored
+     * in a ring buffer in SoA form with timestamps in increasing order, which
+     * allows time ranges to be located with a binary search. Capacity is a
+     * power of two and grows when full, thus after a warm-up period no more
+     * allocations happen.
+     */
     template<typename Component>
-    struct component_history {
-        struct entry {
-            Component component;
-            double timestamp;
-        };
+    class component_history {
+        static constexpr size_t initial_capacity = 16;
 
-        std::vector<entry> entries;
+        size_t physical_index(size_t index) const {
+            return (m_head + index) & (m_timestamps.size() - 1);
+        }
+
+        void grow() {
+            auto capacity = m_timestamps.empty() ? initial_capacity : m_timestamps.size() * 2;
+            auto timestamps = std::vector<double>(capacity);
+            auto components = std::vector<Component>(capacity);
+
+            for (size_t i = 0; i < m_count; ++i) {
+                auto idx = physical_index(i);
+                timestamps[i] = m_timestamps[idx];
+                components[i] = std::move(m_components[idx]);
+            }
+
+            m_timestamps = std::move(timestamps);
+            m_components = std::move(components);
+            m_head = 0;
+        }
+
+    public:
+        size_t size() const {
+            return m_count;
+        }
+
+        bool empty() const {
+            return m_count == 0;
+        }
+
+        double timestamp(size_t index) const {
+            EDYN_ASSERT(index < m_count);
+            return m_timestamps[physical_index(index)];
+        }
+
+        const Component & component(size_t index) const {
+            EDYN_ASSERT(index < m_count);
+            return m_components[physical_index(index)];
+        }
+
+        // Index of first entry with a timestamp greater than or equal to the
+        // given timestamp.
+        size_t lower_bound(double time) const {
+            size_t first = 0, count = m_count;
+
+            while (count > 0) {
+                auto step = count / 2;
+                auto idx = first + step;
+
+                if (timestamp(idx) < time) {
+                    first = idx + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+
+            return first;
+        }
+
+        // Index of first entry with a timestamp greater than the given timestamp.
+        size_t upper_bound(double time) const {
+            size_t first = 0, count = m_count;
+
+            while (count > 0) {
+                auto step = count / 2;
+                auto idx = first + step;
+
+                if (!(time < timestamp(idx))) {
+                    first = idx + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+
+            return first;
+        }
+
+        void push(const Component &comp, double time) {
+            if (m_count == m_timestamps.size()) {
+                grow();
+            }
+
+            // Entries usually arrive in order. Otherwise, shift newer entries
+            // forward to keep timestamps sorted.
+            auto index = m_count;
+
+            if (m_count > 0 && time < timestamp(m_count - 1)) {
+                index = upper_bound(time);
+
+                for (auto i = m_count; i > index; --i) {
+                    auto dst = physical_index(i), src = physical_index(i - 1);
+                    m_timestamps[dst] = m_timestamps[src];
+                    m_components[dst] = std::move(m_components[src]);
+                }
+            }
+
+            auto idx = physical_index(index);
+            m_timestamps[idx] = time;
+            m_components[idx] = comp;
+            ++m_count;
+        }
+
+        // Erase all entries with a timestamp less than or equal to the given
+        // timestamp.
+        void erase_until(double time) {
+            auto count = upper_bound(time);
+
+            if (count > 0) {
+                m_head = physical_index(count);
+                m_count -= count;
+            }
+        }
+
+    private:
+        std::vector<double> m_timestamps;
+        std::vector<Component> m_components;
+        size_t m_head {0};
+        size_t m_count {0};
     };
 }
 
 /**
  * @brief A history of user inputs and actions which will be applied during
  * extrapolation. It is accessed from multiple threads so it has to be thread-safe.
+ * The history is written by the main thread and read concurrently by the
+ * extrapolation workers, thus readers take a shared lock.
  */
 template<typename... Inputs>
 struct input_state_history {
     entt::storage<action_history> actions;
     std::tuple<entt::storage<internal::component_history<Inputs>>...> inputs;
-    std::mutex mutex;
+    std::shared_mutex mutex;
 
     input_state_history() = default;
     input_state_history(input_state_history &) = default;
@@ -98,7 +224,7 @@ class input_state_history_writer_impl : public input_state_history_writer {
                 }
 
                 auto [comp] = view.get(entity);
-                inputs.get(entity).entries.push_back({comp, timestamp});
+                inputs.get(entity).push(comp, timestamp);
             }
         }
     }
@@ -119,7 +245,7 @@ class input_state_history_writer_impl : public input_state_history_writer {
                     inputs.emplace(entity);
                 }
 
-                inputs.get(entity).entries.push_back({comp, timestamp});
+                inputs.get(entity).push(comp, timestamp);
             }
         }
     }
@@ -164,19 +290,12 @@ class input_state_history_writer_impl : public input_state_history_writer {
         }
     }
 
-    template<typename Array>
-    auto first_after(const Array &arr, double timestamp) const {
-        return std::find_if(arr.begin(), arr.end(),
-                            [timestamp](auto &&elem) { return elem.timestamp > timestamp; });
-    }
-
     template<typename Component>
     void erase_until(double timestamp) {
         auto &inputs = m_history->template get_inputs<Component>();
 
         for (auto [entity, history] : inputs.each()) {
-            auto it = first_after(history.entries, timestamp);
-            history.entries.erase(history.entries.begin(), it);
+            history.erase_until(timestamp);
         }
     }
 
@@ -262,14 +381,10 @@ class input_state_history_reader_impl : public input_state_history_reader {
         auto end_time = start_time + length_of_time;
 
         for (auto [entity, history] : inputs.each()) {
-            for (auto &entry : history.entries) {
-                if (entry.timestamp > end_time) {
-                    break;
-                }
+            auto last = history.upper_bound(end_time);
 
-                if (entry.timestamp >= start_time) {
-                    import_component(registry, entity, entry.component, emap);
-                }
+            for (auto i = history.lower_bound(start_time); i < last; ++i) {
+                import_component(registry, entity, history.component(i), emap);
             }
         }
     }
@@ -303,22 +418,16 @@ class input_state_history_reader_impl : public input_state_history_reader {
         }
     }
 
-    template<typename Array>
-    auto first_before(const Array &arr, double timestamp) const {
-        return std::find_if(arr.rbegin(), arr.rend(),
-                            [timestamp](auto &&elem) { return elem.timestamp <= timestamp; });
-    }
-
     template<typename Component>
     void import_latest_inputs(double time, entt::registry &registry, const entity_map &emap) const {
         auto &inputs = m_history->template get_inputs<Component>();
 
         for (auto [entity, history] : inputs.each()) {
-            // Import the first component state that's before the given time.
-            auto it = first_before(history.entries, time);
+            // Import the last component state that's before the given time.
+            auto index = history.upper_bound(time);
 
-            if (it != history.entries.rend()) {
-                import_component(registry, entity, it->component, emap);
+            if (index > 0) {
+                import_component(registry, entity, history.component(index - 1), emap);
             }
         }
     }
@@ -373,13 +482,13 @@ public:
 
     void import_each(double start_time, double length_of_time,
                      entt::registry &registry, const entity_map &emap) const override {
-        std::lock_guard lock(m_history->mutex);
+        std::shared_lock lock(m_history->mutex);
         (import_each_input<Inputs>(start_time, length_of_time, registry, emap), ...);
         import_each_action(start_time, length_of_time, registry, emap);
     }
 
     void import_latest(double time, entt::registry &registry, const entity_map &emap) const override {
-        std::lock_guard lock(m_history->mutex);
+        std::shared_lock lock(m_history->mutex);
         (import_latest_inputs<Inputs>(time, registry, emap), ...);
     }
 
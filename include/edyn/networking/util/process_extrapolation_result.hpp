@@ -2,12 +2,15 @@
 #define EDYN_NETWORKING_UTIL_PROCESS_EXTRAPOLATION_RESULT_HPP
 
 #include <entt/entity/fwd.hpp>
+#include <entt/entity/sparse_set.hpp>
 
 namespace edyn {
 
 class entity_map;
 struct extrapolation_result;
 
+entt::sparse_set get_entities_from_extrapolation_result(const extrapolation_result &result);
+
 void process_extrapolation_result(entt::registry &registry, entity_map &emap,
                                   const extrapolation_result &result);
 
@@ -15,6 +15,7 @@
 #include "edyn/parallel/message_dispatcher.hpp"
 #include "edyn/core/entity_pair.hpp"
 #include "edyn/replication/registry_operation.hpp"
+#include "edyn/replication/transform_sync.hpp"
 #include "edyn/util/rigidbody.hpp"
 
 namespace edyn::msg {
@@ -44,10 +45,13 @@ struct set_com {
 
 /**
  * Message sent by worker to the main thread after every step of the simulation
- * containing everything that changed since the previous update.
+ * containing everything that changed since the previous update. Transforms and
+ * velocities of active rigid bodies are sent separately in bulk instead of as
+ * individual operations.
  */
 struct step_update {
     registry_operation ops;
+    transform_sync_buffer transforms;
     double timestamp;
 };
 
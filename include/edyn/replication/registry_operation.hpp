@@ -2,8 +2,11 @@
 #define EDYN_REPLICATION_REGISTRY_OPERATION_HPP
 
 #include <entt/core/type_info.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 #include <entt/entity/registry.hpp>
 #include "edyn/config/config.h"
@@ -30,15 +33,42 @@ enum class registry_operation_type {
 struct operation_base {
     entt::entity entity;
 
+    operation_base(registry_operation_type type, entt::id_type payload_type_id)
+        : m_operation_type(type)
+        , m_payload_type_id(payload_type_id)
+    {}
+
     virtual ~operation_base() = default;
 
     virtual void execute(entt::registry &registry, entity_map &entity_map) const = 0;
     virtual void execute(entt::registry &registry) const = 0;
 
+    /**
+     * @brief Executes a sequence of consecutive operations which have the
+     * same type and payload as this one. Pools are obtained once for the
+     * whole sequence and each operation is executed without virtual dispatch.
+     * @param registry Destination registry.
+     * @param entity_map Maps remote into local entities.
+     * @param ops Pointer to the first operation in the sequence.
+     * @param count Number of operations in the sequence.
+     */
+    virtual void execute_run(entt::registry &registry, entity_map &entity_map,
+                             operation_base *const *ops, size_t count) const = 0;
+
     virtual void remap(const entity_map &emap) = 0;
 
-    virtual entt::id_type payload_type_id() const = 0;
-    virtual registry_operation_type operation_type() const = 0;
+    entt::id_type payload_type_id() const {
+        return m_payload_type_id;
+    }
+
+    registry_operation_type operation_type() const {
+        return m_operation_type;
+    }
+
+    bool same_kind_as(const operation_base &other) const {
+        return m_operation_type == other.m_operation_type &&
+               m_payload_type_id == other.m_payload_type_id;
+    }
 
     template<typename... Ts>
     bool payload_type_any_of() const {
@@ -50,9 +80,27 @@ struct operation_base {
     bool payload_type_any_of([[maybe_unused]] const std::tuple<Ts...> &) const {
         return payload_type_any_of<Ts...>();
     }
+
+private:
+    registry_operation_type m_operation_type;
+    entt::id_type m_payload_type_id;
 };
 
+namespace internal {
+    // Executes each operation in the run with a qualified call, which is not
+    // dispatched virtually.
+    template<typename Operation>
+    void execute_operation_run(entt::registry &registry, entity_map &entity_map,
+                               operation_base *const *ops, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            static_cast<const Operation *>(ops[i])->Operation::execute(registry, entity_map);
+        }
+    }
+}
+
 struct operation_create : public operation_base {
+    operation_create() : operation_base(registry_operation_type::create, entt::type_index<void>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
          if (!entity_map.contains(entity)) {
             auto local_entity = registry.create();
@@ -62,20 +110,19 @@ struct operation_create : public operation_base {
 
     void execute(entt::registry &registry) const override {}
 
-    void remap(const entity_map &emap) override {
-        entity = emap.at(entity);
-    }
-
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<void>::value();
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        internal::execute_operation_run<operation_create>(registry, entity_map, ops, count);
     }
 
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::create;
+    void remap(const entity_map &emap) override {
+        entity = emap.at(entity);
     }
 };
 
 struct operation_destroy : public operation_base {
+    operation_destroy() : operation_base(registry_operation_type::destroy, entt::type_index<void>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
         if (!entity_map.contains(entity)) return;
 
@@ -93,22 +140,21 @@ struct operation_destroy : public operation_base {
         }
     }
 
-    void remap(const entity_map &emap) override {
-        entity = emap.at(entity);
-    }
-
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<void>::value();
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        internal::execute_operation_run<operation_destroy>(registry, entity_map, ops, count);
     }
 
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::destroy;
+    void remap(const entity_map &emap) override {
+        entity = emap.at(entity);
     }
 };
 
 struct operation_map_entity : public operation_base {
     entt::entity local_entity;
 
+    operation_map_entity() : operation_base(registry_operation_type::map_entity, entt::type_index<entt::entity>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
         if (registry.valid(local_entity)) {
             if (entity_map.contains(entity)) {
@@ -121,18 +167,15 @@ struct operation_map_entity : public operation_base {
 
     void execute(entt::registry &registry) const override {}
 
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        internal::execute_operation_run<operation_map_entity>(registry, entity_map, ops, count);
+    }
+
     void remap(const entity_map &emap) override {
         entity = emap.at(entity);
         local_entity = emap.at_local(local_entity);
     }
-
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<entt::entity>::value();
-    }
-
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::map_entity;
-    }
 };
 
 template<typename Component>
@@ -140,6 +183,8 @@ struct operation_emplace : public operation_base {
     Component component;
     static constexpr auto is_empty_type = std::is_empty_v<Component>;
 
+    operation_emplace() : operation_base(registry_operation_type::emplace, entt::type_index<Component>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
         if (!entity_map.contains(entity)) {
             return;
@@ -172,17 +217,37 @@ struct operation_emplace : public operation_base {
         }
     }
 
-    void remap(const entity_map &emap) override {
-        entity = emap.at(entity);
-        internal::map_child_entity_no_validation(emap, component);
-    }
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        auto &storage = registry.storage<Component>();
+        storage.reserve(storage.size() + count);
+
+        for (size_t i = 0; i < count; ++i) {
+            auto *op = static_cast<const operation_emplace<Component> *>(ops[i]);
 
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<Component>::value();
+            if (!entity_map.contains(op->entity)) {
+                continue;
+            }
+
+            auto local_entity = entity_map.at(op->entity);
+
+            if (!registry.valid(local_entity) || storage.contains(local_entity)) {
+                continue;
+            }
+
+            if constexpr(is_empty_type) {
+                storage.emplace(local_entity);
+            } else {
+                auto comp = op->component;
+                internal::map_child_entity(registry, entity_map, comp);
+                storage.emplace(local_entity, comp);
+            }
+        }
     }
 
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::emplace;
+    void remap(const entity_map &emap) override {
+        entity = emap.at(entity);
+        internal::map_child_entity_no_validation(emap, component);
     }
 };
 
@@ -191,6 +256,8 @@ struct operation_replace : public operation_base {
     Component component;
     static constexpr auto is_empty_type = std::is_empty_v<Component>;
 
+    operation_replace() : operation_base(registry_operation_type::replace, entt::type_index<Component>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
         if constexpr(!std::is_empty_v<Component>) {
             if (!entity_map.contains(entity)) {
@@ -223,22 +290,43 @@ struct operation_replace : public operation_base {
         }
     }
 
-    void remap(const entity_map &emap) override {
-        entity = emap.at(entity);
-        internal::map_child_entity_no_validation(emap, component);
-    }
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        if constexpr(!std::is_empty_v<Component>) {
+            auto &storage = registry.storage<Component>();
+
+            for (size_t i = 0; i < count; ++i) {
+                auto *op = static_cast<const operation_replace<Component> *>(ops[i]);
+
+                if (!entity_map.contains(op->entity)) {
+                    continue;
+                }
 
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<Component>::value();
+                auto local_entity = entity_map.at(op->entity);
+
+                if (!storage.contains(local_entity)) {
+                    continue;
+                }
+
+                auto comp = op->component;
+                internal::map_child_entity(registry, entity_map, comp);
+                storage.patch(local_entity, [&comp](auto &&current) {
+                    merge_component(current, comp);
+                });
+            }
+        }
     }
 
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::replace;
+    void remap(const entity_map &emap) override {
+        entity = emap.at(entity);
+        internal::map_child_entity_no_validation(emap, component);
     }
 };
 
 template<typename Component>
 struct operation_remove : public operation_base {
+    operation_remove() : operation_base(registry_operation_type::remove, entt::type_index<Component>::value()) {}
+
     void execute(entt::registry &registry, entity_map &entity_map) const override {
         if (!entity_map.contains(entity)) {
             return;
@@ -259,16 +347,27 @@ struct operation_remove : public operation_base {
         }
     }
 
-    void remap(const entity_map &emap) override {
-        entity = emap.at(entity);
-    }
+    void execute_run(entt::registry &registry, entity_map &entity_map,
+                     operation_base *const *ops, size_t count) const override {
+        auto &storage = registry.storage<Component>();
+
+        for (size_t i = 0; i < count; ++i) {
+            auto *op = static_cast<const operation_remove<Component> *>(ops[i]);
 
-    entt::id_type payload_type_id() const override {
-        return entt::type_index<Component>::value();
+            if (!entity_map.contains(op->entity)) {
+                continue;
+            }
+
+            auto local_entity = entity_map.at(op->entity);
+
+            if (registry.valid(local_entity)) {
+                storage.remove(local_entity);
+            }
+        }
     }
 
-    registry_operation_type operation_type() const override {
-        return registry_operation_type::remove;
+    void remap(const entity_map &emap) override {
+        entity = emap.at(entity);
     }
 };
 
@@ -300,6 +399,7 @@ public:
     }
 
     registry_operation & operator=(registry_operation &&other) {
+        clear();
         data_blocks = std::move(other.data_blocks);
         operations = std::move(other.operations);
 
@@ -319,11 +419,48 @@ public:
         }
     }
 
+    /**
+     * @brief Destroys all operations but keeps the data blocks, so they can
+     * be reused by a `registry_operation_builder`.
+     */
+    void clear() {
+        for (auto *op : operations) {
+            op->~operation_base();
+        }
+
+        operations.clear();
+    }
+
+    /**
+     * @brief Executes all operations in order. Consecutive operations with the
+     * same type and payload, such as a series of replaces of one component,
+     * are executed together in a single pass over the destination pool.
+     * @param registry Destination registry.
+     * @param entity_map Maps remote into local entities.
+     * @param func Functions invoked with each operation after the sequence it
+     * belongs to is executed.
+     */
     template<typename... Func>
     void execute(entt::registry &registry, entity_map &entity_map, Func... func) const {
-        for (auto *op : operations) {
-            op->execute(registry, entity_map);
-            (func(op), ...);
+        const auto num_ops = operations.size();
+
+        for (size_t first = 0; first < num_ops;) {
+            auto *first_op = operations[first];
+            auto last = first + 1;
+
+            while (last < num_ops && operations[last]->same_kind_as(*first_op)) {
+                ++last;
+            }
+
+            first_op->execute_run(registry, entity_map, operations.data() + first, last - first);
+
+            if constexpr(sizeof...(Func) > 0) {
+                for (auto i = first; i < last; ++i) {
+                    (func(operations[i]), ...);
+                }
+            }
+
+            first = last;
         }
     }
 
@@ -339,6 +476,42 @@ public:
         }
     }
 
+    /**
+     * @brief Removes replace operations which are followed by another replace
+     * of the same component type for the same entity, thus only the latest
+     * value of each component is kept. All other operations are untouched and
+     * keep their order.
+     */
+    void coalesce_replacements() {
+        auto latest = std::unordered_set<uint64_t>{};
+        auto num_removed = size_t{};
+
+        // Iterate backwards to find the last replace of each component first.
+        for (auto i = operations.size(); i > 0; --i) {
+            auto *op = operations[i - 1];
+
+            if (op->operation_type() != registry_operation_type::replace) {
+                continue;
+            }
+
+            auto key = (static_cast<uint64_t>(entt::to_integral(op->entity)) << 32) |
+                       static_cast<uint64_t>(op->payload_type_id());
+
+            if (!latest.insert(key).second) {
+                // The operation's memory belongs to a data block thus only
+                // the destructor has to be called.
+                op->~operation_base();
+                operations[i - 1] = nullptr;
+                ++num_removed;
+            }
+        }
+
+        if (num_removed > 0) {
+            auto it = std::remove(operations.begin(), operations.end(), nullptr);
+            operations.erase(it, operations.end());
+        }
+    }
+
     bool empty() const {
         return operations.empty();
     }
@@ -22,15 +22,23 @@ class registry_operation_builder {
         constexpr unsigned long size = sizeof(T);
         static_assert(size <= max_block_size, "Component size larger than maximum block size.");
 
-        // Create new data block if current block size would be exceeded.
-        if (m_data_index + size > operation.data_blocks.back().size()) {
-            auto data = std::vector<uint8_t>{};
-            data.resize(std::min(size * data_block_unit_size, max_block_size));
-            operation.data_blocks.emplace_back(std::move(data));
+        auto &blocks = operation.data_blocks;
+
+        // Move on to the next data block if the current block size would be
+        // exceeded. Blocks left over from a reused operation are filled before
+        // new ones are allocated.
+        while (m_data_index + size > blocks[m_block_index].size()) {
+            ++m_block_index;
             m_data_index = 0;
+
+            if (m_block_index == blocks.size()) {
+                auto data = std::vector<uint8_t>{};
+                data.resize(std::min(size * data_block_unit_size, max_block_size));
+                blocks.emplace_back(std::move(data));
+            }
         }
 
-        auto buff = &operation.data_blocks.back()[m_data_index];
+        auto buff = &blocks[m_block_index][m_data_index];
         m_data_index += size;
 
         // Use placement new to allocate object in the current buffer.
@@ -168,9 +176,30 @@ public:
     }
 
     registry_operation && finish() {
+        // The operation is expected to be moved out, leaving a single empty
+        // data block behind.
+        m_block_index = 0;
+        m_data_index = 0;
         return std::move(operation);
     }
 
+    /**
+     * @brief Continue building on top of an operation that has already been
+     * executed, reusing its data blocks instead of allocating new ones.
+     * Must only be called right after `finish`.
+     * @param op An operation which is not needed anymore.
+     */
+    void reuse(registry_operation &&op) {
+        EDYN_ASSERT(operation.empty());
+        op.clear();
+
+        if (!op.data_blocks.empty()) {
+            operation = std::move(op);
+            m_block_index = 0;
+            m_data_index = 0;
+        }
+    }
+
     entt::registry & get_registry() {
         return *registry;
     }
@@ -215,6 +244,7 @@ public:
 protected:
     entt::registry *registry;
     registry_operation operation;
+    size_t m_block_index {};
     size_t m_data_index {};
 };
 
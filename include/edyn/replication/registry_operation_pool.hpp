@@ -0,0 +1,56 @@
+#ifndef EDYN_REPLICATION_REGISTRY_OPERATION_POOL_HPP
+#define EDYN_REPLICATION_REGISTRY_OPERATION_POOL_HPP
+
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "edyn/replication/registry_operation.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Thread-safe store of executed registry operations whose data blocks
+ * can be handed back to the builder in the thread that produced them.
+ */
+class registry_operation_pool {
+public:
+    /**
+     * @brief Take an operation from the pool.
+     * @return An operation with no pending operations, or nothing if the pool
+     * is empty.
+     */
+    std::optional<registry_operation> acquire() {
+        auto lock = std::lock_guard(m_mutex);
+
+        if (m_operations.empty()) {
+            return {};
+        }
+
+        auto op = std::optional<registry_operation>(std::move(m_operations.back()));
+        m_operations.pop_back();
+        return op;
+    }
+
+    /**
+     * @brief Insert an operation that has been executed into the pool.
+     * @param op Operation to be recycled.
+     */
+    void release(registry_operation &&op) {
+        op.clear();
+
+        auto lock = std::lock_guard(m_mutex);
+
+        if (m_operations.size() < max_size) {
+            m_operations.emplace_back(std::move(op));
+        }
+    }
+
+private:
+    static constexpr size_t max_size = 2;
+    std::vector<registry_operation> m_operations;
+    std::mutex m_mutex;
+};
+
+}
+
+#endif // EDYN_REPLICATION_REGISTRY_OPERATION_POOL_HPP
@@ -0,0 +1,121 @@
+#ifndef EDYN_REPLICATION_TRANSFORM_SYNC_HPP
+#define EDYN_REPLICATION_TRANSFORM_SYNC_HPP
+
+#include <mutex>
+#include <vector>
+#include <entt/entity/fwd.hpp>
+#include "edyn/comp/position.hpp"
+#include "edyn/comp/orientation.hpp"
+#include "edyn/comp/linvel.hpp"
+#include "edyn/comp/angvel.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Transforms and velocities of all active rigid bodies after a step,
+ * stored as a structure of arrays. Entities are already mapped into the
+ * destination registry, thus it can be applied without entity map lookups.
+ */
+struct transform_sync_buffer {
+    std::vector<entt::entity> entities;
+    std::vector<position> positions;
+    std::vector<orientation> orientations;
+    std::vector<linvel> linvels;
+    std::vector<angvel> angvels;
+
+    void push_back(entt::entity entity, const position &pos, const orientation &orn,
+                   const linvel &v, const angvel &w) {
+        entities.push_back(entity);
+        positions.push_back(pos);
+        orientations.push_back(orn);
+        linvels.push_back(v);
+        angvels.push_back(w);
+    }
+
+    void reserve(size_t size) {
+        entities.reserve(size);
+        positions.reserve(size);
+        orientations.reserve(size);
+        linvels.reserve(size);
+        angvels.reserve(size);
+    }
+
+    /**
+     * @brief Removes all entries while keeping the allocated memory.
+     */
+    void clear() {
+        entities.clear();
+        positions.clear();
+        orientations.clear();
+        linvels.clear();
+        angvels.clear();
+    }
+
+    size_t size() const {
+        return entities.size();
+    }
+
+    bool empty() const {
+        return entities.empty();
+    }
+};
+
+/**
+ * @brief Recycles transform buffers between the simulation worker and the
+ * main thread. The worker fills a buffer and moves it into a step update.
+ * The main thread gives it back once applied, thus the same two buffers keep
+ * going back and forth without reallocating every step.
+ */
+class transform_sync_channel {
+public:
+    /**
+     * @brief Obtain an empty buffer, reusing a released one if available.
+     * @return An empty buffer.
+     */
+    transform_sync_buffer acquire() {
+        auto lock = std::lock_guard(m_mutex);
+
+        if (m_free_buffers.empty()) {
+            return {};
+        }
+
+        auto buffer = std::move(m_free_buffers.back());
+        m_free_buffers.pop_back();
+        return buffer;
+    }
+
+    /**
+     * @brief Give back a buffer which has been applied so its memory can be
+     * reused by the next call to `acquire`.
+     * @param buffer The buffer to be recycled.
+     */
+    void release(transform_sync_buffer &&buffer) {
+        auto lock = std::lock_guard(m_mutex);
+
+        // Only keep enough buffers for double buffering. Anything beyond that
+        // means the main thread fell behind and these would only hold memory.
+        if (m_free_buffers.size() < max_free_buffers) {
+            buffer.clear();
+            m_free_buffers.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    static constexpr size_t max_free_buffers = 2;
+    std::vector<transform_sync_buffer> m_free_buffers;
+    std::mutex m_mutex;
+};
+
+/**
+ * @brief Assigns the transforms and velocities in the buffer to the
+ * corresponding entities in the registry. Entities which do not exist anymore
+ * or lack the components are skipped. Update signals are still emitted for
+ * every component.
+ * @param registry Destination registry.
+ * @param buffer Buffer with entities in the destination registry's space.
+ */
+void apply_transform_sync(entt::registry &registry, const transform_sync_buffer &buffer);
+
+}
+
+#endif // EDYN_REPLICATION_TRANSFORM_SYNC_HPP
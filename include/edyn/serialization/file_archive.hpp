@@ -52,6 +52,18 @@ public:
         (operator()(t), ...);
     }
 
+    /**
+     * @brief Read a contiguous sequence of values in one go.
+     * @param data Pointer to first element.
+     * @param count Number of elements.
+     */
+    template<typename T>
+    void serialize_range(T *data, size_t count) {
+        static_assert(is_trivially_serializable_v<T>);
+        EDYN_ASSERT(m_file.is_open() && !m_file.eof());
+        m_file.read(reinterpret_cast<char *>(data), sizeof(T) * count);
+    }
+
     void seek_position(size_t pos) {
         m_file.seekg(pos);
     }
@@ -95,6 +107,17 @@ public:
         (operator()(t), ...);
     }
 
+    /**
+     * @brief Write a contiguous sequence of values in one go.
+     * @param data Pointer to first element.
+     * @param count Number of elements.
+     */
+    template<typename T>
+    void serialize_range(T *data, size_t count) {
+        static_assert(is_trivially_serializable_v<T>);
+        m_file.write(reinterpret_cast<const char *>(data), sizeof(T) * count);
+    }
+
     void close() {
         m_file.close();
     }
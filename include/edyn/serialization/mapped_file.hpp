@@ -0,0 +1,61 @@
+#ifndef EDYN_SERIALIZATION_MAPPED_FILE_HPP
+#define EDYN_SERIALIZATION_MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace edyn {
+
+/**
+ * @brief A read-only view of a file mapped into memory. Can be read
+ * concurrently from multiple threads, e.g. using a `memory_input_archive`
+ * pointing at different offsets.
+ */
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    mapped_file(const std::string &path) {
+        open(path);
+    }
+
+    ~mapped_file() {
+        close();
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
+
+    /**
+     * @brief Map a file into memory. Closes the currently mapped file, if any.
+     * An empty file is opened successfully with a null `data()` and zero
+     * `size()`, since it cannot be mapped.
+     * @param path Path to file.
+     * @return Whether the file was mapped successfully.
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    bool is_open() const {
+        return m_open;
+    }
+
+    const uint8_t * data() const {
+        return m_data;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+    const uint8_t *m_data {nullptr};
+    size_t m_size {0};
+    bool m_open {false};
+};
+
+}
+
+#endif // EDYN_SERIALIZATION_MAPPED_FILE_HPP
@@ -13,6 +13,10 @@ void serialize(Archive &archive, vector3 &v) {
     archive(v.x, v.y, v.z);
 }
 
+static_assert(sizeof(vector3) == 3 * sizeof(scalar));
+template<>
+struct is_trivially_serializable<vector3> : std::true_type {};
+
 template<typename Archive>
 void serialize(Archive &archive, quaternion &q) {
     archive(q.x, q.y, q.z, q.w);
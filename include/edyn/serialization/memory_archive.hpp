@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <vector>
 #include <array>
@@ -40,6 +41,22 @@ public:
         (operator()(t), ...);
     }
 
+    template<typename T>
+    void serialize_range(T *data, size_t count) {
+        static_assert(is_trivially_serializable_v<T>);
+        if (m_failed) return;
+
+        auto num_bytes = sizeof(T) * count;
+
+        if (m_position + num_bytes > m_size) {
+            m_failed = true;
+            return;
+        }
+
+        std::memcpy(data, m_buffer + m_position, num_bytes);
+        m_position += num_bytes;
+    }
+
     bool failed() const {
         return m_failed;
     }
@@ -105,6 +122,15 @@ public:
         (operator()(t), ...);
     }
 
+    template<typename T>
+    void serialize_range(const T *data, size_t count) {
+        static_assert(is_trivially_serializable_v<T>);
+        auto idx = m_buffer->size();
+        auto num_bytes = sizeof(T) * count;
+        m_buffer->resize(idx + num_bytes);
+        std::memcpy(&(*m_buffer)[idx], data, num_bytes);
+    }
+
 protected:
     template<typename T>
     void write_bytes(const T &t) {
@@ -145,6 +171,22 @@ public:
         (operator()(t), ...);
     }
 
+    template<typename T>
+    void serialize_range(const T *data, size_t count) {
+        static_assert(is_trivially_serializable_v<T>);
+        if (m_failed) return;
+
+        auto num_bytes = sizeof(T) * count;
+
+        if (m_position + num_bytes > m_size) {
+            m_failed = true;
+            return;
+        }
+
+        std::memcpy(m_buffer + m_position, data, num_bytes);
+        m_position += num_bytes;
+    }
+
     bool failed() const {
         return m_failed;
     }
@@ -5,6 +5,7 @@
 #include "edyn/shapes/paged_triangle_mesh.hpp"
 #include "edyn/shapes/triangle_mesh_page_loader.hpp"
 #include "edyn/serialization/file_archive.hpp"
+#include "edyn/serialization/mapped_file.hpp"
 #include "edyn/parallel/job.hpp"
 #include <entt/signal/sigh.hpp>
 
@@ -95,7 +96,9 @@ private:
 
 /**
  * Specialized archive to read a `paged_triangle_mesh` from file. It can also be
- * used as a page loader in the `paged_triangle_mesh`.
+ * used as a page loader in the `paged_triangle_mesh`. In `embedded` mode, the
+ * file is mapped into memory and submeshes are read directly from the mapping,
+ * which allows multiple pages to be loaded concurrently.
  */
 class paged_triangle_mesh_file_input_archive: public file_input_archive, public triangle_mesh_page_loader_base {
 public:
@@ -116,6 +119,15 @@ public:
 
     void load(paged_triangle_mesh *trimesh, size_t index) override;
 
+    /**
+     * @brief Whether the last `paged_triangle_mesh` read from this archive had
+     * a valid header. Files written by other versions of the format are
+     * rejected and produce an empty mesh.
+     */
+    bool is_valid() const {
+        return m_valid;
+    }
+
     friend void serialize(paged_triangle_mesh_file_input_archive &archive,
                           paged_triangle_mesh &paged_tri_mesh);
     friend void finish_load_mesh_job_func(job::data_type &);
@@ -125,8 +137,10 @@ private:
     std::string m_path;
     size_t m_base_offset;
     std::vector<size_t> m_offsets;
+    mapped_file m_mapped_file;
     paged_triangle_mesh_serialization_mode m_mode;
     enqueue_task_t *m_enqueue_task {nullptr};
+    bool m_valid {false};
 };
 
 /**
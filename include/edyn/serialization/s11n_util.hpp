@@ -1,11 +1,27 @@
 #ifndef EDYN_SERIALIZATION_S11N_UTIL_HPP
 #define EDYN_SERIALIZATION_S11N_UTIL_HPP
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
 namespace edyn {
 
+/**
+ * @brief Whether the serialized representation of a value of type `T` is an
+ * exact copy of its bytes in memory. Contiguous sequences of these values are
+ * read and written in bulk by archives.
+ */
+template<typename T>
+struct is_trivially_serializable : std::is_arithmetic<T> {};
+
+template<typename T, size_t N>
+struct is_trivially_serializable<std::array<T, N>> : is_trivially_serializable<T> {};
+
+template<typename T>
+inline constexpr bool is_trivially_serializable_v = is_trivially_serializable<T>::value;
+
 template<typename Archive, typename Enum>
 void serialize_enum(Archive &archive, Enum &value) {
     using underlying_type = std::underlying_type_t<Enum>;
@@ -3,34 +3,78 @@
 
 #include "edyn/collision/static_tree.hpp"
 #include "edyn/serialization/std_s11n.hpp"
+#include "edyn/serialization/math_s11n.hpp"
 
 namespace edyn {
 
 template<typename Archive>
-void serialize(Archive &archive, static_tree::tree_node &node) {
-    archive(node.aabb.min);
-    archive(node.aabb.max);
-    archive(node.child1);
-    archive(node.child2);
+void serialize(Archive &archive, static_tree::compact_node &node) {
+    archive(node.min);
+    archive(node.max);
+    archive(node.data);
 }
 
+template<>
+struct is_trivially_serializable<static_tree::compact_node> : std::true_type {};
+
+namespace detail {
+    // Static trees are preceded by this marker and their format version.
+    // Archives written before nodes were stored in compact form start with
+    // the number of nodes instead, which is odd in a full binary tree, thus
+    // it can't be mistaken for the marker.
+    constexpr uint16_t static_tree_archive_marker = 0xfffe;
+    constexpr uint16_t static_tree_archive_version = 2;
+
+    template<typename Archive>
+    void skip_legacy_static_tree_nodes(Archive &archive, uint16_t num_nodes) {
+        for (uint16_t i = 0; i < num_nodes; ++i) {
+            vector3 aabb_min, aabb_max;
+            uint32_t child1, child2;
+            archive(aabb_min, aabb_max, child1, child2);
+        }
+    }
+}
+
+/**
+ * @brief Serializes a static tree. When reading, the tree is left empty if
+ * the archive holds another format version. Legacy archives are skipped,
+ * which leaves the archive in a valid state. Owners of the tree can rebuild
+ * it in that case.
+ */
 template<typename Archive>
 void serialize(Archive &archive, static_tree &tree) {
-    archive(tree.m_nodes);
-}
+    auto marker = detail::static_tree_archive_marker;
+    auto version = detail::static_tree_archive_version;
+    archive(marker);
 
-inline
-size_t serialization_sizeof(const static_tree::tree_node &node) {
-    return
-        sizeof(node.aabb.min) +
-        sizeof(node.aabb.max) +
-        sizeof(node.child1) +
-        sizeof(node.child2);
+    if constexpr(Archive::is_input::value) {
+        if (marker != detail::static_tree_archive_marker) {
+            detail::skip_legacy_static_tree_nodes(archive, marker);
+            tree.clear();
+            return;
+        }
+
+        archive(version);
+
+        if (version != detail::static_tree_archive_version) {
+            tree.clear();
+            return;
+        }
+    } else {
+        archive(version);
+    }
+
+    archive(tree.m_root_aabb);
+    archive(tree.m_nodes);
 }
 
 inline
 size_t serialization_sizeof(const static_tree &tree) {
-    return serialization_sizeof(tree.m_nodes);
+    return
+        sizeof(detail::static_tree_archive_marker) +
+        sizeof(detail::static_tree_archive_version) +
+        sizeof(tree.m_root_aabb) +
+        serialization_sizeof(tree.m_nodes);
 }
 
 }
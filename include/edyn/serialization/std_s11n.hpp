@@ -13,6 +13,7 @@
 #include <type_traits>
 #include <entt/core/ident.hpp>
 #include "edyn/util/tuple_util.hpp"
+#include "edyn/serialization/s11n_util.hpp"
 
 namespace edyn {
 
@@ -35,8 +36,14 @@ void serialize(Archive &archive, std::vector<T> &vector) {
     archive(size);
     vector.resize(size);
 
-    for (size_t i = 0; i < size; ++i) {
-        archive(vector[i]);
+    if constexpr(is_trivially_serializable_v<T>) {
+        if (size > 0) {
+            archive.serialize_range(vector.data(), size);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            archive(vector[i]);
+        }
     }
 }
 
@@ -76,7 +83,7 @@ void serialize(Archive &archive, std::vector<bool> &vector) {
 
 template<typename T>
 size_t serialization_sizeof(const std::vector<T> &vec) {
-    return sizeof(size_t) + vec.size() * sizeof(typename std::vector<T>::value_type);
+    return sizeof(uint16_t) + vec.size() * sizeof(typename std::vector<T>::value_type);
 }
 
 inline
@@ -84,7 +91,7 @@ size_t serialization_sizeof(const std::vector<bool> &vec) {
     using set_type = uint32_t;
     constexpr auto set_num_bits = sizeof(set_type) * 8;
     const auto num_sets = vec.size() / set_num_bits + (vec.size() % set_num_bits != 0);
-    return sizeof(size_t) + num_sets * sizeof(set_type);
+    return sizeof(uint16_t) + num_sets * sizeof(set_type);
 }
 
 template<typename Archive, typename T, size_t N>
@@ -3,6 +3,7 @@
 
 #include "edyn/shapes/triangle_mesh.hpp"
 #include "edyn/serialization/std_s11n.hpp"
+#include "edyn/serialization/math_s11n.hpp"
 #include "edyn/serialization/static_tree_s11n.hpp"
 
 namespace edyn {
@@ -13,6 +14,9 @@ void serialize(Archive &archive, unordered_pair<T> &pair) {
     archive(pair.second);
 }
 
+template<typename T>
+struct is_trivially_serializable<unordered_pair<T>> : is_trivially_serializable<T> {};
+
 template<typename T>
 constexpr size_t serialization_sizeof(const unordered_pair<T> &pair) {
     return 2 * sizeof(T);
@@ -46,6 +50,13 @@ void serialize(Archive &archive, triangle_mesh &tri_mesh) {
     archive(tri_mesh.m_restitution);
     archive(tri_mesh.m_material_ids);
     archive(tri_mesh.m_thickness);
+
+    if constexpr(Archive::is_input::value) {
+        // The tree is not loaded if it was written in another format.
+        if (tri_mesh.m_triangle_tree.empty() && tri_mesh.num_triangles() > 0) {
+            tri_mesh.build_triangle_tree();
+        }
+    }
 }
 
 inline
@@ -82,8 +82,7 @@ template<typename Func>
 void compound_shape::visit(const AABB &aabb, Func func) const {
     EDYN_ASSERT(!tree.empty());
 
-    tree.query(aabb, [&](auto tree_node_idx) {
-        auto node_id = tree.get_node(tree_node_idx).id;
+    tree.query(aabb, [&](auto node_id) {
         auto &node = nodes[node_id];
         std::visit([&](auto &&shape) {
             func(shape, node_id);
@@ -95,8 +94,7 @@ template<typename Func>
 void compound_shape::raycast(const vector3 &p0, const vector3 &p1, Func func) const {
     EDYN_ASSERT(!tree.empty());
 
-    tree.raycast(p0, p1, [&](auto tree_node_idx) {
-        auto node_id = tree.get_node(tree_node_idx).id;
+    tree.raycast(p0, p1, [&](auto node_id) {
         auto &node = nodes[node_id];
         std::visit([&](auto &&shape) {
             func(shape, node_id);
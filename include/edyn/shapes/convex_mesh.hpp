@@ -170,11 +170,17 @@ struct convex_mesh {
 /**
  * @brief Accompanying component for `convex_mesh`es containing their
  * rotated vertices, normals and edges to prevent repeated recalculation of
- * these values.
+ * these values. Rotated meshes are brought up to date in the narrowphase,
+ * only for bodies which are in a contact manifold.
  */
 struct rotated_mesh {
     std::vector<vector3> vertices;
     std::vector<vector3> normals;
+
+    // Orientation applied to the vertices and normals in the last update.
+    // Used to skip updates when the orientation hasn't changed. The initial
+    // value is not a valid orientation, which forces the first update.
+    quaternion orientation {0, 0, 0, 0};
 };
 
 /**
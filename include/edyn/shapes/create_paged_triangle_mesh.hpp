@@ -250,15 +250,11 @@ void create_paged_triangle_mesh(
 
     // Build tree and submeshes.
     auto builder = detail::submesh_builder{};
-    paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), builder, max_tri_per_submesh);
+    paged_tri_mesh.m_tree.build(aabbs.begin(), aabbs.end(), builder, max_tri_per_submesh, enqueue_task_wait);
     builder.build(paged_tri_mesh, global_tri_mesh, vertex_begin, index_begin, vertex_colors, color_scale, enqueue_task_wait);
 
-    // Resize LRU queue to have the number of leaves.
-    paged_tri_mesh.m_lru_indices.resize(paged_tri_mesh.m_cache.size());
-    std::iota(paged_tri_mesh.m_lru_indices.begin(),
-              paged_tri_mesh.m_lru_indices.end(), 0);
-
-    paged_tri_mesh.m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(paged_tri_mesh.m_cache.size());
+    // Set up LRU list and cache accounting for the new set of submeshes.
+    paged_tri_mesh.init_cache();
 }
 
 }
@@ -0,0 +1,513 @@
+#ifndef EDYN_SHAPES_HEIGHTFIELD_HPP
+#define EDYN_SHAPES_HEIGHTFIELD_HPP
+
+#include <array>
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "edyn/config/config.h"
+#include "edyn/math/vector2.hpp"
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/triangle.hpp"
+#include "edyn/comp/aabb.hpp"
+#include "edyn/shapes/heightfield_page_loader.hpp"
+
+namespace edyn {
+
+/**
+ * @brief A terrain defined by a regular grid of height samples. Sample at
+ * column `i` and row `j` is located at
+ * `origin + {i * cell_size.x, height, j * cell_size.y}`, i.e. columns run
+ * along the x axis and rows along the z axis. Each cell is split into two
+ * triangles along the diagonal that goes from sample `(i, j)` to
+ * `(i + 1, j + 1)`, with normals facing up.
+ *
+ * Since the position of every vertex is implied by its location in the
+ * grid, only heights are stored, optionally quantized to 16 bits, and the
+ * triangles overlapping a region are found directly from its coordinates,
+ * without a tree. Triangles are indexed by cell, i.e. triangle `k` of cell
+ * `(i, j)` has index `(j * (num_columns - 1) + i) * 2 + k`, and vertex
+ * `(i, j)` has index `j * num_columns + i`.
+ *
+ * The grid is split into square pages of cells which share the samples on
+ * their borders. Pages can be loaded on demand by a page loader, in which
+ * case the least recently visited pages are unloaded to keep memory usage
+ * within `m_max_cache_num_bytes`.
+ */
+class heightfield {
+public:
+    using index_type = uint32_t;
+
+    static constexpr size_t default_page_size = 64;
+
+    /**
+     * @brief Range of samples covered by a page.
+     */
+    struct page_extent {
+        size_t column;
+        size_t row;
+        size_t num_columns;
+        size_t num_rows;
+    };
+
+    /**
+     * @brief Constructs a flat heightfield with no pages loaded.
+     * @param num_columns Number of samples along the x axis. At least 2.
+     * @param num_rows Number of samples along the z axis. At least 2.
+     * @param cell_size Distance between samples along the x and z axes.
+     * @param origin Position of the first sample at zero height.
+     * @param quantized Whether to store heights as 16-bit integers.
+     * @param page_size Number of cells along each side of a page.
+     */
+    heightfield(size_t num_columns, size_t num_rows, vector2 cell_size,
+                vector3 origin = vector3_zero, bool quantized = false,
+                size_t page_size = default_page_size);
+
+    /**
+     * @brief Assigns heights to all samples, which loads all pages. The
+     * samples are given in row-major order, i.e. all columns of the first row
+     * followed by all columns of the second row and so on.
+     */
+    template<typename It>
+    void insert_heights(It first, It last) {
+        init_heights(std::vector<scalar>(first, last));
+    }
+
+    /**
+     * @brief Sets a loader which will be asked to load pages when they're
+     * needed. Since the pages might not be loaded, the range of heights must
+     * be known upfront. It's used for the AABB and for quantization.
+     * @param loader The page loader.
+     * @param min_height Lowest height in the heightfield.
+     * @param max_height Highest height in the heightfield.
+     */
+    void set_page_loader(std::shared_ptr<heightfield_page_loader_base> loader,
+                         scalar min_height, scalar max_height);
+
+    /**
+     * @brief Assigns the heights of a page. Called by page loaders.
+     * @param page_idx Page index.
+     * @param heights Heights of the samples in the page extent, in row-major
+     * order relative to the first sample of the page.
+     */
+    void assign_page(size_t page_idx, const std::vector<scalar> &heights);
+
+    page_extent get_page_extent(size_t page_idx) const;
+
+    bool is_page_loaded(size_t page_idx) const {
+        EDYN_ASSERT(page_idx < m_pages.size());
+        return static_cast<bool>(m_pages[page_idx].data);
+    }
+
+    /**
+     * @brief Unloads all pages. Does nothing if there's no page loader since
+     * the pages could not be loaded back.
+     */
+    void clear_cache();
+
+    /**
+     * @brief Starts loading the pages which intersect the given AABB.
+     * @param aabb Query AABB.
+     */
+    void prefetch(const AABB &aabb);
+
+    size_t num_columns() const { return m_num_columns; }
+    size_t num_rows() const { return m_num_rows; }
+    size_t num_cells() const { return (m_num_columns - 1) * (m_num_rows - 1); }
+    size_t num_triangles() const { return num_cells() * 2; }
+    size_t num_pages() const { return m_pages.size(); }
+    vector2 get_cell_size() const { return m_cell_size; }
+    vector3 get_origin() const { return m_origin; }
+    bool is_quantized() const { return m_quantized; }
+
+    AABB get_aabb() const;
+
+    /**
+     * @brief Get the height of a sample, without the origin offset. The page
+     * containing the sample must be loaded.
+     */
+    scalar get_height(size_t column, size_t row) const;
+
+    /**
+     * @brief Get the vertices of a triangle. Its page must be loaded.
+     */
+    triangle_vertices get_triangle_vertices(size_t tri_idx) const;
+
+    /**
+     * @brief Get the normal of a triangle. Its page must be loaded.
+     */
+    vector3 get_triangle_normal(size_t tri_idx) const;
+
+    /**
+     * @brief Gathers all collision data of a triangle into a `packed_triangle`.
+     * Its page must be loaded. Edges shared with triangles in pages that are
+     * not loaded are treated as boundary edges.
+     */
+    packed_triangle make_packed_triangle(size_t tri_idx) const;
+
+    /**
+     * @brief Visits the triangles of the cells that intersect `aabb` whose
+     * height range overlaps it and whose plane is not further than
+     * `threshold` from `shape_aabb`. This is the heightfield counterpart of
+     * `triangle_mesh::visit_packed_triangles`. Pages which are not loaded
+     * start loading and are skipped.
+     * @param aabb Query region.
+     * @param shape_aabb Bounding box of the shape being tested.
+     * @param threshold Maximum separation along triangle normals.
+     * @param func Function called with the triangle index and a
+     * `const packed_triangle &` for each triangle that passes the test.
+     */
+    template<typename Func>
+    void visit_packed_triangles(const AABB &aabb, const AABB &shape_aabb,
+                                scalar threshold, Func func) {
+        size_t column_begin, column_end, row_begin, row_end;
+
+        if (!get_cell_range(aabb, column_begin, column_end, row_begin, row_end)) {
+            return;
+        }
+
+        auto batch = packed_triangle_batch<Func>(shape_aabb, threshold, func);
+        const auto min_y = aabb.min.y - m_origin.y;
+        const auto max_y = aabb.max.y - m_origin.y;
+
+        for (auto page_row = row_begin / m_page_size; page_row <= (row_end - 1) / m_page_size; ++page_row) {
+            for (auto page_column = column_begin / m_page_size; page_column <= (column_end - 1) / m_page_size; ++page_column) {
+                auto page_idx = page_row * m_num_page_columns + page_column;
+                load_page_if_needed(page_idx);
+
+                // Make copy of shared_ptr to keep page alive while visiting.
+                auto pg = m_pages[page_idx].data;
+
+                if (!pg) {
+                    continue;
+                }
+
+                auto ext = get_page_extent(page_idx);
+                auto first_column = std::max(column_begin, ext.column);
+                auto last_column = std::min(column_end, ext.column + ext.num_columns - 1);
+                auto first_row = std::max(row_begin, ext.row);
+                auto last_row = std::min(row_end, ext.row + ext.num_rows - 1);
+
+                for (auto row = first_row; row < last_row; ++row) {
+                    for (auto column = first_column; column < last_column; ++column) {
+                        auto local_idx = (row - ext.row) * ext.num_columns + (column - ext.column);
+                        auto h00 = page_height(*pg, local_idx);
+                        auto h10 = page_height(*pg, local_idx + 1);
+                        auto h01 = page_height(*pg, local_idx + ext.num_columns);
+                        auto h11 = page_height(*pg, local_idx + ext.num_columns + 1);
+                        auto cell_idx = row * (m_num_columns - 1) + column;
+
+                        for (size_t k = 0; k < 2; ++k) {
+                            auto h = k == 0 ? h01 : h10;
+                            auto lo = std::min(std::min(h00, h11), h);
+                            auto hi = std::max(std::max(h00, h11), h);
+
+                            if (lo > max_y || hi < min_y) {
+                                continue;
+                            }
+
+                            auto &tri = batch.next_storage();
+                            fill_packed_triangle(column, row, k, *pg, ext, tri);
+                            batch.push(static_cast<index_type>(cell_idx * 2 + k), tri);
+                        }
+                    }
+                }
+
+                mark_recent_visit(page_idx);
+            }
+        }
+
+        batch.flush();
+    }
+
+    /**
+     * @brief Walks the cells crossed by the segment `p0`-`p1` in order,
+     * starting at `p0`, and visits the triangles of the cells where the
+     * segment is within the height range of the cell. Only pages that are
+     * loaded are considered and no pages will be loaded by this call.
+     * @param p0 First point in the ray.
+     * @param p1 Second point in the ray.
+     * @param func Function with signature
+     * `bool(index_type tri_idx, const triangle_vertices &, const vector3 &normal)`.
+     * Returning true stops the walk after all triangles of the current cell
+     * are visited. Since cells are visited in order along the segment, a hit
+     * in a cell is closer than any hit in the following cells.
+     */
+    template<typename Func>
+    void raycast(const vector3 &p0, const vector3 &p1, Func func) const {
+        const auto d = p1 - p0;
+        const auto aabb = get_aabb();
+        auto t_enter = scalar(0);
+        auto t_exit = scalar(1);
+
+        // Clip segment against bounds.
+        for (size_t i = 0; i < 3; ++i) {
+            if (std::abs(d[i]) < EDYN_EPSILON) {
+                if (p0[i] < aabb.min[i] || p0[i] > aabb.max[i]) {
+                    return;
+                }
+            } else {
+                auto t0 = (aabb.min[i] - p0[i]) / d[i];
+                auto t1 = (aabb.max[i] - p0[i]) / d[i];
+
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+
+                t_enter = std::max(t_enter, t0);
+                t_exit = std::min(t_exit, t1);
+
+                if (t_enter > t_exit) {
+                    return;
+                }
+            }
+        }
+
+        // Digital differential analyzer: step into the neighboring cell whose
+        // border is crossed first.
+        const auto num_cell_columns = static_cast<std::ptrdiff_t>(m_num_columns - 1);
+        const auto num_cell_rows = static_cast<std::ptrdiff_t>(m_num_rows - 1);
+        const auto entry = p0 + d * t_enter;
+        auto column = std::clamp(static_cast<std::ptrdiff_t>(std::floor((entry.x - m_origin.x) / m_cell_size.x)),
+                                 std::ptrdiff_t(0), num_cell_columns - 1);
+        auto row = std::clamp(static_cast<std::ptrdiff_t>(std::floor((entry.z - m_origin.z) / m_cell_size.y)),
+                              std::ptrdiff_t(0), num_cell_rows - 1);
+
+        std::ptrdiff_t step[2];
+        scalar t_max[2], t_delta[2];
+        const scalar dir[2] = {d.x, d.z};
+        const scalar start[2] = {p0.x - m_origin.x, p0.z - m_origin.z};
+        const scalar size[2] = {m_cell_size.x, m_cell_size.y};
+        const std::ptrdiff_t cell[2] = {column, row};
+
+        for (size_t i = 0; i < 2; ++i) {
+            if (dir[i] > 0) {
+                step[i] = 1;
+                t_max[i] = (scalar(cell[i] + 1) * size[i] - start[i]) / dir[i];
+                t_delta[i] = size[i] / dir[i];
+            } else if (dir[i] < 0) {
+                step[i] = -1;
+                t_max[i] = (scalar(cell[i]) * size[i] - start[i]) / dir[i];
+                t_delta[i] = -size[i] / dir[i];
+            } else {
+                step[i] = 0;
+                t_max[i] = t_delta[i] = EDYN_SCALAR_MAX;
+            }
+        }
+
+        auto page_idx = m_pages.size();
+        auto pg = std::shared_ptr<page>{};
+        auto ext = page_extent{};
+        auto t_cell_enter = t_enter;
+
+        while (true) {
+            auto t_cell_exit = std::min(std::min(t_max[0], t_max[1]), t_exit);
+            auto cell_page_idx = get_cell_page_index(size_t(column), size_t(row));
+
+            if (cell_page_idx != page_idx) {
+                page_idx = cell_page_idx;
+                pg = m_pages[page_idx].data;
+                ext = get_page_extent(page_idx);
+            }
+
+            if (pg) {
+                auto local_idx = (size_t(row) - ext.row) * ext.num_columns + (size_t(column) - ext.column);
+                scalar heights[2][2] = {
+                    {page_height(*pg, local_idx), page_height(*pg, local_idx + ext.num_columns)},
+                    {page_height(*pg, local_idx + 1), page_height(*pg, local_idx + ext.num_columns + 1)}
+                };
+                auto cell_min = std::min(std::min(heights[0][0], heights[0][1]), std::min(heights[1][0], heights[1][1]));
+                auto cell_max = std::max(std::max(heights[0][0], heights[0][1]), std::max(heights[1][0], heights[1][1]));
+                auto y0 = p0.y + d.y * t_cell_enter - m_origin.y;
+                auto y1 = p0.y + d.y * t_cell_exit - m_origin.y;
+
+                if (std::max(y0, y1) >= cell_min && std::min(y0, y1) <= cell_max) {
+                    auto stop = false;
+                    auto cell_idx = size_t(row) * (m_num_columns - 1) + size_t(column);
+
+                    for (size_t k = 0; k < 2; ++k) {
+                        auto vertices = cell_triangle_vertices(size_t(column), size_t(row), k, heights);
+                        auto normal = triangle_normal(vertices);
+                        stop |= func(static_cast<index_type>(cell_idx * 2 + k), vertices, normal);
+                    }
+
+                    if (stop) {
+                        return;
+                    }
+                }
+            }
+
+            if (t_cell_exit >= t_exit) {
+                break;
+            }
+
+            auto axis = t_max[0] < t_max[1] ? 0 : 1;
+            t_cell_enter = t_max[axis];
+            t_max[axis] += t_delta[axis];
+
+            if (axis == 0) {
+                column += step[0];
+
+                if (column < 0 || column >= num_cell_columns) {
+                    break;
+                }
+            } else {
+                row += step[1];
+
+                if (row < 0 || row >= num_cell_rows) {
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the estimated amount of memory used by the pages
+     * currently loaded.
+     * @return The size of the cache in bytes.
+     */
+    size_t cache_num_bytes() const {
+        return m_cache_num_bytes.load(std::memory_order_relaxed);
+    }
+
+    scalar get_thickness() const { return m_thickness; }
+
+    void set_thickness(scalar thickness) { m_thickness = thickness; }
+
+    /**
+     * @brief Maximum estimated memory used by the loaded pages in bytes.
+     * Before a new page is loaded, the least recently visited pages will be
+     * unloaded until the cache fits in this budget. Only applies if there's
+     * a page loader.
+     */
+    size_t m_max_cache_num_bytes = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief How far ahead in time to prefetch pages along the path of moving
+     * bodies which are in contact with this heightfield, in seconds. Zero by
+     * default, which disables prefetching.
+     */
+    scalar m_prefetch_time {scalar(0)};
+
+private:
+    struct page {
+        // Only one of these is used depending on whether the heightfield
+        // is quantized.
+        std::vector<scalar> heights;
+        std::vector<uint16_t> quantized_heights;
+    };
+
+    struct page_node {
+        std::shared_ptr<page> data;
+        size_t num_bytes {0};
+    };
+
+    void init_heights(const std::vector<scalar> &heights);
+    void init_cache();
+    size_t page_num_bytes(size_t page_idx) const;
+    void load_page_if_needed(size_t page_idx);
+    void mark_recent_visit(size_t page_idx);
+    bool unload_least_recently_visited_page();
+
+    // LRU list operations. Must be called with `m_lru_mutex` locked.
+    bool lru_contains(size_t page_idx) const;
+    void lru_push_front(size_t page_idx);
+    void lru_unlink(size_t page_idx);
+
+    bool get_cell_range(const AABB &aabb, size_t &column_begin, size_t &column_end,
+                        size_t &row_begin, size_t &row_end) const;
+
+    size_t get_cell_page_index(size_t column, size_t row) const {
+        return (row / m_page_size) * m_num_page_columns + column / m_page_size;
+    }
+
+    scalar page_height(const page &pg, size_t local_idx) const {
+        if (m_quantized) {
+            return m_min_height + scalar(pg.quantized_heights[local_idx]) * m_quantization_step;
+        }
+
+        return pg.heights[local_idx];
+    }
+
+    // Height of any sample, looking into neighboring pages if the sample is
+    // not in `pg`. Returns false if the page containing it is not loaded.
+    bool sample_height(size_t column, size_t row, const page &pg, const page_extent &ext,
+                       scalar &height) const;
+
+    // Heights of the vertices of triangle `k` of a cell in winding order.
+    bool triangle_heights(size_t column, size_t row, size_t k, const page &pg,
+                          const page_extent &ext, std::array<scalar, 3> &heights) const;
+
+    vector3 sample_position(size_t column, size_t row, scalar height) const {
+        return {m_origin.x + scalar(column) * m_cell_size.x,
+                m_origin.y + height,
+                m_origin.z + scalar(row) * m_cell_size.y};
+    }
+
+    // Vertices of triangle `k` of a cell given the heights of its corners,
+    // indexed as `heights[column offset][row offset]`.
+    triangle_vertices cell_triangle_vertices(size_t column, size_t row, size_t k,
+                                             const scalar (&heights)[2][2]) const {
+        if (k == 0) {
+            return {
+                sample_position(column, row, heights[0][0]),
+                sample_position(column, row + 1, heights[0][1]),
+                sample_position(column + 1, row + 1, heights[1][1])
+            };
+        }
+
+        return {
+            sample_position(column, row, heights[0][0]),
+            sample_position(column + 1, row + 1, heights[1][1]),
+            sample_position(column + 1, row, heights[1][0])
+        };
+    }
+
+    static vector3 triangle_normal(const triangle_vertices &vertices) {
+        auto e0 = vertices[1] - vertices[0];
+        auto e1 = vertices[2] - vertices[1];
+        return normalize(cross(e0, e1));
+    }
+
+    void fill_packed_triangle(size_t column, size_t row, size_t k, const page &pg,
+                              const page_extent &ext, packed_triangle &tri) const;
+
+    static constexpr size_t lru_null = std::numeric_limits<size_t>::max();
+
+    size_t m_num_columns;
+    size_t m_num_rows;
+    vector2 m_cell_size;
+    vector3 m_origin;
+    bool m_quantized;
+    size_t m_page_size;
+    size_t m_num_page_columns;
+    size_t m_num_page_rows;
+
+    scalar m_min_height {0};
+    scalar m_max_height {0};
+    scalar m_quantization_step {0};
+    scalar m_thickness {1};
+
+    std::vector<page_node> m_pages;
+
+    // Intrusive doubly-linked list containing the loaded pages, from most to
+    // least recently visited. Only maintained if there's a page loader.
+    std::vector<size_t> m_lru_prev;
+    std::vector<size_t> m_lru_next;
+    size_t m_lru_head {lru_null};
+    size_t m_lru_tail {lru_null};
+    std::mutex m_lru_mutex;
+
+    std::atomic<size_t> m_cache_num_bytes {0};
+    std::unique_ptr<std::atomic<bool>[]> m_is_loading_page;
+    std::shared_ptr<heightfield_page_loader_base> m_page_loader;
+};
+
+}
+
+#endif // EDYN_SHAPES_HEIGHTFIELD_HPP
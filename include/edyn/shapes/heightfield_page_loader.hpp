@@ -0,0 +1,23 @@
+#ifndef EDYN_SHAPES_HEIGHTFIELD_PAGE_LOADER_HPP
+#define EDYN_SHAPES_HEIGHTFIELD_PAGE_LOADER_HPP
+
+#include <cstddef>
+
+namespace edyn {
+
+class heightfield;
+
+/**
+ * @brief Provides the height samples of a page of a `heightfield` on demand.
+ * Implementations must eventually call `heightfield::assign_page`, possibly
+ * from another thread.
+ */
+class heightfield_page_loader_base {
+public:
+    virtual ~heightfield_page_loader_base() = default;
+    virtual void load(heightfield *field, size_t page_index) = 0;
+};
+
+}
+
+#endif // EDYN_SHAPES_HEIGHTFIELD_PAGE_LOADER_HPP
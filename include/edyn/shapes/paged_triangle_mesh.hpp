@@ -5,6 +5,7 @@
 #include <vector>
 #include <atomic>
 #include <memory>
+#include <limits>
 #include "edyn/context/task.hpp"
 #include "edyn/math/constants.hpp"
 #include "edyn/shapes/triangle_mesh.hpp"
@@ -30,6 +31,9 @@ public:
     struct triangle_mesh_node {
         size_t num_vertices;
         size_t num_indices;
+        // Estimated memory footprint of the loaded mesh in bytes. Zero if
+        // the mesh is not loaded.
+        size_t num_bytes {0};
         // Triangle mesh pointer. Will be nullptr if mesh is not loaded.
         std::shared_ptr<triangle_mesh> trimesh;
     };
@@ -46,8 +50,7 @@ public:
      */
     template<typename Func>
     void visit_submeshes(const AABB &aabb, Func func) {
-        m_tree.query(aabb, [&](auto tree_node_idx) {
-            auto mesh_idx = m_tree.get_node(tree_node_idx).id;
+        m_tree.query(aabb, [&](auto mesh_idx) {
             load_node_if_needed(mesh_idx);
 
             if (m_cache[mesh_idx].trimesh) {
@@ -57,6 +60,19 @@ public:
         });
     }
 
+    /**
+     * @brief Start loading submeshes which intersect the given AABB without
+     * visiting them. Loading happens in the background if the page loader
+     * enqueues tasks, thus this can be used to bring submeshes into the
+     * cache before they're needed, e.g. ahead of moving bodies.
+     * @param aabb Query AABB.
+     */
+    void prefetch(const AABB &aabb) {
+        m_tree.query(aabb, [&](auto mesh_idx) {
+            load_node_if_needed(mesh_idx);
+        });
+    }
+
     /**
      * @brief Loops over all edges present in the cache.
      * @tparam Func Type of the function object to invoke.
@@ -87,8 +103,7 @@ public:
      */
     template<typename Func>
     void visit_triangles(const AABB &aabb, Func func) {
-        m_tree.query(aabb, [&](auto tree_node_idx) {
-            auto mesh_idx = m_tree.get_node(tree_node_idx).id;
+        m_tree.query(aabb, [&](auto mesh_idx) {
             load_node_if_needed(mesh_idx);
             auto trimesh = m_cache[mesh_idx].trimesh;
 
@@ -159,8 +174,7 @@ public:
      */
     template<typename Func>
     void raycast(const vector3 &p0, const vector3 &p1, Func func) {
-        m_tree.raycast(p0, p1, [&](auto tree_node_idx) {
-            auto mesh_idx = m_tree.get_node(tree_node_idx).id;
+        m_tree.raycast(p0, p1, [&](auto mesh_idx) {
             load_node_if_needed(mesh_idx);
             auto trimesh = m_cache[mesh_idx].trimesh;
 
@@ -183,8 +197,7 @@ public:
      */
     template<typename Func>
     void raycast_cached(const vector3 &p0, const vector3 &p1, Func func) const {
-        m_tree.raycast(p0, p1, [&](auto tree_node_idx) {
-            auto mesh_idx = m_tree.get_node(tree_node_idx).id;
+        m_tree.raycast(p0, p1, [&](auto mesh_idx) {
             auto trimesh = m_cache[mesh_idx].trimesh;
 
             if (trimesh) {
@@ -207,7 +220,18 @@ public:
      * @brief Returns the number of vertices currently in the cache.
      * @return The size of the cache in number of vertices.
      */
-    size_t cache_num_vertices() const;
+    size_t cache_num_vertices() const {
+        return m_cache_num_vertices.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the estimated amount of memory used by the submeshes
+     * currently in the cache.
+     * @return The size of the cache in bytes.
+     */
+    size_t cache_num_bytes() const {
+        return m_cache_num_bytes.load(std::memory_order_relaxed);
+    }
 
     /**
      * @brief Get total number of sub-meshes this triangle mesh was
@@ -295,6 +319,20 @@ public:
      */
     size_t m_max_cache_num_vertices = 1 << 13;
 
+    /**
+     * @brief Maximum estimated memory used by the cache in bytes. Before a
+     * new triangle mesh is loaded, the least recently visited nodes will be
+     * unloaded until the cache fits in this budget.
+     */
+    size_t m_max_cache_num_bytes = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief How far ahead in time to prefetch submeshes along the path of
+     * moving bodies which are in contact with this mesh, in seconds. Zero by
+     * default, which disables prefetching.
+     */
+    scalar m_prefetch_time {scalar(0)};
+
     template<typename VertexIterator, typename IndexIterator>
     friend void create_paged_triangle_mesh(
             paged_triangle_mesh &paged_tri_mesh,
@@ -317,14 +355,32 @@ public:
                           paged_triangle_mesh &paged_tri_mesh);
 
 private:
+    void init_cache();
     void load_node_if_needed(size_t trimesh_idx);
     void mark_recent_visit(size_t trimesh_idx);
-    void unload_least_recently_visited_node();
+    // Unloads the node at the tail of the LRU list, unless it's `keep_idx`.
+    bool unload_least_recently_visited_node(size_t keep_idx = lru_null);
+
+    // LRU list operations. Must be called with `m_lru_mutex` locked.
+    bool lru_contains(size_t trimesh_idx) const;
+    void lru_push_front(size_t trimesh_idx);
+    void lru_unlink(size_t trimesh_idx);
+
+    static constexpr size_t lru_null = std::numeric_limits<size_t>::max();
 
     static_tree m_tree;
     std::vector<triangle_mesh_node> m_cache;
-    std::vector<size_t> m_lru_indices;
+
+    // Intrusive doubly-linked list containing the loaded submeshes, from
+    // most to least recently visited.
+    std::vector<size_t> m_lru_prev;
+    std::vector<size_t> m_lru_next;
+    size_t m_lru_head {lru_null};
+    size_t m_lru_tail {lru_null};
     std::mutex m_lru_mutex;
+
+    std::atomic<size_t> m_cache_num_vertices {0};
+    std::atomic<size_t> m_cache_num_bytes {0};
     std::unique_ptr<std::atomic<bool>[]> m_is_loading_submesh;
     std::shared_ptr<triangle_mesh_page_loader_base> m_page_loader;
     scalar m_thickness {1};
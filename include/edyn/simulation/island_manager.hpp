@@ -29,6 +29,12 @@ class island_manager {
     void on_destroy_graph_edge(entt::registry &, entt::entity);
     void on_destroy_island_resident(entt::registry &, entt::entity);
     void on_destroy_multi_island_resident(entt::registry &, entt::entity);
+    void on_compaction_candidate(entt::registry &, entt::entity);
+    template<typename Component>
+    void on_destroy_compacted_component(entt::registry &, entt::entity);
+
+    void set_pool_compaction_enabled(bool enabled);
+    void compact_pools();
 
 public:
     island_manager(entt::registry &registry);
@@ -53,6 +59,15 @@ private:
     entt::sparse_set m_islands_to_wake_up;
     std::vector<entt::scoped_connection> m_connections;
     double m_last_time;
+
+    // Pool compaction state. Each compacted pool holds dormant entities in
+    // `[0, m_dormant_counts[i])` and awake ones after that. Entities that
+    // could be on the wrong side of the boundary are collected as candidates
+    // and moved across it in `compact_pools`.
+    std::vector<entt::scoped_connection> m_compaction_connections;
+    std::vector<entt::entity> m_compaction_candidates;
+    std::vector<size_t> m_dormant_counts;
+    bool m_pool_compaction_enabled {false};
 };
 
 }
@@ -16,7 +16,10 @@
 #include "edyn/replication/entity_map.hpp"
 #include "edyn/replication/registry_operation_builder.hpp"
 #include "edyn/replication/registry_operation_observer.hpp"
+#include "edyn/replication/registry_operation_pool.hpp"
+#include "edyn/replication/transform_sync.hpp"
 #include "edyn/simulation/island_manager.hpp"
+#include "edyn/simulation/worker_pacing_stats.hpp"
 #include "edyn/util/polyhedron_shape_initializer.hpp"
 
 namespace edyn {
@@ -37,6 +40,8 @@ class simulation_worker final {
     void wake_up_affected_islands(const registry_operation &ops);
     void consume_raycast_results();
     void mark_transforms_replaced();
+    bool wait_until(double deadline);
+    void record_pacing_error(double error);
 
 public:
     simulation_worker(const settings &settings,
@@ -44,8 +49,11 @@ public:
                       const material_mix_table &material_table);
     ~simulation_worker();
 
+    void on_push_message();
     void on_construct_shared_entity(entt::registry &registry, entt::entity entity);
     void on_destroy_shared_entity(entt::registry &registry, entt::entity entity);
+    void on_update_contact_manifold_events(entt::registry &registry, entt::entity entity);
+    void on_construct_sleeping_tag(entt::registry &registry, entt::entity entity);
 
     void on_update_entities(message<msg::update_entities> &msg);
     void on_set_paused(message<msg::set_paused> &msg);
@@ -65,6 +73,16 @@ public:
     void start();
     void stop();
 
+    transform_sync_channel & get_transform_sync_channel() {
+        return m_transform_channel;
+    }
+
+    registry_operation_pool & get_registry_operation_pool() {
+        return m_op_pool;
+    }
+
+    worker_pacing_stats get_pacing_stats() const;
+
 private:
     entt::registry m_registry;
     entity_map m_entity_map;
@@ -92,11 +110,22 @@ private:
     std::unique_ptr<registry_operation_builder> m_op_builder;
     std::unique_ptr<registry_operation_observer> m_op_observer;
     bool m_importing;
+    registry_operation_pool m_op_pool;
+
+    transform_sync_channel m_transform_channel;
+    transform_sync_buffer m_transforms;
+    bool m_contact_events_pending {false};
+    std::vector<entt::entity> m_fell_asleep_entities;
 
     std::atomic<bool> m_running {true};
     std::atomic<bool> m_finished {false};
     std::mutex m_finish_mutex;
     std::condition_variable m_finish_cv;
+    std::mutex m_wait_mutex;
+    std::condition_variable m_wait_cv;
+    bool m_has_messages {false};
+    mutable std::mutex m_stats_mutex;
+    worker_pacing_stats m_pacing_stats;
     double m_accumulated_time {};
     double m_current_time {};
     double m_last_time {};
@@ -73,6 +73,7 @@ public:
 
     double get_simulation_timestamp() const { return m_sim_time; }
     double get_presentation_delay() const { return m_presentation_delay; }
+    worker_pacing_stats get_worker_pacing_stats() const { return m_worker.get_pacing_stats(); }
 
     template<typename Message, typename... Args>
     void send_message_to_worker(Args &&... args) {
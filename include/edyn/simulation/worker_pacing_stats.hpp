@@ -0,0 +1,57 @@
+#ifndef EDYN_SIMULATION_WORKER_PACING_STATS_HPP
+#define EDYN_SIMULATION_WORKER_PACING_STATS_HPP
+
+#include <cstdint>
+
+namespace edyn {
+
+/**
+ * @brief Measures how closely the simulation worker keeps to its update rate.
+ * Errors are in seconds and are positive when the worker woke up late. In
+ * `worker_pacing::pid` mode, the error is the difference between the measured
+ * update period and the fixed delta time.
+ */
+struct worker_pacing_stats {
+    // Error of the latest update.
+    double last_error {};
+    // Exponential moving average of the absolute error.
+    double average_error {};
+    // Largest absolute error so far.
+    double max_error {};
+    // Number of updates which were paced.
+    uint64_t num_updates {};
+    // Number of times the worker woke up before the deadline to process
+    // incoming messages.
+    uint64_t num_early_wakeups {};
+};
+
+/**
+ * @brief Adds the error of an update to the statistics.
+ * @param stats Statistics to be updated.
+ * @param error Pacing error in seconds.
+ */
+void record_pacing_error(worker_pacing_stats &stats, double error);
+
+/**
+ * @brief Calculates the deadline of the next update in
+ * `worker_pacing::deadline` mode.
+ * @param deadline Deadline of the current update.
+ * @param time Time when the current update started.
+ * @param fixed_dt Fixed delta time.
+ * @return The same deadline if the update started before it, i.e. it was
+ * triggered by a message. Otherwise, the deadline advanced by `fixed_dt`, or
+ * `fixed_dt` after `time` if that is still in the past.
+ */
+double next_pacing_deadline(double deadline, double time, double fixed_dt);
+
+/**
+ * @brief Spins until the given time is reached.
+ * @param deadline Time to wait for.
+ * @param time_func Function which returns the current time.
+ * @return Time when spinning ended.
+ */
+double spin_until(double deadline, double(*time_func)(void));
+
+}
+
+#endif // EDYN_SIMULATION_WORKER_PACING_STATS_HPP
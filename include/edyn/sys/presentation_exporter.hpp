@@ -0,0 +1,114 @@
+#ifndef EDYN_SYS_PRESENTATION_EXPORTER_HPP
+#define EDYN_SYS_PRESENTATION_EXPORTER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <entt/entity/fwd.hpp>
+#include <entt/entity/storage.hpp>
+#include "edyn/sys/update_presentation.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Maintains the presentation transforms of all rigid bodies which have
+ * presentation components in a dense array. Each body gets a slot when its
+ * presentation components are created and keeps it until they're destroyed,
+ * thus indices are stable and can be used to address instance data directly.
+ * Slots are updated in `update_presentation` and the ranges of slots that
+ * changed are recorded so only those have to be uploaded.
+ */
+class presentation_exporter {
+public:
+    /**
+     * @brief A range of slots `[begin, end)`.
+     */
+    struct range {
+        size_t begin;
+        size_t end;
+    };
+
+    presentation_exporter(entt::registry &);
+    ~presentation_exporter();
+
+    /**
+     * @brief Pointer to the first slot. The array holds `size()` elements.
+     * Vacant slots have a null entity.
+     */
+    const presentation_transform * data() const {
+        return m_transforms.data();
+    }
+
+    /**
+     * @brief Number of slots, including vacant ones.
+     */
+    size_t size() const {
+        return m_transforms.size();
+    }
+
+    bool contains(entt::entity entity) const {
+        return m_slots.contains(entity);
+    }
+
+    /**
+     * @brief Slot index of a body. The body must have presentation components.
+     */
+    size_t index_of(entt::entity entity) const {
+        return m_slots.get(entity);
+    }
+
+    /**
+     * @brief Sorted and non-overlapping ranges of slots which changed since
+     * the last call to `clear_dirty_ranges`.
+     */
+    const std::vector<range> & dirty_ranges() const {
+        return m_dirty_ranges;
+    }
+
+    /**
+     * @brief Call once the dirty slots have been consumed.
+     */
+    void clear_dirty_ranges() {
+        m_dirty_ranges.clear();
+    }
+
+    void assign(entt::entity entity, const vector3 &pos, const quaternion &orn) {
+        auto index = m_slots.get(entity);
+        m_transforms[index].position = pos;
+        m_transforms[index].orientation = orn;
+        mark_dirty(index);
+    }
+
+    /**
+     * @brief Fills in slots of new bodies and merges dirty ranges. Called
+     * after all bodies have been assigned in `update_presentation`.
+     */
+    void update();
+
+    void on_construct_present_position(entt::registry &, entt::entity);
+    void on_destroy_present_position(entt::registry &, entt::entity);
+
+private:
+    void mark_dirty(size_t index) {
+        // Consecutive bodies often have neighboring slots, in either order,
+        // thus growing the last range keeps the list short until it's merged
+        // in `update`.
+        if (!m_dirty_ranges.empty() && m_dirty_ranges.back().end == index) {
+            ++m_dirty_ranges.back().end;
+        } else if (!m_dirty_ranges.empty() && m_dirty_ranges.back().begin == index + 1) {
+            --m_dirty_ranges.back().begin;
+        } else {
+            m_dirty_ranges.push_back({index, index + 1});
+        }
+    }
+
+    entt::registry *m_registry;
+    std::vector<presentation_transform> m_transforms;
+    entt::storage<size_t> m_slots;
+    std::vector<size_t> m_free_slots;
+    std::vector<entt::entity> m_pending;
+    std::vector<range> m_dirty_ranges;
+};
+
+}
+
+#endif // EDYN_SYS_PRESENTATION_EXPORTER_HPP
@@ -1,12 +1,55 @@
 #ifndef EDYN_SYS_UPDATE_PRESENTATION_HPP
 #define EDYN_SYS_UPDATE_PRESENTATION_HPP
 
+#include <cstddef>
 #include <entt/entity/fwd.hpp>
+#include <entt/entity/entity.hpp>
+#include "edyn/math/vector3.hpp"
+#include "edyn/math/quaternion.hpp"
 
 namespace edyn {
 
+/**
+ * @brief Presentation transform of a rigid body laid out contiguously so an
+ * array of these can be uploaded as instance data.
+ */
+struct presentation_transform {
+    vector3 position;
+    quaternion orientation;
+    entt::entity entity {entt::null};
+};
+
+/**
+ * @brief Caller-provided destination for the presentation transforms which
+ * are calculated in a call to `update_presentation`.
+ */
+struct presentation_output {
+    // Pointer to an array with room for `capacity` elements.
+    presentation_transform *data {nullptr};
+    size_t capacity {0};
+    // Number of bodies updated in the last call. If greater than `capacity`,
+    // only the first `capacity` were written and the array must be enlarged.
+    size_t size {0};
+};
+
+/**
+ * @brief Extrapolates the presentation transforms of all awake dynamic rigid
+ * bodies. Sleeping, disabled, static and kinematic bodies are skipped since
+ * their presentation transforms do not change. Bodies are processed in fixed
+ * size batches in a structure-of-arrays layout.
+ * @param registry Data source.
+ * @param sim_time Timestamp of the current simulation state.
+ * @param current_time Current time.
+ * @param delta_time Time elapsed since the last update.
+ * @param presentation_delay How far behind the current time the presentation
+ * transforms should be.
+ * @param output Optional destination where the presentation transforms of all
+ * updated bodies are also written to, in view order. If null, the output set
+ * with `edyn::set_presentation_output` is used, if any.
+ */
 void update_presentation(entt::registry &registry, double sim_time, double current_time,
-                         double delta_time, double presentation_delay);
+                         double delta_time, double presentation_delay,
+                         presentation_output *output = nullptr);
 
 void snap_presentation(entt::registry &registry);
 
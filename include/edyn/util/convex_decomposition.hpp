@@ -0,0 +1,78 @@
+#ifndef EDYN_UTIL_CONVEX_DECOMPOSITION_HPP
+#define EDYN_UTIL_CONVEX_DECOMPOSITION_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "edyn/math/vector3.hpp"
+#include "edyn/context/task.hpp"
+#include "edyn/shapes/compound_shape.hpp"
+
+namespace edyn {
+
+class triangle_mesh;
+struct obj_mesh;
+
+/**
+ * @brief Parameters of an approximate convex decomposition.
+ */
+struct convex_decomposition_settings {
+    // Approximate number of voxels in the bounding box of the mesh. Higher
+    // values capture finer details at the expense of memory and time.
+    size_t resolution {100000};
+
+    // Maximum number of convex pieces in the resulting compound.
+    size_t max_hulls {32};
+
+    // Pieces are split until the volume of their convex hull which is not
+    // occupied by the mesh, relative to the total volume of the mesh, falls
+    // below this value.
+    scalar max_concavity {scalar(0.01)};
+
+    // Maximum number of vertices in the convex hull of each piece.
+    size_t max_hull_vertices {64};
+
+    // Number of candidate split planes evaluated along each axis.
+    size_t num_split_planes {8};
+
+    // If not empty, the decomposition is loaded from this file if it was
+    // created from the same mesh and settings. Otherwise, or if the file is
+    // truncated or corrupted, it is computed and written to this file.
+    std::string cache_path;
+};
+
+/**
+ * @brief Approximates a closed triangle mesh by a compound of convex
+ * polyhedrons. The interior of the mesh is voxelized and recursively split by
+ * axis-aligned planes until each piece is close enough to its convex hull or
+ * the maximum number of pieces is reached.
+ * @remark The convex hulls are built from voxel corners thus their surfaces
+ * can deviate from the mesh by up to the size of a voxel.
+ * @param vertices Vertex positions.
+ * @param indices Three vertex indices per triangle.
+ * @param settings Decomposition parameters.
+ * @param enqueue_task_wait Optional function used to evaluate split planes
+ * and build convex hulls in parallel, e.g. `get_enqueue_task_wait(registry)`.
+ * @return A compound shape with polyhedrons positioned at their centroids, or
+ * an empty compound if the mesh has no interior.
+ */
+compound_shape decompose_convex(const std::vector<vector3> &vertices,
+                                const std::vector<uint32_t> &indices,
+                                const convex_decomposition_settings &settings = {},
+                                enqueue_task_wait_t *enqueue_task_wait = nullptr);
+
+compound_shape decompose_convex(const triangle_mesh &mesh,
+                                const convex_decomposition_settings &settings = {},
+                                enqueue_task_wait_t *enqueue_task_wait = nullptr);
+
+/**
+ * @brief Decomposes a mesh loaded with `load_meshes_from_obj`. Polygonal
+ * faces are triangulated as fans.
+ */
+compound_shape decompose_convex(const obj_mesh &mesh,
+                                const convex_decomposition_settings &settings = {},
+                                enqueue_task_wait_t *enqueue_task_wait = nullptr);
+
+}
+
+#endif // EDYN_UTIL_CONVEX_DECOMPOSITION_HPP
@@ -0,0 +1,40 @@
+#ifndef EDYN_UTIL_CONVEX_HULL_HPP
+#define EDYN_UTIL_CONVEX_HULL_HPP
+
+#include <vector>
+#include <cstdint>
+#include "edyn/math/vector3.hpp"
+#include "edyn/context/task.hpp"
+
+namespace edyn {
+
+/**
+ * @brief Builds a convex polyhedron enclosing a point cloud using the
+ * quickhull algorithm. Coplanar triangles are merged into polygonal faces.
+ * The output can be assigned to a `convex_mesh`, after which
+ * `convex_mesh::initialize` must be called, which will shift the vertices
+ * so that the centroid is located at the origin.
+ * @param points A point cloud with at least 4 non-coplanar points.
+ * @param vertices Fills it with the hull vertices.
+ * @param indices Fills it with sequences of vertex indices for each face,
+ * in counter-clockwise order when viewed from outside.
+ * @param faces Fills it with [first index, count] pairs.
+ * @param max_vertices Maximum number of vertices in the hull. If the hull
+ * would have more vertices, it's simplified by stopping once this number is
+ * reached, which gives a hull that contains the points furthest away from
+ * the interior but might not enclose all points. Zero means unlimited.
+ * @param enqueue_task_wait Optional function used to build partial hulls of
+ * large point clouds in parallel.
+ * @return Whether a hull could be built. Fails if the points are collinear or
+ * coplanar.
+ */
+bool make_convex_hull_mesh(const std::vector<vector3> &points,
+                           std::vector<vector3> &vertices,
+                           std::vector<uint32_t> &indices,
+                           std::vector<uint32_t> &faces,
+                           size_t max_vertices = 0,
+                           enqueue_task_wait_t *enqueue_task_wait = nullptr);
+
+}
+
+#endif // EDYN_UTIL_CONVEX_HULL_HPP
@@ -5,12 +5,15 @@
 #include "edyn/math/vector3.hpp"
 #include "edyn/shapes/compound_shape.hpp"
 #include "edyn/shapes/polyhedron_shape.hpp"
+#include "edyn/context/task.hpp"
 #include <vector>
 #include <cstdint>
 #include <string>
 
 namespace edyn {
 
+class triangle_mesh;
+
 struct obj_mesh {
     std::string name;
     std::vector<vector3> vertices;
@@ -22,18 +25,23 @@ struct obj_mesh {
 /**
  * @brief Loads meshes from a *.obj file.
  * Scale, rotation and translation are applied to all vertices in this order.
+ * @remark The file is mapped into memory and large files are split into
+ * chunks which are parsed in parallel if `enqueue_task_wait` is provided.
  * @param path Path to file.
  * @param meshes Array to be filled with meshes.
  * @param pos Position offset to add to vertices.
  * @param orn Orientation to rotate vertices.
  * @param scale Scaling to be applied to all vertices.
+ * @param enqueue_task_wait Optional function used to parse chunks of the file
+ * in parallel, e.g. `get_enqueue_task_wait(registry)`.
  * @return Success or failure.
  */
 bool load_meshes_from_obj(const std::string &path,
                           std::vector<obj_mesh> &meshes,
                           vector3 pos = vector3_zero,
                           quaternion orn = quaternion_identity,
-                          vector3 scale = vector3_one);
+                          vector3 scale = vector3_one,
+                          enqueue_task_wait_t *enqueue_task_wait = nullptr);
 
 void load_meshes_from_obj(std::stringstream &ss,
                           std::vector<obj_mesh> &meshes,
@@ -42,8 +50,8 @@ void load_meshes_from_obj(std::stringstream &ss,
                           vector3 scale = vector3_one);
 
 /**
- * @brief Loads a triangle mesh from a *.obj file which must've been
- * triangulated during export.
+ * @brief Loads a triangle mesh from a *.obj file. Polygonal faces are
+ * triangulated as fans.
  * @param path Path to file.
  * @param vertices Array to be filled with vertices.
  * @param indices Array to be filled with indices for each triangle.
@@ -51,6 +59,8 @@ void load_meshes_from_obj(std::stringstream &ss,
  * @param pos Position offset to add to vertices.
  * @param orn Orientation to rotate vertices.
  * @param scale Scaling to be applied to all vertices.
+ * @param enqueue_task_wait Optional function used to parse chunks of the file
+ * in parallel.
  * @return Success or failure.
  */
 bool load_tri_mesh_from_obj(const std::string &path,
@@ -59,7 +69,8 @@ bool load_tri_mesh_from_obj(const std::string &path,
                             std::vector<vector3> *colors = nullptr,
                             vector3 pos = vector3_zero,
                             quaternion orn = quaternion_identity,
-                            vector3 scale = vector3_one);
+                            vector3 scale = vector3_one,
+                            enqueue_task_wait_t *enqueue_task_wait = nullptr);
 
 void load_tri_mesh_from_obj(std::stringstream &ss,
                             std::vector<vector3> &vertices,
@@ -119,6 +130,44 @@ compound_shape load_compound_shape_from_obj(
     const quaternion &orn = quaternion_identity,
     const vector3 &scale = vector3_one);
 
+/**
+ * @brief Writes a mesh in a compact binary format which consists of a small
+ * header followed by the raw vertex, index and face arrays. It can be loaded
+ * much faster than an obj file since no parsing is involved.
+ * @remark The data is written in the native byte order and scalar precision.
+ * @param path File path.
+ * @param vertices Vertex positions.
+ * @param indices Vertex indices of each face.
+ * @param faces Pairs of first index and number of vertices of each face. Can
+ * be empty for triangle meshes.
+ * @return Success or failure.
+ */
+bool write_mesh_to_binary(const std::string &path,
+                          const std::vector<vector3> &vertices,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &faces = {});
+
+/**
+ * @brief Loads a triangle mesh from a file created with `write_mesh_to_binary`.
+ * The file is mapped into memory and the arrays are inserted directly into
+ * the mesh, which is then initialized.
+ * @param path File path.
+ * @param mesh An empty triangle mesh.
+ * @return Success or failure. Fails if the file is not a valid binary mesh,
+ * if it was written with a different scalar precision or if it has
+ * non-triangular faces.
+ */
+bool load_triangle_mesh_from_binary(const std::string &path, triangle_mesh &mesh);
+
+/**
+ * @brief Loads a convex mesh from a file created with `write_mesh_to_binary`
+ * and initializes it.
+ * @param path File path.
+ * @param mesh Convex mesh to be assigned.
+ * @return Success or failure.
+ */
+bool load_convex_mesh_from_binary(const std::string &path, convex_mesh &mesh);
+
 }
 
 #endif // EDYN_UTIL_SHAPE_IO_HPP
@@ -127,6 +127,39 @@ scalar polyhedron_support_projection(const std::vector<vector3> &vertices,
                                      const std::vector<uint32_t> &neighbor_indices,
                                      const vector3 &dir);
 
+/**
+ * @brief Calculates the maximum projection of all vertices along the given
+ * direction, starting the search at the given vertex. When called for a
+ * sequence of similar directions, passing the support vertex of the previous
+ * call as the starting point reduces the number of vertices visited.
+ * @param vertices Vertices of a convex polyhedron.
+ * @param neighbors_start See `convex_mesh:neighbors_start`.
+ * @param neighbor_indices See `convex_mesh:neighbors_start`.
+ * @param dir A direction vector (non-zero).
+ * @param vertex_idx Index of the vertex where the search starts. Set to the
+ * index of the support vertex on return.
+ * @return The maximal projection.
+ */
+scalar polyhedron_support_projection(const std::vector<vector3> &vertices,
+                                     const std::vector<uint32_t> &neighbors_start,
+                                     const std::vector<uint32_t> &neighbor_indices,
+                                     const vector3 &dir, uint32_t &vertex_idx);
+
+/**
+ * @brief Finds the index of a vertex that's furthest along the given
+ * direction by hill-climbing over the vertex adjacency graph.
+ * @param vertices Vertices of a convex polyhedron.
+ * @param neighbors_start See `convex_mesh:neighbors_start`.
+ * @param neighbor_indices See `convex_mesh:neighbors_start`.
+ * @param dir A direction vector (non-zero).
+ * @param start_idx Index of the vertex where the search starts.
+ * @return Index of the support vertex.
+ */
+uint32_t polyhedron_support_vertex(const std::vector<vector3> &vertices,
+                                   const std::vector<uint32_t> &neighbors_start,
+                                   const std::vector<uint32_t> &neighbor_indices,
+                                   const vector3 &dir, uint32_t start_idx = 0);
+
 /**
  * @brief Calculates the maximum projection of all points along the given
  * direction.
@@ -398,6 +431,18 @@ struct collision_feature;
 size_t get_triangle_mesh_feature_index(const triangle_mesh &mesh, size_t tri_idx,
                                        triangle_feature tri_feature, size_t tri_feature_idx);
 
+/**
+ * @brief Get a triangle mesh feature index from the local index of a feature
+ * of a packed triangle.
+ * @param tri Packed triangle.
+ * @param tri_idx Index of the packed triangle in the mesh.
+ * @param tri_feature Triangle feature.
+ * @param tri_feature_index Index of triangle feature.
+ * @return Index of feature in the triangle mesh.
+ */
+size_t get_triangle_mesh_feature_index(const packed_triangle &tri, size_t tri_idx,
+                                       triangle_feature tri_feature, size_t tri_feature_idx);
+
 }
 
 #endif // EDYN_UTIL_SHAPE_UTIL_HPP
@@ -16,6 +16,8 @@
 #include "edyn/util/island_util.hpp"
 #include <entt/entity/registry.hpp>
 #include <entt/signal/delegate.hpp>
+#include <algorithm>
+#include <tuple>
 
 namespace edyn {
 
@@ -179,9 +181,12 @@ void broadphase::update(bool mt) {
 
     // Search for new AABB intersections and create manifolds.
     auto aabb_proc_view = m_registry->view<AABB, procedural_tag>(exclude_sleeping_disabled);
+    auto deterministic = m_registry->ctx().get<settings>().deterministic;
 
-    if (mt && calculate_view_size(aabb_proc_view) > m_max_sequential_size) {
-        collide_parallel();
+    if (deterministic || (mt && calculate_view_size(aabb_proc_view) > m_max_sequential_size)) {
+        // In deterministic mode, always gather pairs first and create
+        // manifolds later so the result doesn't depend on which path is taken.
+        collide_parallel(mt && calculate_view_size(aabb_proc_view) > m_max_sequential_size);
         finish_collide();
     } else {
         for (auto [entity, aabb] : aabb_proc_view.each()) {
@@ -207,18 +212,54 @@ void broadphase::collide_parallel_task(unsigned start, unsigned end) {
     }
 }
 
-void broadphase::collide_parallel() {
+void broadphase::collide_parallel(bool mt) {
     auto aabb_proc_view = m_registry->view<AABB, procedural_tag>(exclude_sleeping_disabled);
     auto aabb_proc_size = calculate_view_size(aabb_proc_view);
     m_pair_results.resize(aabb_proc_size);
 
-    auto task = task_delegate_t(entt::connect_arg_t<&broadphase::collide_parallel_task>{}, *this);
-    enqueue_task_wait(*m_registry, task, aabb_proc_size);
+    if (mt) {
+        auto task = task_delegate_t(entt::connect_arg_t<&broadphase::collide_parallel_task>{}, *this);
+        enqueue_task_wait(*m_registry, task, aabb_proc_size);
+    } else {
+        collide_parallel_task(0, aabb_proc_size);
+    }
 }
 
 void broadphase::finish_collide() {
     auto &manifold_map = m_registry->ctx().get<contact_manifold_map>();
 
+    if (m_registry->ctx().get<settings>().deterministic) {
+        // Create manifolds in order of entity identifiers instead of in the
+        // order procedural bodies happen to be stored in their pools.
+        auto pairs = entity_pair_vector{};
+
+        for (auto &results : m_pair_results) {
+            pairs.insert(pairs.end(), results.begin(), results.end());
+            results.clear();
+        }
+
+        // Pairs of two procedural bodies are found twice, once from each
+        // side. Sorting by the unordered pair first places both next to each
+        // other and the one with the lowest first entity wins.
+        auto key = [](const entity_pair &pair) {
+            auto a = entt::to_integral(pair.first);
+            auto b = entt::to_integral(pair.second);
+            return std::make_tuple(std::min(a, b), std::max(a, b), a);
+        };
+
+        std::sort(pairs.begin(), pairs.end(), [&key](auto &lhs, auto &rhs) {
+            return key(lhs) < key(rhs);
+        });
+
+        for (auto &pair : pairs) {
+            if (!manifold_map.contains(pair.first, pair.second)) {
+                make_contact_manifold(*m_registry, pair.first, pair.second, m_separation_threshold);
+            }
+        }
+
+        return;
+    }
+
     for (auto &pairs : m_pair_results) {
         for (auto &pair : pairs) {
             if (!manifold_map.contains(pair.first, pair.second)) {
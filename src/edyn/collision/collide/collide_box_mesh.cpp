@@ -12,14 +12,14 @@
 namespace edyn {
 
 static void collide_box_triangle(
-    const box_shape &box, const triangle_mesh &mesh, size_t tri_idx,
+    const box_shape &box, scalar thickness, size_t tri_idx, const packed_triangle &tri,
     const std::array<vector3, 3> &box_axes,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
+    const auto &tri_vertices = tri.vertices;
+    const auto &tri_normal = tri.normal;
     const auto tri_center = average(tri_vertices);
 
     auto distance = -EDYN_SCALAR_MAX;
@@ -60,6 +60,12 @@ static void collide_box_triangle(
         }
     }
 
+    // The remaining axes can only increase the distance, thus skip the more
+    // expensive edge tests if the face axes already separate the shapes.
+    if (distance > ctx.threshold) {
+        return;
+    }
+
     // Edges.
     for (size_t i = 0; i < 3; ++i) {
         auto &axisA = box_axes[i];
@@ -100,9 +106,7 @@ static void collide_box_triangle(
                                  proj_tri, support_feature_tolerance);
 
     // Adjust separating axis to keep in the closest feature's Voronoi region.
-    auto new_sep_axis = clip_triangle_separating_axis(sep_axis, mesh, tri_idx,
-                                                      tri_vertices, tri_normal,
-                                                      tri_feature, tri_feature_index);
+    auto new_sep_axis = clip_triangle_separating_axis(sep_axis, tri, tri_feature, tri_feature_index);
 
     if (new_sep_axis != sep_axis) {
         sep_axis = new_sep_axis;
@@ -124,7 +128,7 @@ static void collide_box_triangle(
         return;
     }
 
-    if (-distance > mesh.get_thickness()) {
+    if (-distance > thickness) {
         return;
     }
 
@@ -133,7 +137,7 @@ static void collide_box_triangle(
     point.distance = distance;
     point.featureA = {box_feature, box_feature_index};
     point.featureB = {tri_feature};
-    point.featureB->index = get_triangle_mesh_feature_index(mesh, tri_idx, tri_feature, tri_feature_index);
+    point.featureB->index = get_triangle_mesh_feature_index(tri, tri_idx, tri_feature, tri_feature_index);
 
     if (box_feature == box_feature::face && tri_feature == triangle_feature::face) {
         auto normalA = box.get_face_normal(box_feature_index, ornA);
@@ -222,7 +226,7 @@ static void collide_box_triangle(
             }
         }
     } else if (box_feature == box_feature::face && tri_feature == triangle_feature::edge) {
-        EDYN_ASSERT(mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, tri_feature_index)));
+        EDYN_ASSERT(tri.is_convex_edge(tri_feature_index));
 
         auto normalA = box.get_face_normal(box_feature_index, ornA);
         auto verticesA_local = box.get_face(box_feature_index);
@@ -339,7 +343,7 @@ static void collide_box_triangle(
             }
         }
     } else if (box_feature == box_feature::edge && tri_feature == triangle_feature::edge) {
-        EDYN_ASSERT(mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, tri_feature_index)));
+        EDYN_ASSERT(tri.is_convex_edge(tri_feature_index));
 
         auto edgeA_local = box.get_edge(box_feature_index);
         vector3 edgeA[] = {
@@ -393,8 +397,9 @@ static void collide_box_triangle(
     }
 }
 
-void collide(const box_shape &box, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_box_triangles(const box_shape &box, TriangleSource &source,
+                                  const collision_context &ctx, collision_result &result) {
     const auto box_axes = std::array<vector3, 3> {
         quaternion_x(ctx.ornA),
         quaternion_y(ctx.ornA),
@@ -404,9 +409,21 @@ void collide(const box_shape &box, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&](auto tri_idx) {
-        collide_box_triangle(box, mesh, tri_idx, box_axes, ctx, result);
+    const auto thickness = source.get_thickness();
+
+    source.visit_packed_triangles(visit_aabb, ctx.aabbA, ctx.threshold, [&](auto tri_idx, auto &tri) {
+        collide_box_triangle(box, thickness, tri_idx, tri, box_axes, ctx, result);
     });
 }
 
+void collide(const box_shape &box, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_box_triangles(box, mesh, ctx, result);
+}
+
+void collide(const box_shape &box, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_box_triangles(box, *shape.field, ctx, result);
+}
+
 }
@@ -8,14 +8,14 @@
 namespace edyn {
 
 static void collide_capsule_triangle(
-    const capsule_shape &capsule, const triangle_mesh &mesh, size_t tri_idx,
+    const capsule_shape &capsule, scalar thickness, size_t tri_idx, const packed_triangle &tri,
     const std::array<vector3, 2> &capsule_vertices,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
+    const auto &tri_vertices = tri.vertices;
+    const auto &tri_normal = tri.normal;
     const auto tri_center = average(tri_vertices);
 
     auto sep_axis = vector3_zero;
@@ -30,6 +30,11 @@ static void collide_capsule_triangle(
         sep_axis = dir;
     }
 
+    // Capsule lies in front of the triangle plane.
+    if (distance > ctx.threshold) {
+        return;
+    }
+
     // Triangle edges vs capsule edge.
     for (size_t i = 0; i < 3; ++i) {
         auto &v0 = tri_vertices[i];
@@ -82,7 +87,7 @@ static void collide_capsule_triangle(
                                  tri_feature, tri_feature_index,
                                  proj_tri, support_feature_tolerance);
 
-    sep_axis = clip_triangle_separating_axis(sep_axis, mesh, tri_idx, tri_vertices, tri_normal, tri_feature, tri_feature_index);
+    sep_axis = clip_triangle_separating_axis(sep_axis, tri, tri_feature, tri_feature_index);
 
     get_triangle_support_feature(tri_vertices, vector3_zero, sep_axis,
                                  tri_feature, tri_feature_index,
@@ -96,7 +101,7 @@ static void collide_capsule_triangle(
         return;
     }
 
-    if (-distance > mesh.get_thickness()) {
+    if (-distance > thickness) {
         return;
     }
 
@@ -122,7 +127,7 @@ static void collide_capsule_triangle(
     point.distance = distance;
     point.featureA = {featureA, feature_indexA};
     point.featureB = {tri_feature};
-    point.featureB->index = get_triangle_mesh_feature_index(mesh, tri_idx, tri_feature, tri_feature_index);
+    point.featureB->index = get_triangle_mesh_feature_index(tri, tri_idx, tri_feature, tri_feature_index);
 
     switch (tri_feature) {
     case triangle_feature::face: {
@@ -156,7 +161,7 @@ static void collide_capsule_triangle(
 
             for (int i = 0; i < 3; ++i) {
                 // Ignore concave edges.
-                if (!mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, i))) {
+                if (!tri.is_convex_edge(i)) {
                     continue;
                 }
 
@@ -250,8 +255,9 @@ static void collide_capsule_triangle(
     }
 }
 
-void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_capsule_triangles(const capsule_shape &capsule, TriangleSource &source,
+                                      const collision_context &ctx, collision_result &result) {
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
     const auto capsule_vertices = capsule.get_vertices(posA, ornA);
@@ -259,9 +265,21 @@ void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&](auto tri_idx) {
-        collide_capsule_triangle(capsule, mesh, tri_idx, capsule_vertices, ctx, result);
+    const auto thickness = source.get_thickness();
+
+    source.visit_packed_triangles(visit_aabb, ctx.aabbA, ctx.threshold, [&](auto tri_idx, auto &tri) {
+        collide_capsule_triangle(capsule, thickness, tri_idx, tri, capsule_vertices, ctx, result);
     });
 }
 
+void collide(const capsule_shape &capsule, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_capsule_triangles(capsule, mesh, ctx, result);
+}
+
+void collide(const capsule_shape &capsule, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_capsule_triangles(capsule, *shape.field, ctx, result);
+}
+
 }
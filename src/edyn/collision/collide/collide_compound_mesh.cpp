@@ -5,8 +5,9 @@
 
 namespace edyn {
 
-void collide(const compound_shape &compound, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_compound_triangles(const compound_shape &compound, const TriangleSource &source,
+                                       const collision_context &ctx, collision_result &result) {
     // TODO Possible optimization: find the triangle mesh node which encompasses
     // the compound's AABB and start the tree queries from that node in the
     // child collision tests.
@@ -23,7 +24,7 @@ void collide(const compound_shape &compound, const triangle_mesh &mesh,
         collision_result child_result;
 
         std::visit([&](auto &&sh) {
-            collide(sh, mesh, child_ctx, child_result);
+            collide(sh, source, child_ctx, child_result);
         }, node.shape_var);
 
         // The elements of A in the collision points must be transformed from
@@ -44,4 +45,14 @@ void collide(const compound_shape &compound, const triangle_mesh &mesh,
     }
 }
 
+void collide(const compound_shape &compound, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_compound_triangles(compound, mesh, ctx, result);
+}
+
+void collide(const compound_shape &compound, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_compound_triangles(compound, shape, ctx, result);
+}
+
 }
@@ -15,14 +15,14 @@
 namespace edyn {
 
 void collide_cylinder_triangle(
-    const cylinder_shape &cylinder, const triangle_mesh &mesh, size_t tri_idx,
+    const cylinder_shape &cylinder, scalar thickness, size_t tri_idx, const packed_triangle &tri,
     const vector3 &cylinder_axis, const std::array<vector3, 2> &cylinder_vertices,
     const collision_context &ctx, collision_result &result) {
 
     const auto &posA = ctx.posA;
     const auto &ornA = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
+    const auto &tri_vertices = tri.vertices;
+    const auto &tri_normal = tri.normal;
     const auto tri_center = average(tri_vertices);
 
     auto distance = -EDYN_SCALAR_MAX;
@@ -66,6 +66,11 @@ void collide_cylinder_triangle(
         }
     }
 
+    // Skip edge tests if the face normals are already separating axes.
+    if (distance > ctx.threshold) {
+        return;
+    }
+
     // Cylinder side edge vs Triangle edges.
     for (size_t i = 0; i < 3; ++i) {
         auto j = (i + 1) % 3;
@@ -85,6 +90,10 @@ void collide_cylinder_triangle(
         test_direction(dir);
     }
 
+    if (distance > ctx.threshold) {
+        return;
+    }
+
     // Cylinder cap vs Triangle edges.
     for (size_t i = 0; i < 2; ++i) {
         auto circle_pos = cylinder_vertices[i];
@@ -123,7 +132,7 @@ void collide_cylinder_triangle(
                                  tri_feature, tri_feature_index,
                                  proj_tri, support_feature_tolerance);
 
-    sep_axis = clip_triangle_separating_axis(sep_axis, mesh, tri_idx, tri_vertices, tri_normal, tri_feature, tri_feature_index);
+    sep_axis = clip_triangle_separating_axis(sep_axis, tri, tri_feature, tri_feature_index);
 
     get_triangle_support_feature(tri_vertices, vector3_zero, sep_axis,
                                  tri_feature, tri_feature_index,
@@ -137,7 +146,7 @@ void collide_cylinder_triangle(
         return;
     }
 
-    if (-distance > mesh.get_thickness()) {
+    if (-distance > thickness) {
         return;
     }
 
@@ -151,7 +160,7 @@ void collide_cylinder_triangle(
     point.distance = distance;
     point.featureA = {cyl_feature, cyl_feature_index};
     point.featureB = {tri_feature};
-    point.featureB->index = get_triangle_mesh_feature_index(mesh, tri_idx, tri_feature, tri_feature_index);
+    point.featureB->index = get_triangle_mesh_feature_index(tri, tri_idx, tri_feature, tri_feature_index);
 
     // Index of vector element in cylinder object space that represents the
     // cylinder axis.
@@ -208,7 +217,7 @@ void collide_cylinder_triangle(
         // Check if circle and triangle edges intersect.
         for (int i = 0; i < 3; ++i) {
             // Ignore concave edges.
-            if (!mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, i))) {
+            if (!tri.is_convex_edge(i)) {
                 continue;
             }
 
@@ -239,7 +248,7 @@ void collide_cylinder_triangle(
             }
         }
     } else if (cyl_feature == cylinder_feature::face && tri_feature == triangle_feature::edge) {
-        EDYN_ASSERT(mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, tri_feature_index)));
+        EDYN_ASSERT(tri.is_convex_edge(tri_feature_index));
 
         vector3 edge_vertices[] = {tri_vertices[tri_feature_index],
                                    tri_vertices[(tri_feature_index + 1) % 3]};
@@ -317,7 +326,7 @@ void collide_cylinder_triangle(
 
         for (int i = 0; i < 3; ++i) {
             // Ignore concave edges.
-            if (!mesh.is_convex_edge(mesh.get_face_edge_index(tri_idx, i))) {
+            if (!tri.is_convex_edge(i)) {
                 continue;
             }
 
@@ -422,8 +431,9 @@ void collide_cylinder_triangle(
     }
 }
 
-void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_cylinder_triangles(const cylinder_shape &cylinder, TriangleSource &source,
+                                       const collision_context &ctx, collision_result &result) {
     const auto cylinder_axis = coordinate_axis_vector(cylinder.axis, ctx.ornA);
     const auto cylinder_vertices = std::array<vector3, 2>{
         ctx.posA + cylinder_axis * cylinder.half_length,
@@ -433,10 +443,22 @@ void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&](auto tri_idx) {
-        collide_cylinder_triangle(cylinder, mesh, tri_idx,
+    const auto thickness = source.get_thickness();
+
+    source.visit_packed_triangles(visit_aabb, ctx.aabbA, ctx.threshold, [&](auto tri_idx, auto &tri) {
+        collide_cylinder_triangle(cylinder, thickness, tri_idx, tri,
                                   cylinder_axis, cylinder_vertices, ctx, result);
     });
 }
 
+void collide(const cylinder_shape &cylinder, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_cylinder_triangles(cylinder, mesh, ctx, result);
+}
+
+void collide(const cylinder_shape &cylinder, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_cylinder_triangles(cylinder, *shape.field, ctx, result);
+}
+
 }
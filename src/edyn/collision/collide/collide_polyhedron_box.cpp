@@ -20,6 +20,9 @@ void collide(const polyhedron_shape &shA, const box_shape &shB,
     const auto threshold = ctx.threshold;
     const auto &meshA = *shA.mesh;
 
+    // Starting vertex for hill-climbing support queries on A.
+    uint32_t support_vertex_idx = 0;
+
     const auto box_axes = std::array<vector3, 3>{
         quaternion_x(ornB),
         quaternion_y(ornB),
@@ -58,7 +61,7 @@ void collide(const polyhedron_shape &shA, const box_shape &shB,
 
         // Find point on polyhedron that's furthest along the opposite direction
         // of the box face normal.
-        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
         auto projB = dot(posB, dir) + shB.half_extents[i];
         auto dist = projA - projB;
 
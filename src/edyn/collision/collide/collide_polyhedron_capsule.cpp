@@ -16,6 +16,9 @@ void collide(const polyhedron_shape &shA, const capsule_shape &shB,
     auto threshold = ctx.threshold;
     auto &meshA = *shA.mesh;
 
+    // Starting vertex for hill-climbing support queries on A.
+    uint32_t support_vertex_idx = 0;
+
     auto capsule_vertices = shB.get_vertices(posB, ornB);
 
     scalar distance = -EDYN_SCALAR_MAX;
@@ -57,7 +60,7 @@ void collide(const polyhedron_shape &shA, const capsule_shape &shB,
             dir *= -1;
         }
 
-        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
         auto projB = capsule_support_projection(capsule_vertices, shB.radius, dir);
         auto dist = projA - projB;
 
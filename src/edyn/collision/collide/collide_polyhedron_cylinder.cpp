@@ -19,6 +19,9 @@ void collide(const polyhedron_shape &shA, const cylinder_shape &shB,
     const auto threshold = ctx.threshold;
     const auto &meshA = *shA.mesh;
 
+    // The support vertex of each query is where the next one starts.
+    uint32_t support_vertex_idx = 0;
+
     const auto cyl_axis = coordinate_axis_vector(shB.axis, ornB);
     const auto face_center_pos = posB + cyl_axis * shB.half_length;
     const auto face_center_neg = posB - cyl_axis * shB.half_length;
@@ -48,7 +51,7 @@ void collide(const polyhedron_shape &shA, const cylinder_shape &shB,
     // Cylinder cap face normals.
     for (size_t i = 0; i < 2; ++i) {
         auto dir = std::array<vector3, 2>{cyl_axis, -cyl_axis}[i];
-        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
         auto projB = dot(posB, dir) + shB.half_length;
         auto dist = projA - projB;
 
@@ -73,7 +76,7 @@ void collide(const polyhedron_shape &shA, const cylinder_shape &shB,
             dir *= -1;
         }
 
-        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
         auto projB = shB.support_projection(posB, ornB, dir);
         auto dist = projA - projB;
 
@@ -99,7 +102,7 @@ void collide(const polyhedron_shape &shA, const cylinder_shape &shB,
             dir *= -1;
         }
 
-        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+        auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
         auto projB = shB.support_projection(posB, ornB, dir);
         auto dist = projA - projB;
 
@@ -138,7 +141,7 @@ void collide(const polyhedron_shape &shA, const cylinder_shape &shB,
                 dir *= -1;
             }
 
-            auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir);
+            auto projA = -polyhedron_support_projection(meshA.vertices, meshA.neighbors_start, meshA.neighbor_indices, -dir, support_vertex_idx);
             auto projB = shB.support_projection(posB, ornB, dir);
             auto dist = projA - projB;
 
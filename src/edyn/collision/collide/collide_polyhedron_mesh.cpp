@@ -11,8 +11,8 @@
 namespace edyn {
 
 static void collide_polyhedron_triangle(
-    const polyhedron_shape &poly, const triangle_mesh &tri_mesh, size_t tri_idx,
-    const collision_context &ctx, collision_result &result) {
+    const polyhedron_shape &poly, scalar thickness, size_t tri_idx, const packed_triangle &tri,
+    const collision_context &ctx, collision_result &result, uint32_t &support_vertex_idx) {
 
     // The triangle vertices are shifted by the polyhedron's position so all
     // calculations are effectively done with the polyhedron in the origin.
@@ -22,8 +22,8 @@ static void collide_polyhedron_triangle(
     const auto &rmesh = *poly.rotated;
     const auto &poly_mesh = *poly.mesh;
 
-    auto tri_vertices_original = tri_mesh.get_triangle_vertices(tri_idx);
-    auto tri_normal = tri_mesh.get_triangle_normal(tri_idx);
+    const auto &tri_vertices_original = tri.vertices;
+    const auto &tri_normal = tri.normal;
 
     // Shift vertices into A's positional object space.
     auto tri_vertices = tri_vertices_original;
@@ -57,7 +57,7 @@ static void collide_polyhedron_triangle(
     {
         // Find point on polyhedron that's furthest along the opposite direction
         // of the triangle normal.
-        auto proj_poly = -polyhedron_support_projection(rmesh.vertices, poly_mesh.neighbors_start, poly_mesh.neighbor_indices, -tri_normal);
+        auto proj_poly = -polyhedron_support_projection(rmesh.vertices, poly_mesh.neighbors_start, poly_mesh.neighbor_indices, -tri_normal, support_vertex_idx);
         auto proj_tri = dot(tri_vertices[0], tri_normal);
         auto dist = proj_poly - proj_tri;
 
@@ -69,6 +69,12 @@ static void collide_polyhedron_triangle(
         }
     }
 
+    // Face normals separate the shapes. Edge axes would only increase the
+    // distance, which is not worth iterating over all polyhedron edges.
+    if (distance > ctx.threshold) {
+        return;
+    }
+
     // Edge vs edge.
     scalar min_edge_dist = -EDYN_SCALAR_MAX;
     scalar edge_projection_poly, edge_projection_tri;
@@ -132,13 +138,13 @@ static void collide_polyhedron_triangle(
                                  tri_feature, tri_feature_index,
                                  proj_tri, support_feature_tolerance);
 
-    sep_axis = clip_triangle_separating_axis(sep_axis, tri_mesh, tri_idx, tri_vertices, tri_normal, tri_feature, tri_feature_index);
+    sep_axis = clip_triangle_separating_axis(sep_axis, tri, tri_feature, tri_feature_index);
 
     get_triangle_support_feature(tri_vertices, vector3_zero, sep_axis,
                                  tri_feature, tri_feature_index,
                                  proj_tri, support_feature_tolerance);
 
-    projection_poly = -polyhedron_support_projection(rmesh.vertices, poly_mesh.neighbors_start, poly_mesh.neighbor_indices, -sep_axis);
+    projection_poly = -polyhedron_support_projection(rmesh.vertices, poly_mesh.neighbors_start, poly_mesh.neighbor_indices, -sep_axis, support_vertex_idx);
 
     distance = projection_poly - proj_tri;
 
@@ -146,7 +152,7 @@ static void collide_polyhedron_triangle(
         return;
     }
 
-    if (-distance > tri_mesh.get_thickness()) {
+    if (-distance > thickness) {
         return;
     }
 
@@ -185,7 +191,7 @@ static void collide_polyhedron_triangle(
     point.normal = sep_axis;
     point.distance = distance;
     point.featureB = {tri_feature};
-    point.featureB->index = get_triangle_mesh_feature_index(tri_mesh, tri_idx, tri_feature, tri_feature_index);
+    point.featureB->index = get_triangle_mesh_feature_index(tri, tri_idx, tri_feature, tri_feature_index);
     point.normal_attachment = contact_normal_attachment::none;
 
     // If the closest triangle feature is its face, check if the vertices of the
@@ -260,14 +266,31 @@ static void collide_polyhedron_triangle(
     }
 }
 
-void collide(const polyhedron_shape &poly, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_polyhedron_triangles(const polyhedron_shape &poly, TriangleSource &source,
+                                         const collision_context &ctx, collision_result &result) {
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&](auto tri_idx) {
-        collide_polyhedron_triangle(poly, mesh, tri_idx, ctx, result);
+    // Neighboring triangles usually have similar normals, thus the support
+    // vertex found for one triangle is a good starting point for the next.
+    uint32_t support_vertex_idx = 0;
+
+    const auto thickness = source.get_thickness();
+
+    source.visit_packed_triangles(visit_aabb, ctx.aabbA, ctx.threshold, [&](auto tri_idx, auto &tri) {
+        collide_polyhedron_triangle(poly, thickness, tri_idx, tri, ctx, result, support_vertex_idx);
     });
 }
 
+void collide(const polyhedron_shape &poly, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_polyhedron_triangles(poly, mesh, ctx, result);
+}
+
+void collide(const polyhedron_shape &poly, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_polyhedron_triangles(poly, *shape.field, ctx, result);
+}
+
 }
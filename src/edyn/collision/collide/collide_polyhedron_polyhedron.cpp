@@ -22,6 +22,10 @@ void max_support_direction(const polyhedron_shape &shA, const rotated_mesh &rota
     const auto &meshA = *shA.mesh;
     const auto &meshB = *shB.mesh;
 
+    // The support vertex on B for one face normal of A is where the search
+    // for the next face normal starts.
+    uint32_t support_vertex_idx = 0;
+
     for (auto face_idx : meshA.relevant_faces) {
         auto normal_world = -rotatedA.normals[face_idx]; // Normal pointing towards A.
         auto vertexA = rotatedA.vertices[meshA.first_vertex_index(face_idx)];
@@ -30,7 +34,7 @@ void max_support_direction(const polyhedron_shape &shA, const rotated_mesh &rota
 
         // Find point on B that's furthest along the opposite direction
         // of the face normal.
-        auto projB = polyhedron_support_projection(rotatedB.vertices, meshB.neighbors_start, meshB.neighbor_indices, normal_world) + dot(posB, normal_world);
+        auto projB = polyhedron_support_projection(rotatedB.vertices, meshB.neighbors_start, meshB.neighbor_indices, normal_world, support_vertex_idx) + dot(posB, normal_world);
 
         auto dist = projA - projB;
 
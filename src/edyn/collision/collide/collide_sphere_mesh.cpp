@@ -10,13 +10,13 @@
 namespace edyn {
 
 static void collide_sphere_triangle(
-    const sphere_shape &sphere, const triangle_mesh &mesh, size_t tri_idx,
+    const sphere_shape &sphere, scalar thickness, size_t tri_idx, const packed_triangle &tri,
     const collision_context &ctx, collision_result &result) {
 
     const auto &sphere_pos = ctx.posA;
     const auto &sphere_orn = ctx.ornA;
-    const auto tri_vertices = mesh.get_triangle_vertices(tri_idx);
-    const auto tri_normal = mesh.get_triangle_normal(tri_idx);
+    const auto &tri_vertices = tri.vertices;
+    const auto &tri_normal = tri.normal;
 
     // Triangle normal.
     auto distance = dot(sphere_pos - tri_vertices[0], tri_normal) - sphere.radius;
@@ -55,7 +55,7 @@ static void collide_sphere_triangle(
                                  tri_feature, tri_feature_index,
                                  proj_tri, support_feature_tolerance);
 
-    sep_axis = clip_triangle_separating_axis(sep_axis, mesh, tri_idx, tri_vertices, tri_normal, tri_feature, tri_feature_index);
+    sep_axis = clip_triangle_separating_axis(sep_axis, tri, tri_feature, tri_feature_index);
 
     get_triangle_support_feature(tri_vertices, vector3_zero, sep_axis,
                                  tri_feature, tri_feature_index,
@@ -69,7 +69,7 @@ static void collide_sphere_triangle(
         return;
     }
 
-    if (-distance > mesh.get_thickness()) {
+    if (-distance > thickness) {
         return;
     }
 
@@ -77,7 +77,7 @@ static void collide_sphere_triangle(
     point.normal = sep_axis;
     point.distance = distance;
     point.featureB = {tri_feature};
-    point.featureB->index = get_triangle_mesh_feature_index(mesh, tri_idx, tri_feature, tri_feature_index);
+    point.featureB->index = get_triangle_mesh_feature_index(tri, tri_idx, tri_feature, tri_feature_index);
 
     switch (tri_feature) {
     case triangle_feature::face: {
@@ -114,14 +114,27 @@ static void collide_sphere_triangle(
     }
 }
 
-void collide(const sphere_shape &sphere, const triangle_mesh &mesh,
-             const collision_context &ctx, collision_result &result) {
+template<typename TriangleSource>
+static void collide_sphere_triangles(const sphere_shape &sphere, TriangleSource &source,
+                                     const collision_context &ctx, collision_result &result) {
     const auto inset = vector3_one * -contact_breaking_threshold;
     const auto visit_aabb = ctx.aabbA.inset(inset);
 
-    mesh.visit_triangles(visit_aabb, [&](auto tri_idx) {
-        collide_sphere_triangle(sphere, mesh, tri_idx, ctx, result);
+    const auto thickness = source.get_thickness();
+
+    source.visit_packed_triangles(visit_aabb, ctx.aabbA, ctx.threshold, [&](auto tri_idx, auto &tri) {
+        collide_sphere_triangle(sphere, thickness, tri_idx, tri, ctx, result);
     });
 }
 
+void collide(const sphere_shape &sphere, const triangle_mesh &mesh,
+             const collision_context &ctx, collision_result &result) {
+    collide_sphere_triangles(sphere, mesh, ctx, result);
+}
+
+void collide(const sphere_shape &sphere, const heightfield_shape &shape,
+             const collision_context &ctx, collision_result &result) {
+    collide_sphere_triangles(sphere, *shape.field, ctx, result);
+}
+
 }
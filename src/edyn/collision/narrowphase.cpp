@@ -5,9 +5,12 @@
 #include "edyn/context/task.hpp"
 #include "edyn/context/task_util.hpp"
 #include "edyn/comp/material.hpp"
+#include "edyn/comp/linvel.hpp"
 #include "edyn/util/entt_util.hpp"
 #include "edyn/util/island_util.hpp"
 #include <entt/signal/delegate.hpp>
+#include <algorithm>
+#include <iterator>
 
 namespace edyn {
 
@@ -21,14 +24,70 @@ void narrowphase::clear_contact_manifold_events() {
     });
 }
 
+// Start loading pages along the path of bodies moving over shapes with
+// paging support, so they're likely in the cache once collision detection
+// needs them.
+template<typename ShapeType, typename GetPagedFunc>
+static void prefetch_pages_along_velocity(entt::registry &registry, GetPagedFunc get_paged) {
+    auto shape_view = registry.view<ShapeType>();
+
+    if (shape_view.size() == 0) {
+        return;
+    }
+
+    auto manifold_view = registry.view<contact_manifold>(exclude_sleeping_disabled);
+    auto body_view = registry.view<AABB, linvel>();
+
+    for (auto entity : manifold_view) {
+        auto [manifold] = manifold_view.get(entity);
+
+        for (auto i = 0; i < 2; ++i) {
+            auto shape_entity = manifold.body[i];
+            auto other_entity = manifold.body[(i + 1) % 2];
+
+            if (!shape_view.contains(shape_entity) || !body_view.contains(other_entity)) {
+                continue;
+            }
+
+            auto &paged = get_paged(shape_view.template get<ShapeType>(shape_entity));
+
+            if (!(paged.m_prefetch_time > 0)) {
+                continue;
+            }
+
+            auto [aabb, v] = body_view.get(other_entity);
+            auto displacement = v * paged.m_prefetch_time;
+            auto swept_aabb = AABB{aabb.min + min(displacement, vector3_zero),
+                                   aabb.max + max(displacement, vector3_zero)};
+            paged.prefetch(swept_aabb);
+        }
+    }
+}
+
+void narrowphase::prefetch_paged_mesh_pages() {
+    prefetch_pages_along_velocity<paged_mesh_shape>(*m_registry, [](auto &shape) -> auto & {
+        return *shape.trimesh;
+    });
+    prefetch_pages_along_velocity<heightfield_shape>(*m_registry, [](auto &shape) -> auto & {
+        return *shape.field;
+    });
+}
+
 void narrowphase::update(bool mt) {
     clear_contact_manifold_events();
     update_contact_distances(*m_registry);
+    prefetch_paged_mesh_pages();
 
     auto manifold_view = m_registry->view<contact_manifold>(exclude_sleeping_disabled);
     auto num_active_manifolds = calculate_view_size(manifold_view);
-
-    if (mt && num_active_manifolds > m_max_sequential_size) {
+    auto parallel = mt && num_active_manifolds > m_max_sequential_size;
+
+    if (m_registry->ctx().get<settings>().deterministic) {
+        detect_collision_deterministic(parallel);
+    } else if (parallel) {
+        // Parallel collision detection visits all manifolds.
+        auto all_manifolds_view = m_registry->view<contact_manifold>();
+        update_manifold_rotated_meshes(all_manifolds_view.begin(), all_manifolds_view.end());
         detect_collision_parallel();
         finish_detect_collision();
     } else {
@@ -36,7 +95,8 @@ void narrowphase::update(bool mt) {
     }
 }
 
-void narrowphase::detect_collision_parallel_range(unsigned start, unsigned end) {
+template<typename Iterator>
+void narrowphase::detect_collision_range(Iterator first, unsigned start, unsigned end) {
     auto &registry = *m_registry;
     auto manifold_view = registry.view<contact_manifold>();
     auto events_view = registry.view<contact_manifold_events>();
@@ -51,7 +111,6 @@ void narrowphase::detect_collision_parallel_range(unsigned start, unsigned end)
     auto paged_mesh_shape_view = registry.view<paged_mesh_shape>();
     auto shapes_views_tuple = get_tuple_of_shape_views(registry);
     auto dt = registry.ctx().get<settings>().fixed_dt;
-    auto first = manifold_view.begin();
     std::advance(first, start);
 
     for (auto index = start; index < end; ++index, ++first) {
@@ -75,22 +134,13 @@ void narrowphase::detect_collision_parallel_range(unsigned start, unsigned end)
     }
 }
 
-void narrowphase::detect_collision_parallel() {
-    // Resize result collection vectors to allocate one slot for each iteration.
-    auto manifold_view = m_registry->view<contact_manifold>();
-    m_cp_construction_infos.resize(manifold_view.size());
-    m_cp_destruction_infos.resize(manifold_view.size());
-
-    auto task = task_delegate_t(entt::connect_arg_t<&narrowphase::detect_collision_parallel_range>{}, *this);
-    enqueue_task_wait(*m_registry, task, manifold_view.size());
-}
-
-void narrowphase::finish_detect_collision() {
+template<typename Iterator>
+void narrowphase::finish_detect_collision(Iterator first, size_t count) {
     auto manifold_view = m_registry->view<contact_manifold>();
-    auto it = manifold_view.begin();
+    auto it = first;
 
     // Destroy contact points.
-    for (size_t i = 0; i < manifold_view.size(); ++i, ++it) {
+    for (size_t i = 0; i < count; ++i, ++it) {
         auto entity = *it;
         auto &info_result = m_cp_destruction_infos[i];
 
@@ -100,9 +150,9 @@ void narrowphase::finish_detect_collision() {
     }
 
     // Create contact points.
-    it = manifold_view.begin();
+    it = first;
 
-    for (size_t i = 0; i < manifold_view.size(); ++i, ++it) {
+    for (size_t i = 0; i < count; ++i, ++it) {
         auto entity = *it;
         auto &manifold = manifold_view.get<contact_manifold>(entity);
         auto &info_result = m_cp_construction_infos[i];
@@ -116,4 +166,59 @@ void narrowphase::finish_detect_collision() {
     m_cp_construction_infos.clear();
 }
 
+void narrowphase::detect_collision_parallel_range(unsigned start, unsigned end) {
+    auto manifold_view = m_registry->view<contact_manifold>();
+    detect_collision_range(manifold_view.begin(), start, end);
+}
+
+void narrowphase::detect_collision_parallel() {
+    // Resize result collection vectors to allocate one slot for each iteration.
+    auto manifold_view = m_registry->view<contact_manifold>();
+    m_cp_construction_infos.resize(manifold_view.size());
+    m_cp_destruction_infos.resize(manifold_view.size());
+
+    auto task = task_delegate_t(entt::connect_arg_t<&narrowphase::detect_collision_parallel_range>{}, *this);
+    enqueue_task_wait(*m_registry, task, manifold_view.size());
+}
+
+void narrowphase::finish_detect_collision() {
+    auto manifold_view = m_registry->view<contact_manifold>();
+    finish_detect_collision(manifold_view.begin(), manifold_view.size());
+}
+
+void narrowphase::detect_collision_deterministic_range(unsigned start, unsigned end) {
+    detect_collision_range(m_deterministic_manifolds.begin(), start, end);
+}
+
+void narrowphase::detect_collision_deterministic(bool mt) {
+    // Only awake manifolds are processed, in order of entity identifier, and
+    // contact points are destroyed and created after all of them were
+    // processed. The result is thus the same whether or not detection runs
+    // in parallel, and doesn't depend on the order of the manifold pool.
+    auto manifold_view = m_registry->view<contact_manifold>(exclude_sleeping_disabled);
+    m_deterministic_manifolds.clear();
+
+    for (auto entity : manifold_view) {
+        m_deterministic_manifolds.push_back(entity);
+    }
+
+    std::sort(m_deterministic_manifolds.begin(), m_deterministic_manifolds.end(), [](auto lhs, auto rhs) {
+        return entt::to_integral(lhs) < entt::to_integral(rhs);
+    });
+
+    auto num_manifolds = static_cast<unsigned>(m_deterministic_manifolds.size());
+    update_manifold_rotated_meshes(m_deterministic_manifolds.begin(), m_deterministic_manifolds.end());
+    m_cp_construction_infos.resize(num_manifolds);
+    m_cp_destruction_infos.resize(num_manifolds);
+
+    if (mt) {
+        auto task = task_delegate_t(entt::connect_arg_t<&narrowphase::detect_collision_deterministic_range>{}, *this);
+        enqueue_task_wait(*m_registry, task, num_manifolds);
+    } else {
+        detect_collision_deterministic_range(0, num_manifolds);
+    }
+
+    finish_detect_collision(m_deterministic_manifolds.begin(), m_deterministic_manifolds.size());
+}
+
 }
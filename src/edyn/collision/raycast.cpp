@@ -6,6 +6,7 @@
 #include "edyn/math/transform.hpp"
 #include "edyn/simulation/stepper_async.hpp"
 #include "edyn/math/triangle.hpp"
+#include "edyn/util/shape_util.hpp"
 #include <unordered_set>
 
 namespace edyn {
@@ -267,6 +268,28 @@ shape_raycast_result shape_raycast(const polyhedron_shape &poly, const raycast_c
     auto intersect_face_idx = SIZE_MAX;
     const auto &mesh = *poly.mesh;
 
+    // Early out if the plane orthogonal to the direction of the point on the
+    // segment closest to the origin separates the segment from the polyhedron.
+    // The support projection is found by hill-climbing, which is cheaper than
+    // visiting all faces.
+    {
+        auto dd = dot(d, d);
+        auto t = dd > EDYN_EPSILON ? clamp_unit(-dot(p0, d) / dd) : scalar(0);
+        auto closest = p0 + d * t;
+        auto dist_sqr = length_sqr(closest);
+
+        if (dist_sqr > EDYN_EPSILON) {
+            auto dist = std::sqrt(dist_sqr);
+            auto dir = closest / dist;
+            auto proj = polyhedron_support_projection(mesh.vertices, mesh.neighbors_start,
+                                                      mesh.neighbor_indices, dir);
+
+            if (proj < dist) {
+                return {};
+            }
+        }
+    }
+
     for (size_t face_idx = 0; face_idx < mesh.num_faces(); ++face_idx) {
         auto vertex = mesh.vertices[mesh.first_vertex_index(face_idx)];
         auto normal = mesh.normals[face_idx];
@@ -424,4 +447,28 @@ shape_raycast_result shape_raycast(const paged_mesh_shape &paged_mesh, const ray
     return result;
 }
 
+shape_raycast_result shape_raycast(const heightfield_shape &shape, const raycast_context &ctx) {
+    shape_raycast_result result;
+
+    // Cells are visited in order along the ray thus the search can stop at
+    // the first cell containing an intersection.
+    shape.field->raycast(ctx.p0, ctx.p1, [&](auto tri_idx, auto &vertices, auto &normal) {
+        auto t = scalar(0);
+
+        if (!intersect_segment_triangle(ctx.p0, ctx.p1, vertices, normal, t)) {
+            return false;
+        }
+
+        if (t < result.fraction) {
+            result.fraction = t;
+            result.normal = normal;
+            result.info_var = heightfield_raycast_info{tri_idx};
+        }
+
+        return true;
+    });
+
+    return result;
+}
+
 }
@@ -16,6 +16,7 @@
 #include "edyn/constraints/constraint_row_friction.hpp"
 #include "edyn/constraints/contact_constraint.hpp"
 #include "edyn/context/task.hpp"
+#include "edyn/context/settings.hpp"
 #include "edyn/context/task_util.hpp"
 #include "edyn/dynamics/island_constraint_entities.hpp"
 #include "edyn/dynamics/position_solver.hpp"
@@ -29,12 +30,14 @@
 #include "edyn/config/config.h"
 #include <entt/entity/fwd.hpp>
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 #include <cstdint>
 #include <entt/signal/delegate.hpp>
 #include <iterator>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace edyn {
 
@@ -112,8 +115,8 @@ static void solve(row_cache &cache) {
     }
 }
 
-template<typename C>
-void insert_rows(entt::registry &registry, row_cache &cache, const entt::sparse_set &entities,
+template<typename C, typename Entities>
+void insert_rows(entt::registry &registry, row_cache &cache, const Entities &entities,
                  island_constraint_entities &constraint_entities) {
     auto prep_view = registry.view<constraint_row_prep_cache>();
     auto con_view = registry.view<C>();
@@ -169,9 +172,22 @@ void pack_rows(entt::registry &registry, row_cache &cache, const entt::sparse_se
         ents.clear();
     }
 
-    std::apply([&](auto ... c) {
-        (insert_rows<decltype(c)>(registry, cache, entities, constraint_entities), ...);
-    }, constraints_tuple);
+    if (registry.ctx().get<settings>().deterministic) {
+        // The order of the island edges depends on the history of insertions
+        // and removals. Solve constraints in order of entity identifier instead.
+        auto sorted_entities = std::vector<entt::entity>(entities.begin(), entities.end());
+        std::sort(sorted_entities.begin(), sorted_entities.end(), [](auto lhs, auto rhs) {
+            return entt::to_integral(lhs) < entt::to_integral(rhs);
+        });
+
+        std::apply([&](auto ... c) {
+            (insert_rows<decltype(c)>(registry, cache, sorted_entities, constraint_entities), ...);
+        }, constraints_tuple);
+    } else {
+        std::apply([&](auto ... c) {
+            (insert_rows<decltype(c)>(registry, cache, entities, constraint_entities), ...);
+        }, constraints_tuple);
+    }
 
     warm_start(cache);
 }
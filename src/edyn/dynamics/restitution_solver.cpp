@@ -104,6 +104,7 @@ bool solve_restitution_iteration(entt::registry &registry, entt::entity island_e
     auto min_relvel = EDYN_SCALAR_MAX;
     auto fastest_manifold_entity = entt::entity{entt::null};
     auto &island = registry.get<edyn::island>(island_entity);
+    auto deterministic = registry.ctx().get<settings>().deterministic;
 
     for (auto entity : island.edges) {
         if (!restitution_view.contains(entity)) {
@@ -113,7 +114,11 @@ bool solve_restitution_iteration(entt::registry &registry, entt::entity island_e
         auto &manifold = manifold_view.get<contact_manifold>(entity);
         auto local_min_relvel = get_manifold_min_relvel(manifold, body_view, origin_view, static_view);
 
-        if (local_min_relvel < min_relvel) {
+        // Break ties by entity identifier in deterministic mode since the
+        // order of island edges can vary.
+        if (local_min_relvel < min_relvel ||
+            (deterministic && local_min_relvel == min_relvel &&
+             entt::to_integral(entity) < entt::to_integral(fastest_manifold_entity))) {
             min_relvel = local_min_relvel;
             fastest_manifold_entity = entity;
         }
@@ -17,7 +17,6 @@
 #include "edyn/serialization/s11n_util.hpp"
 #include "edyn/sys/apply_gravity.hpp"
 #include "edyn/sys/update_aabbs.hpp"
-#include "edyn/sys/update_rotated_meshes.hpp"
 #include "edyn/sys/update_inertias.hpp"
 #include "edyn/sys/update_origins.hpp"
 #include "edyn/constraints/constraint_row.hpp"
@@ -224,11 +223,6 @@ void solver::update(bool mt) {
 
     update_origins(registry);
 
-    // Update rotated vertices of convex meshes after rotations change. It is
-    // important to do this before `update_aabbs` because the rotated meshes
-    // will be used to calculate AABBs of polyhedrons.
-    update_rotated_meshes(registry);
-
     // Update AABBs after transforms change.
     update_aabbs(registry);
     update_island_aabbs(registry);
@@ -138,6 +138,7 @@ void detach(entt::registry &registry) {
     registry.ctx().erase<narrowphase>();
     registry.ctx().erase<stepper_async>();
     registry.ctx().erase<stepper_sequential>();
+    registry.ctx().erase<presentation_exporter>();
 
     registry.clear<rigidbody_tag, constraint_tag, dynamic_tag, kinematic_tag, static_tag,
                    procedural_tag, networked_tag, external_tag, network_exclude_tag,
@@ -191,6 +192,57 @@ void set_max_steps_per_update(entt::registry &registry, unsigned max_steps) {
     refresh_settings(registry);
 }
 
+void set_coalesce_substep_updates(entt::registry &registry, bool coalesce) {
+    auto &settings = registry.ctx().get<edyn::settings>();
+    settings.coalesce_substep_updates = coalesce;
+    refresh_settings(registry);
+}
+
+void set_deterministic(entt::registry &registry, bool deterministic) {
+    auto &settings = registry.ctx().get<edyn::settings>();
+    settings.deterministic = deterministic;
+    refresh_settings(registry);
+}
+
+void set_compact_sleeping_pools(entt::registry &registry, bool compact) {
+    auto &settings = registry.ctx().get<edyn::settings>();
+    settings.compact_sleeping_pools = compact;
+    refresh_settings(registry);
+}
+
+void set_worker_pacing(entt::registry &registry, worker_pacing pacing) {
+    auto &settings = registry.ctx().get<edyn::settings>();
+    settings.worker_pacing = pacing;
+    refresh_settings(registry);
+}
+
+worker_pacing_stats get_worker_pacing_stats(const entt::registry &registry) {
+    if (auto *stepper = registry.ctx().find<stepper_async>()) {
+        return stepper->get_worker_pacing_stats();
+    }
+
+    return {};
+}
+
+void set_presentation_output(entt::registry &registry, presentation_output *output) {
+    // Only used in the main thread, thus the worker doesn't need to know.
+    registry.ctx().get<settings>().presentation_output = output;
+}
+
+void set_presentation_export_enabled(entt::registry &registry, bool enabled) {
+    if (enabled) {
+        if (!registry.ctx().contains<presentation_exporter>()) {
+            registry.ctx().emplace<presentation_exporter>(registry);
+        }
+    } else {
+        registry.ctx().erase<presentation_exporter>();
+    }
+}
+
+presentation_exporter & get_presentation_exporter(entt::registry &registry) {
+    return registry.ctx().get<presentation_exporter>();
+}
+
 bool is_paused(const entt::registry &registry) {
     return registry.ctx().get<settings>().paused;
 }
@@ -1,6 +1,5 @@
 #include "edyn/math/triangle.hpp"
 #include "edyn/math/constants.hpp"
-#include "edyn/shapes/triangle_mesh.hpp"
 
 namespace edyn {
 
@@ -133,10 +132,11 @@ AABB get_triangle_aabb(const triangle_vertices &vertices) {
     return {tri_min, tri_max};
 }
 
-vector3 clip_triangle_separating_axis(vector3 sep_axis, const triangle_mesh &mesh,
-                                      size_t tri_idx, const triangle_vertices &tri_vertices,
-                                      const vector3 &tri_normal, triangle_feature tri_feature,
-                                      size_t tri_feature_index) {
+vector3 clip_triangle_separating_axis(vector3 sep_axis, const packed_triangle &tri,
+                                      triangle_feature tri_feature, size_t tri_feature_index) {
+    auto &tri_vertices = tri.vertices;
+    auto &tri_normal = tri.normal;
+
     // Project separating axis into voronoi region of triangle feature.
     // Return zero if the axis should be ignored, which happens in case the
     // feature is a vertex and the axis does not lie in the voronoi region.
@@ -146,8 +146,8 @@ vector3 clip_triangle_separating_axis(vector3 sep_axis, const triangle_mesh &mes
         auto edge_idx0 = tri_feature_index;
         auto edge_idx1 = (tri_feature_index + 2) % 3;
 
-        auto adj_normal0 = mesh.get_adjacent_face_normal(tri_idx, edge_idx0);
-        auto adj_normal1 = mesh.get_adjacent_face_normal(tri_idx, edge_idx1);
+        auto adj_normal0 = tri.adjacent_normals[edge_idx0];
+        auto adj_normal1 = tri.adjacent_normals[edge_idx1];
 
         auto edge_dir0 = tri_vertices[(edge_idx0 + 1) % 3] - tri_vertices[edge_idx0];
         auto edge_normal0 = cross(edge_dir0, adj_normal0);
@@ -179,7 +179,7 @@ vector3 clip_triangle_separating_axis(vector3 sep_axis, const triangle_mesh &mes
 
         break;
     } case triangle_feature::edge: {
-        auto adj_normal = mesh.get_adjacent_face_normal(tri_idx, tri_feature_index);
+        auto adj_normal = tri.adjacent_normals[tri_feature_index];
         auto v0 = tri_vertices[tri_feature_index];
         auto v1 = tri_vertices[(tri_feature_index + 1) % 3];
         auto edge_dir = v1 - v0;
@@ -5,7 +5,6 @@
 #include "edyn/collision/contact_manifold_map.hpp"
 #include "edyn/comp/linvel.hpp"
 #include "edyn/comp/orientation.hpp"
-#include "edyn/comp/rotated_mesh_list.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/config/config.h"
 #include "edyn/constraints/contact_constraint.hpp"
@@ -28,16 +27,17 @@
 #include "edyn/sys/update_aabbs.hpp"
 #include "edyn/sys/update_inertias.hpp"
 #include "edyn/sys/update_origins.hpp"
-#include "edyn/sys/update_rotated_meshes.hpp"
 #include "edyn/parallel/job_dispatcher.hpp"
 #include "edyn/math/transform.hpp"
 #include "edyn/util/constraint_util.hpp"
 #include "edyn/util/island_util.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 
 namespace edyn {
 
-extrapolation_worker::extrapolation_worker(const settings &settings,
+extrapolation_worker::extrapolation_worker(const std::string &queue_name,
+                                           const settings &settings,
                                            const registry_operation_context &reg_op_ctx,
                                            const material_mix_table &material_table,
                                            make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp)
@@ -46,12 +46,13 @@ extrapolation_worker::extrapolation_worker(const settings &settings,
     , m_island_manager(m_registry)
     , m_message_queue(message_dispatcher::global().make_queue<
         extrapolation_request,
+        extrapolation_remote_state,
         extrapolation_operation_create,
         extrapolation_operation_destroy,
         msg::set_settings,
         msg::set_registry_operation_context,
         msg::set_material_table,
-        msg::set_extrapolator_context_settings>("extrapolation_worker"))
+        msg::set_extrapolator_context_settings>(queue_name))
 {
     m_registry.ctx().emplace<contact_manifold_map>(m_registry);
     m_registry.ctx().emplace<broadphase>(m_registry);
@@ -62,6 +63,7 @@ extrapolation_worker::extrapolation_worker(const settings &settings,
     m_registry.ctx().emplace<material_mix_table>(material_table);
 
     m_message_queue.sink<extrapolation_request>().connect<&extrapolation_worker::on_extrapolation_request>(*this);
+    m_message_queue.sink<extrapolation_remote_state>().connect<&extrapolation_worker::on_extrapolation_remote_state>(*this);
     m_message_queue.sink<extrapolation_operation_create>().connect<&extrapolation_worker::on_extrapolation_operation_create>(*this);
     m_message_queue.sink<extrapolation_operation_destroy>().connect<&extrapolation_worker::on_extrapolation_operation_destroy>(*this);
     m_message_queue.sink<msg::set_settings>().connect<&extrapolation_worker::on_set_settings>(*this);
@@ -132,12 +134,73 @@ void extrapolation_worker::set_context_settings(std::shared_ptr<input_state_hist
                                                             input_history, make_extrapolation_modified_comp);
 }
 
-void extrapolation_worker::on_extrapolation_request(message<extrapolation_request> &msg) {
-    if (m_requests.size() == m_max_requests) {
-        m_requests.erase(m_requests.begin());
+void extrapolation_worker::request_extrapolation(const message_queue_identifier &source,
+                                                 extrapolation_request &&request) {
+    m_num_pending_requests.fetch_add(1, std::memory_order_relaxed);
+    auto &dispatcher = message_dispatcher::global();
+    dispatcher.send<extrapolation_request>(m_message_queue.identifier, source, std::move(request));
+}
+
+void extrapolation_worker::update_remote_state(const message_queue_identifier &source,
+                                               extrapolation_remote_state &&state) {
+    m_num_pending_requests.fetch_add(1, std::memory_order_relaxed);
+    auto &dispatcher = message_dispatcher::global();
+    dispatcher.send<extrapolation_remote_state>(m_message_queue.identifier, source, std::move(state));
+}
+
+void extrapolation_worker::enqueue(pending_request &&pending) {
+    auto &request = pending.request;
+
+    // Older requests involving only entities which are also present in the
+    // new snapshot are superseded by it, since their result would be replaced
+    // by the result of the new extrapolation anyways. Their snapshot must
+    // still be applied to the remote state storage because it can contain
+    // components which are not present in the new snapshot.
+    auto request_entities = entt::sparse_set{};
+
+    for (auto entity : request.snapshot.entities) {
+        if (!request_entities.contains(entity)) {
+            request_entities.push(entity);
+        }
+    }
+
+    for (auto &other : m_requests) {
+        auto &entities = other.request.snapshot.entities;
+
+        if (other.request.start_time <= request.start_time &&
+            std::all_of(entities.begin(), entities.end(),
+                        [&](auto entity) { return request_entities.contains(entity); }))
+        {
+            other.superseded = true;
+        }
     }
 
-    m_requests.emplace_back(std::move(msg.content));
+    // Limit the number of extrapolations. Snapshots of dropped requests are
+    // still stored as remote state, otherwise it would become stale.
+    if (!pending.superseded) {
+        auto num_extrapolations = static_cast<unsigned>(
+            std::count_if(m_requests.begin(), m_requests.end(),
+                          [](auto &other) { return !other.superseded; }));
+
+        if (num_extrapolations == m_max_requests) {
+            auto oldest = std::find_if(m_requests.begin(), m_requests.end(),
+                                       [](auto &other) { return !other.superseded; });
+            oldest->superseded = true;
+        }
+    }
+
+    m_requests.push_back(std::move(pending));
+}
+
+void extrapolation_worker::on_extrapolation_request(message<extrapolation_request> &msg) {
+    enqueue(pending_request{std::move(msg.content), false});
+}
+
+void extrapolation_worker::on_extrapolation_remote_state(message<extrapolation_remote_state> &msg) {
+    auto request = extrapolation_request{};
+    request.start_time = msg.content.start_time;
+    request.snapshot = std::move(msg.content.snapshot);
+    enqueue(pending_request{std::move(request), true});
 }
 
 void extrapolation_worker::on_extrapolation_operation_destroy(message<extrapolation_operation_destroy> &msg) {
@@ -288,11 +351,16 @@ bool extrapolation_worker::begin_extrapolation(const extrapolation_request &requ
     // Initialize new nodes and edges and create islands.
     m_island_manager.update(m_current_time);
 
-    // Collect indices of nodes present in the snapshot.
+    // Collect indices of nodes present in the snapshot. The containers are
+    // kept between requests to avoid reallocating them every time.
     auto &graph = m_registry.ctx().get<entity_graph>();
-    std::set<entity_graph::index_type> node_indices;
     auto node_view = m_registry.view<graph_node>();
-    auto snapshot_entities = entt::sparse_set{};
+    auto &node_indices = m_node_indices;
+    auto &snapshot_entities = m_snapshot_entities;
+    auto &entities = m_entities;
+    node_indices.clear();
+    snapshot_entities.clear();
+    entities.clear();
 
     // The snapshot entities only include those that have a component that
     // changed recently. Though the extrapolation must include all entities
@@ -305,31 +373,37 @@ bool extrapolation_worker::begin_extrapolation(const extrapolation_request &requ
         }
 
         auto local_entity = m_entity_map.at(remote_entity);
-        snapshot_entities.push(local_entity);
+
+        if (!snapshot_entities.contains(local_entity)) {
+            snapshot_entities.push(local_entity);
+        }
 
         if (node_view.contains(local_entity)) {
             auto node_index = node_view.get<graph_node>(local_entity).node_index;
 
             if (graph.is_connecting_node(node_index)) {
-                node_indices.insert(node_index);
+                node_indices.push_back(node_index);
             }
         }
     }
 
-    // Collection of entities in all involved islands.
-    auto entities = entt::sparse_set{};
+    std::sort(node_indices.begin(), node_indices.end());
+    node_indices.erase(std::unique(node_indices.begin(), node_indices.end()), node_indices.end());
 
-    graph.reach(
-        node_indices.begin(), node_indices.end(),
-        [&](entt::entity entity) {
-            if (!entities.contains(entity)) {
-                entities.push(entity);
-            }
-        }, [&](entt::entity entity) {
-            if (!entities.contains(entity)) {
-                entities.push(entity);
-            }
-        }, [](auto) { return true; }, []() {});
+    // Collection of entities in all involved islands.
+    if (!node_indices.empty()) {
+        graph.reach(
+            node_indices.begin(), node_indices.end(),
+            [&](entt::entity entity) {
+                if (!entities.contains(entity)) {
+                    entities.push(entity);
+                }
+            }, [&](entt::entity entity) {
+                if (!entities.contains(entity)) {
+                    entities.push(entity);
+                }
+            }, [](auto) { return true; }, []() {});
+    }
 
     // Wake up all involved islands.
     auto resident_view = m_registry.view<island_resident>();
@@ -372,26 +446,31 @@ bool extrapolation_worker::begin_extrapolation(const extrapolation_request &requ
         (*client_settings.extrapolation_begin_callback)(m_registry);
     }
 
-    // Recalculate properties after setting initial state from server.
+    // Recalculate properties after setting initial state from server. Static
+    // entities do not move during extrapolation, thus their calculated
+    // properties are still valid unless they're present in the snapshot.
     auto origin_view = m_registry.view<position, orientation, center_of_mass, origin>();
+    auto static_view = m_registry.view<static_tag>();
+    auto aabb_view = m_registry.view<AABB>();
+    auto dynamic_view = m_registry.view<dynamic_tag>();
 
     for (auto entity : entities) {
+        if (static_view.contains(entity) && !snapshot_entities.contains(entity)) {
+            continue;
+        }
+
         if (origin_view.contains(entity)) {
             auto [pos, orn, com, orig] = origin_view.get(entity);
             orig = to_world_space(-com, pos, orn);
         }
 
-        if (m_registry.any_of<AABB>(entity)) {
+        if (aabb_view.contains(entity)) {
             update_aabb(m_registry, entity);
         }
 
-        if (m_registry.any_of<dynamic_tag>(entity)) {
+        if (dynamic_view.contains(entity)) {
             update_inertia(m_registry, entity);
         }
-
-        if (m_registry.any_of<rotated_mesh_list>(entity)) {
-            update_rotated_mesh(m_registry, entity);
-        }
     }
 
     return true;
@@ -444,6 +523,7 @@ void extrapolation_worker::finish_extrapolation(const extrapolation_request &req
 
     // Assign timestamp of the last step.
     result.timestamp = m_current_time;
+    result.start_time = request.start_time;
 
     if (request.should_remap) {
         // Map all entities (including those contained in components) back to
@@ -507,6 +587,34 @@ void extrapolation_worker::finish_step() {
     ++m_step_count;
 }
 
+void extrapolation_worker::apply_superseded(const extrapolation_request &request) {
+    auto snapshot_entities = entt::sparse_set{};
+
+    for (auto remote_entity : request.snapshot.entities) {
+        if (!m_entity_map.contains(remote_entity)) {
+            return;
+        }
+
+        auto local_entity = m_entity_map.at(remote_entity);
+
+        if (!snapshot_entities.contains(local_entity)) {
+            snapshot_entities.push(local_entity);
+        }
+    }
+
+    // Skip extrapolation and only store the snapshot contents as the most
+    // recently seen remote state. The registry holds the result of the last
+    // extrapolation, thus the last known remote state must be imported before
+    // the snapshot is applied on top of it.
+    m_modified_comp->import_remote_state(snapshot_entities);
+
+    for (auto &pool : request.snapshot.pools) {
+        pool.ptr->replace_into_registry(m_registry, request.snapshot.entities, m_entity_map);
+    }
+
+    m_modified_comp->export_remote_state(snapshot_entities);
+}
+
 void extrapolation_worker::extrapolate(const extrapolation_request &request) {
     if (!begin_extrapolation(request)) {
         return;
@@ -543,11 +651,18 @@ void extrapolation_worker::run() {
             m_message_queue.update();
 
             if (!m_requests.empty()) {
-                auto req = std::move(m_requests.front());
+                auto pending = std::move(m_requests.front());
                 m_requests.erase(m_requests.begin());
-                extrapolate(req);
+
+                if (pending.superseded) {
+                    apply_superseded(pending.request);
+                } else {
+                    extrapolate(pending.request);
+                }
+
+                m_num_pending_requests.fetch_sub(1, std::memory_order_relaxed);
             }
-        } while (!m_requests.empty() && m_has_messages.exchange(false, std::memory_order_relaxed));
+        } while (!m_requests.empty() || m_has_messages.exchange(false, std::memory_order_relaxed));
     }
 
     deinit();
@@ -0,0 +1,153 @@
+#include "edyn/networking/extrapolation/extrapolation_worker_pool.hpp"
+#include "edyn/config/config.h"
+#include "edyn/parallel/message_dispatcher.hpp"
+#include "edyn/serialization/memory_archive.hpp"
+#include <entt/entity/registry.hpp>
+#include <algorithm>
+#include <string>
+
+namespace edyn {
+
+extrapolation_worker_pool::extrapolation_worker_pool(unsigned num_workers,
+                                                     const settings &settings,
+                                                     const registry_operation_context &reg_op_ctx,
+                                                     const material_mix_table &material_table,
+                                                     make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp)
+{
+    EDYN_ASSERT(num_workers > 0);
+
+    for (unsigned i = 0; i < num_workers; ++i) {
+        auto name = std::string("extrapolation_worker_") + std::to_string(i);
+        m_workers.push_back(std::make_unique<extrapolation_worker>(name, settings, reg_op_ctx, material_table,
+                                                                   make_extrapolation_modified_comp));
+    }
+}
+
+void extrapolation_worker_pool::start() {
+    for (auto &worker : m_workers) {
+        worker->start();
+    }
+}
+
+void extrapolation_worker_pool::stop() {
+    for (auto &worker : m_workers) {
+        worker->stop();
+    }
+}
+
+void extrapolation_worker_pool::set_settings(const edyn::settings &settings) {
+    for (auto &worker : m_workers) {
+        worker->set_settings(settings);
+    }
+}
+
+void extrapolation_worker_pool::set_material_table(const material_mix_table &material_table) {
+    for (auto &worker : m_workers) {
+        worker->set_material_table(material_table);
+    }
+}
+
+void extrapolation_worker_pool::set_registry_operation_context(const registry_operation_context &reg_op_ctx) {
+    for (auto &worker : m_workers) {
+        worker->set_registry_operation_context(reg_op_ctx);
+    }
+}
+
+void extrapolation_worker_pool::set_context_settings(std::shared_ptr<input_state_history_reader> input_history,
+                                                     make_extrapolation_modified_comp_func_t *make_extrapolation_modified_comp) {
+    for (auto &worker : m_workers) {
+        worker->set_context_settings(input_history, make_extrapolation_modified_comp);
+    }
+}
+
+void extrapolation_worker_pool::remove_entities(const message_queue_identifier &source,
+                                                const std::vector<entt::entity> &entities) {
+    auto &dispatcher = message_dispatcher::global();
+
+    for (auto &worker : m_workers) {
+        dispatcher.send<extrapolation_operation_destroy>(worker->queue_identifier(), source, entities);
+    }
+
+    for (auto entity : entities) {
+        m_entity_worker.erase(entity);
+    }
+}
+
+size_t extrapolation_worker_pool::select_worker(const extrapolation_request &request) {
+    // Prefer the worker which received most of these entities last. That way,
+    // extrapolations of the same entities are done in order and the older
+    // request can be superseded by the new one.
+    m_worker_counts.assign(m_workers.size(), 0);
+
+    for (auto entity : request.snapshot.entities) {
+        if (auto it = m_entity_worker.find(entity); it != m_entity_worker.end()) {
+            ++m_worker_counts[it->second];
+        }
+    }
+
+    auto max_it = std::max_element(m_worker_counts.begin(), m_worker_counts.end());
+
+    if (*max_it > 0) {
+        return static_cast<size_t>(std::distance(m_worker_counts.begin(), max_it));
+    }
+
+    // Otherwise, pick the worker with the least amount of pending work.
+    size_t best_index = 0;
+    auto best_count = m_workers[0]->num_pending_requests();
+
+    for (size_t i = 1; i < m_workers.size() && best_count > 0; ++i) {
+        auto count = m_workers[i]->num_pending_requests();
+
+        if (count < best_count) {
+            best_index = i;
+            best_count = count;
+        }
+    }
+
+    return best_index;
+}
+
+static packet::registry_snapshot copy_snapshot(const packet::registry_snapshot &snapshot) {
+    // Pools are shared pointers which are modified by the workers as they map
+    // entities, thus a deep copy is necessary.
+    auto copy = packet::registry_snapshot{};
+    copy.timestamp = snapshot.timestamp;
+    copy.entities = snapshot.entities;
+    auto data = std::vector<uint8_t>{};
+
+    for (auto &pool : snapshot.pools) {
+        data.clear();
+        auto output = memory_output_archive(data);
+        pool.ptr->write(output);
+
+        auto &pool_copy = copy.pools.emplace_back();
+        pool_copy.component_index = pool.component_index;
+        pool_copy.ptr = (*g_make_pool_snapshot_data)(pool.component_index);
+        auto input = memory_input_archive(data.data(), data.size());
+        pool_copy.ptr->read(input);
+    }
+
+    return copy;
+}
+
+void extrapolation_worker_pool::request_extrapolation(const message_queue_identifier &source,
+                                                      extrapolation_request &&request) {
+    auto index = select_worker(request);
+
+    for (auto entity : request.snapshot.entities) {
+        m_entity_worker[entity] = index;
+    }
+
+    // All workers must know the latest remote state of every entity since any
+    // of them could be assigned to extrapolate them later.
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        if (i != index) {
+            auto state = extrapolation_remote_state{request.start_time, copy_snapshot(request.snapshot)};
+            m_workers[i]->update_remote_state(source, std::move(state));
+        }
+    }
+
+    m_workers[index]->request_extrapolation(source, std::move(request));
+}
+
+}
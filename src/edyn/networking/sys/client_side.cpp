@@ -27,7 +27,7 @@
 #include "edyn/networking/comp/networked_comp.hpp"
 #include "edyn/networking/packet/registry_snapshot.hpp"
 #include "edyn/networking/context/client_network_context.hpp"
-#include "edyn/networking/extrapolation/extrapolation_worker.hpp"
+#include "edyn/networking/extrapolation/extrapolation_worker_pool.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/networking/util/snap_to_pool_snapshot.hpp"
 #include "edyn/parallel/message_dispatcher.hpp"
@@ -111,26 +111,40 @@ static void update_input_history(entt::registry &registry, double timestamp) {
 
 static void on_extrapolation_result(entt::registry &registry, message<extrapolation_result> &msg) {
     auto &result = msg.content;
+    auto &ctx = registry.ctx().get<client_network_context>();
 
     if (result.terminated_early) {
-        auto &ctx = registry.ctx().get<client_network_context>();
         ctx.extrapolation_timeout_signal.publish();
     }
 
+    // Discard result if any of its entities has already been assigned the
+    // result of an extrapolation which started from a more recent snapshot.
+    auto entities = get_entities_from_extrapolation_result(result);
+
+    for (auto entity : entities) {
+        if (auto it = ctx.extrapolation_start_times.find(entity);
+            it != ctx.extrapolation_start_times.end() && it->second > result.start_time) {
+            return;
+        }
+    }
+
+    for (auto entity : entities) {
+        ctx.extrapolation_start_times[entity] = result.start_time;
+    }
+
     auto &settings = registry.ctx().get<edyn::settings>();
 
     if (settings.execution_mode == edyn::execution_mode::asynchronous) {
         auto &stepper = registry.ctx().get<stepper_async>();
         stepper.send_message_to_worker<extrapolation_result>(std::move(result));
     } else {
-        auto &ctx = registry.ctx().get<client_network_context>();
         ctx.snapshot_exporter->set_observer_enabled(false);
         process_extrapolation_result(registry, result);
         ctx.snapshot_exporter->set_observer_enabled(true);
     }
 }
 
-void init_network_client(entt::registry &registry) {
+void init_network_client(entt::registry &registry, unsigned num_extrapolation_workers) {
     auto &ctx = registry.ctx().emplace<client_network_context>(registry);
 
     registry.on_construct<networked_tag>().connect<&on_construct_networked_entity>();
@@ -152,8 +166,9 @@ void init_network_client(entt::registry &registry) {
 
     auto &reg_op_ctx = registry.ctx().get<registry_operation_context>();
     auto &material_table = registry.ctx().get<material_mix_table>();
-    ctx.extrapolator = std::make_unique<extrapolation_worker>(settings, reg_op_ctx, material_table,
-                                                              ctx.make_extrapolation_modified_comp);
+    ctx.extrapolator = std::make_unique<extrapolation_worker_pool>(num_extrapolation_workers,
+                                                                   settings, reg_op_ctx, material_table,
+                                                                   ctx.make_extrapolation_modified_comp);
     ctx.extrapolator->start();
 
     ctx.message_queue.sink<extrapolation_result>().connect<&on_extrapolation_result>(registry);
@@ -178,33 +193,40 @@ void add_entities_to_extrapolator(entt::registry &registry,
                                   const std::vector<entt::entity> &owned_entities) {
     auto &ctx = registry.ctx().get<client_network_context>();
     auto &reg_op_ctx = registry.ctx().get<registry_operation_context>();
-    auto builder = (*reg_op_ctx.make_reg_op_builder)(registry);
+    auto &dispatcher = message_dispatcher::global();
 
-    // Add all _create_ operations first so all entities are created in the extrapolator
-    // before components are inserted. This will ensure entities will be available in the
-    // entity map ready to be used in child entity mapping for all entity properties of
-    // all components.
-    for (auto entity : entities) {
-        builder->create(entity);
-    }
+    // Every extrapolation worker holds a copy of all entities thus each one
+    // needs its own registry operation.
+    for (size_t i = 0; i < ctx.extrapolator->size(); ++i) {
+        auto builder = (*reg_op_ctx.make_reg_op_builder)(registry);
+
+        // Add all _create_ operations first so all entities are created in the extrapolator
+        // before components are inserted. This will ensure entities will be available in the
+        // entity map ready to be used in child entity mapping for all entity properties of
+        // all components.
+        for (auto entity : entities) {
+            builder->create(entity);
+        }
 
-    for (auto entity : entities) {
-        builder->emplace_all(entity);
-    }
+        for (auto entity : entities) {
+            builder->emplace_all(entity);
+        }
 
-    auto op = builder->finish();
-    auto &dispatcher = message_dispatcher::global();
-    dispatcher.send<extrapolation_operation_create>(
-        {"extrapolation_worker"}, ctx.message_queue.identifier,
-        std::move(op), owned_entities);
+        auto op = builder->finish();
+        dispatcher.send<extrapolation_operation_create>(
+            ctx.extrapolator->queue_identifier(i), ctx.message_queue.identifier,
+            std::move(op), owned_entities);
+    }
 }
 
 void remove_entities_from_extrapolator(entt::registry &registry,
                                        const std::vector<entt::entity> &entities) {
     auto &ctx = registry.ctx().get<client_network_context>();
-    auto &dispatcher = message_dispatcher::global();
-    dispatcher.send<extrapolation_operation_destroy>(
-        {"extrapolation_worker"}, ctx.message_queue.identifier, entities);
+    ctx.extrapolator->remove_entities(ctx.message_queue.identifier, entities);
+
+    for (auto entity : entities) {
+        ctx.extrapolation_start_times.erase(entity);
+    }
 }
 
 static void process_created_entities(entt::registry &registry) {
@@ -289,12 +311,8 @@ static void dispatch_extrapolations(entt::registry &registry) {
         return;
     }
 
-    auto &dispatcher = message_dispatcher::global();
-
     for (auto &req : ctx.pending_extrapolations) {
-        dispatcher.send<extrapolation_request>({"extrapolation_worker"},
-                                               ctx.message_queue.identifier,
-                                               std::move(req));
+        ctx.extrapolator->request_extrapolation(ctx.message_queue.identifier, std::move(req));
     }
 
     ctx.pending_extrapolations.clear();
@@ -755,8 +773,11 @@ static void process_packet(entt::registry &registry, packet::registry_snapshot &
     auto &req = ctx.pending_extrapolations.emplace_back();
     req.start_time = snapshot_time;
 
-    if (settings.execution_mode == edyn::execution_mode::asynchronous) {
-        // Send extrapolation result directly to simulation worker.
+    if (settings.execution_mode == edyn::execution_mode::asynchronous &&
+        ctx.extrapolator->size() == 1) {
+        // Send extrapolation result directly to simulation worker. With
+        // multiple extrapolation workers, results go through the main thread
+        // first to be put in order.
         req.destination = {"worker"};
     } else {
         req.destination = ctx.message_queue.identifier;
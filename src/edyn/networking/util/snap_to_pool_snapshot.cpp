@@ -6,14 +6,12 @@
 #include "edyn/sys/update_aabbs.hpp"
 #include "edyn/sys/update_inertias.hpp"
 #include "edyn/sys/update_origins.hpp"
-#include "edyn/sys/update_rotated_meshes.hpp"
 #include "edyn/util/island_util.hpp"
 
 namespace edyn {
 
 void post_snap_update(entt::registry &registry, const std::vector<entt::entity> &entities) {
     update_origins(registry, entities);
-    update_rotated_meshes(registry, entities);
     update_aabbs(registry, entities);
     auto island_entities = collect_islands_from_residents(registry, entities);
     update_island_aabbs(registry, island_entities);
@@ -0,0 +1,38 @@
+#include "edyn/replication/transform_sync.hpp"
+#include "edyn/comp/merge_component.hpp"
+#include "edyn/config/config.h"
+#include <entt/entity/registry.hpp>
+
+namespace edyn {
+
+template<typename Component>
+static void apply_transform_sync_component(entt::registry &registry,
+                                           const std::vector<entt::entity> &entities,
+                                           const std::vector<Component> &components) {
+    EDYN_ASSERT(entities.size() == components.size());
+    auto &storage = registry.storage<Component>();
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        auto entity = entities[i];
+
+        // The entity could've been destroyed in the main registry after the
+        // worker exported it.
+        if (!storage.contains(entity)) {
+            continue;
+        }
+
+        storage.patch(entity, [&](auto &&current) {
+            merge_component(current, components[i]);
+        });
+    }
+}
+
+void apply_transform_sync(entt::registry &registry, const transform_sync_buffer &buffer) {
+    // Apply one component type at a time so each pass touches a single pool.
+    apply_transform_sync_component(registry, buffer.entities, buffer.positions);
+    apply_transform_sync_component(registry, buffer.entities, buffer.orientations);
+    apply_transform_sync_component(registry, buffer.entities, buffer.linvels);
+    apply_transform_sync_component(registry, buffer.entities, buffer.angvels);
+}
+
+}
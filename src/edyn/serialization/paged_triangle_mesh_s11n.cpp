@@ -14,6 +14,13 @@
 
 namespace edyn {
 
+// Identifies paged triangle mesh files. The version must be incremented
+// whenever the layout changes. Version 2 fixed the embedded submesh offsets,
+// which were calculated with the wrong size for the vector size prefix.
+// Version 3 stores static tree nodes in compact form.
+constexpr uint32_t paged_triangle_mesh_file_magic = 0x4d504445; // "EDPM"
+constexpr uint32_t paged_triangle_mesh_file_version = 3;
+
 std::string get_submesh_path(const std::string &paged_triangle_mesh_path, size_t index) {
     auto submesh_path = paged_triangle_mesh_path;
     auto dot_pos = submesh_path.rfind('.');
@@ -47,6 +54,11 @@ void serialize(paged_triangle_mesh_file_output_archive &archive,
 
     archive.m_triangle_mesh_index = 0;
 
+    auto magic = paged_triangle_mesh_file_magic;
+    auto version = paged_triangle_mesh_file_version;
+    archive(magic);
+    archive(version);
+
     archive(paged_tri_mesh.m_thickness);
     archive(paged_tri_mesh.m_tree);
     auto num_submeshes = paged_tri_mesh.m_cache.size();
@@ -75,6 +87,30 @@ void serialize(paged_triangle_mesh_file_output_archive &archive,
 
 void serialize(paged_triangle_mesh_file_input_archive &archive,
                paged_triangle_mesh &paged_tri_mesh) {
+    uint32_t magic = 0, version = 0;
+
+    if (archive.is_file_open()) {
+        archive(magic);
+    }
+
+    if (archive.is_file_open() && !archive.is_file_at_end()) {
+        archive(version);
+    }
+
+    // Reject files without a header, which were written by older versions
+    // whose embedded offsets are wrong, and files written by newer versions.
+    // The mesh is left empty.
+    archive.m_valid = !archive.is_file_at_end() &&
+                      magic == paged_triangle_mesh_file_magic &&
+                      version == paged_triangle_mesh_file_version;
+
+    if (!archive.m_valid) {
+        paged_tri_mesh.m_tree = {};
+        paged_tri_mesh.m_cache.clear();
+        paged_tri_mesh.init_cache();
+        return;
+    }
+
     archive(paged_tri_mesh.m_thickness);
     archive(paged_tri_mesh.m_tree);
 
@@ -98,14 +134,11 @@ void serialize(paged_triangle_mesh_file_input_archive &archive,
         }
 
         archive.m_base_offset = archive.tell_position();
+        archive.m_mapped_file.open(archive.m_path);
     }
 
-    // Resize LRU queue to have the number of submeshes.
-    paged_tri_mesh.m_lru_indices.resize(num_submeshes);
-    std::iota(paged_tri_mesh.m_lru_indices.begin(),
-              paged_tri_mesh.m_lru_indices.end(), 0);
-
-    paged_tri_mesh.m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(num_submeshes);
+    // Set up LRU list and cache accounting for the new set of submeshes.
+    paged_tri_mesh.init_cache();
 }
 
 
@@ -130,10 +163,20 @@ void load_mesh_context::load(unsigned start, unsigned end) {
     auto mesh = std::make_shared<triangle_mesh>();
 
     switch(input->m_mode) {
-    case paged_triangle_mesh_serialization_mode::embedded:
-        input->seek_position(input->m_base_offset + input->m_offsets[m_index]);
-        serialize(*input, *mesh);
+    case paged_triangle_mesh_serialization_mode::embedded: {
+        auto offset = input->m_base_offset + input->m_offsets[m_index];
+        auto &file = input->m_mapped_file;
+
+        if (file.is_open()) {
+            EDYN_ASSERT(offset < file.size());
+            auto archive = memory_input_archive(file.data() + offset, file.size() - offset);
+            serialize(archive, *mesh);
+        } else {
+            input->seek_position(offset);
+            serialize(*input, *mesh);
+        }
         break;
+    }
     case paged_triangle_mesh_serialization_mode::external: {
         auto tri_mesh_path = get_submesh_path(input->m_path, m_index);
         auto tri_mesh_archive = file_input_archive(tri_mesh_path);
@@ -0,0 +1,64 @@
+#include "edyn/serialization/mapped_file.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace edyn {
+
+bool mapped_file::open(const std::string &path) {
+    close();
+
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty files cannot be mapped.
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        m_open = true;
+        return true;
+    }
+
+    auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping) {
+        return false;
+    }
+
+    auto *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // The view keeps the mapping object alive.
+    CloseHandle(mapping);
+
+    if (!ptr) {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t *>(ptr);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+
+    return true;
+}
+
+void mapped_file::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    m_open = false;
+}
+
+}
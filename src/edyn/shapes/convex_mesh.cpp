@@ -162,23 +162,26 @@ void convex_mesh::calculate_edges() {
 }
 
 void convex_mesh::calculate_neighbors() {
-    neighbors_start.push_back(0);
-    uint32_t neighbor_count = 0;
-
-    for (size_t vertex_idx = 0; vertex_idx < vertices.size(); ++vertex_idx) {
-        // Find all edges that contain this vertex and add the other vertex to
-        // the list of neighbors.
-        for (size_t edge_idx = 0; edge_idx < num_edges(); ++edge_idx) {
-            auto edge_vertices = get_edge_vertices(edge_idx);
-
-            if (edge_vertices[0] == vertex_idx || edge_vertices[1] == vertex_idx) {
-                auto neighbor_idx = edge_vertices[0] == vertex_idx ? edge_vertices[1] : edge_vertices[0];
-                neighbor_indices.push_back(neighbor_idx);
-                ++neighbor_count;
-            }
-        }
+    // Build a compressed adjacency list from the edges. Count the neighbors
+    // of each vertex, accumulate the counts to obtain the start of each
+    // range, then fill in the ranges.
+    neighbors_start.assign(vertices.size() + 1, 0);
+
+    for (auto vertex_idx : edges) {
+        ++neighbors_start[vertex_idx + 1];
+    }
 
-        neighbors_start.push_back(neighbor_count);
+    for (size_t i = 1; i < neighbors_start.size(); ++i) {
+        neighbors_start[i] += neighbors_start[i - 1];
+    }
+
+    neighbor_indices.resize(edges.size());
+    auto insert_pos = std::vector<uint32_t>(neighbors_start.begin(), neighbors_start.end() - 1);
+
+    for (size_t edge_idx = 0; edge_idx < num_edges(); ++edge_idx) {
+        auto edge_vertices = get_edge_vertices(edge_idx);
+        neighbor_indices[insert_pos[edge_vertices[0]]++] = edge_vertices[1];
+        neighbor_indices[insert_pos[edge_vertices[1]]++] = edge_vertices[0];
     }
 }
 
@@ -0,0 +1,466 @@
+#include "edyn/shapes/heightfield.hpp"
+#include <algorithm>
+
+namespace edyn {
+
+heightfield::heightfield(size_t num_columns, size_t num_rows, vector2 cell_size,
+                         vector3 origin, bool quantized, size_t page_size)
+    : m_num_columns(num_columns)
+    , m_num_rows(num_rows)
+    , m_cell_size(cell_size)
+    , m_origin(origin)
+    , m_quantized(quantized)
+    , m_page_size(page_size)
+{
+    EDYN_ASSERT(num_columns > 1 && num_rows > 1);
+    EDYN_ASSERT(cell_size.x > 0 && cell_size.y > 0);
+    EDYN_ASSERT(page_size > 0);
+
+    m_num_page_columns = (num_columns - 2) / page_size + 1;
+    m_num_page_rows = (num_rows - 2) / page_size + 1;
+    m_pages.resize(m_num_page_columns * m_num_page_rows);
+    init_cache();
+}
+
+void heightfield::init_cache() {
+    auto lock = std::lock_guard(m_lru_mutex);
+    auto num_pages = m_pages.size();
+
+    m_lru_prev.assign(num_pages, lru_null);
+    m_lru_next.assign(num_pages, lru_null);
+    m_lru_head = m_lru_tail = lru_null;
+    m_is_loading_page = std::make_unique<std::atomic<bool>[]>(num_pages);
+
+    for (auto &node : m_pages) {
+        node.data.reset();
+        node.num_bytes = 0;
+    }
+
+    m_cache_num_bytes.store(0, std::memory_order_relaxed);
+}
+
+void heightfield::init_heights(const std::vector<scalar> &heights) {
+    EDYN_ASSERT(heights.size() == m_num_columns * m_num_rows);
+    EDYN_ASSERT(!m_page_loader);
+
+    auto [min_it, max_it] = std::minmax_element(heights.begin(), heights.end());
+    m_min_height = *min_it;
+    m_max_height = *max_it;
+    m_quantization_step = (m_max_height - m_min_height) / scalar(std::numeric_limits<uint16_t>::max());
+
+    auto page_heights = std::vector<scalar>{};
+
+    for (size_t page_idx = 0; page_idx < m_pages.size(); ++page_idx) {
+        auto ext = get_page_extent(page_idx);
+        page_heights.clear();
+
+        for (size_t row = ext.row; row < ext.row + ext.num_rows; ++row) {
+            auto first = heights.begin() + row * m_num_columns + ext.column;
+            page_heights.insert(page_heights.end(), first, first + ext.num_columns);
+        }
+
+        assign_page(page_idx, page_heights);
+    }
+}
+
+void heightfield::set_page_loader(std::shared_ptr<heightfield_page_loader_base> loader,
+                                  scalar min_height, scalar max_height) {
+    EDYN_ASSERT(min_height <= max_height);
+    m_page_loader = loader;
+    m_min_height = min_height;
+    m_max_height = max_height;
+    m_quantization_step = (max_height - min_height) / scalar(std::numeric_limits<uint16_t>::max());
+    init_cache();
+}
+
+heightfield::page_extent heightfield::get_page_extent(size_t page_idx) const {
+    EDYN_ASSERT(page_idx < m_pages.size());
+    auto ext = page_extent{};
+    ext.column = (page_idx % m_num_page_columns) * m_page_size;
+    ext.row = (page_idx / m_num_page_columns) * m_page_size;
+    // Pages share the samples on their borders.
+    ext.num_columns = std::min(m_page_size, m_num_columns - 1 - ext.column) + 1;
+    ext.num_rows = std::min(m_page_size, m_num_rows - 1 - ext.row) + 1;
+    return ext;
+}
+
+size_t heightfield::page_num_bytes(size_t page_idx) const {
+    auto ext = get_page_extent(page_idx);
+    auto sample_size = m_quantized ? sizeof(uint16_t) : sizeof(scalar);
+    return sizeof(page) + ext.num_columns * ext.num_rows * sample_size;
+}
+
+void heightfield::assign_page(size_t page_idx, const std::vector<scalar> &heights) {
+    auto ext = get_page_extent(page_idx);
+    EDYN_ASSERT(heights.size() == ext.num_columns * ext.num_rows);
+
+    auto pg = std::make_shared<page>();
+
+    if (m_quantized) {
+        // All pages use the same quantization parameters so the samples
+        // on shared borders are decoded to the same height.
+        const auto max_value = scalar(std::numeric_limits<uint16_t>::max());
+        pg->quantized_heights.reserve(heights.size());
+
+        for (auto h : heights) {
+            auto value = m_quantization_step > 0 ? std::round((h - m_min_height) / m_quantization_step) : scalar(0);
+            pg->quantized_heights.push_back(static_cast<uint16_t>(std::clamp(value, scalar(0), max_value)));
+        }
+    } else {
+        pg->heights = heights;
+    }
+
+    // Use lock to prevent assigning to the same page shared_ptr concurrently
+    // if `unload_least_recently_visited_page` is executing in another thread.
+    auto lock = std::lock_guard(m_lru_mutex);
+    auto &node = m_pages[page_idx];
+
+    if (lru_contains(page_idx)) {
+        m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+    } else {
+        lru_push_front(page_idx);
+    }
+
+    node.data = pg;
+    node.num_bytes = page_num_bytes(page_idx);
+    m_cache_num_bytes.fetch_add(node.num_bytes, std::memory_order_relaxed);
+    m_is_loading_page[page_idx].store(false, std::memory_order_release);
+}
+
+bool heightfield::lru_contains(size_t page_idx) const {
+    return m_lru_head == page_idx || m_lru_prev[page_idx] != lru_null;
+}
+
+void heightfield::lru_push_front(size_t page_idx) {
+    EDYN_ASSERT(!lru_contains(page_idx));
+    m_lru_prev[page_idx] = lru_null;
+    m_lru_next[page_idx] = m_lru_head;
+
+    if (m_lru_head != lru_null) {
+        m_lru_prev[m_lru_head] = page_idx;
+    } else {
+        m_lru_tail = page_idx;
+    }
+
+    m_lru_head = page_idx;
+}
+
+void heightfield::lru_unlink(size_t page_idx) {
+    EDYN_ASSERT(lru_contains(page_idx));
+    auto prev = m_lru_prev[page_idx];
+    auto next = m_lru_next[page_idx];
+
+    if (prev != lru_null) {
+        m_lru_next[prev] = next;
+    } else {
+        m_lru_head = next;
+    }
+
+    if (next != lru_null) {
+        m_lru_prev[next] = prev;
+    } else {
+        m_lru_tail = prev;
+    }
+
+    m_lru_prev[page_idx] = m_lru_next[page_idx] = lru_null;
+}
+
+void heightfield::load_page_if_needed(size_t page_idx) {
+    if (!m_page_loader) {
+        return;
+    }
+
+    EDYN_ASSERT(page_idx < m_pages.size());
+    auto already_loading = m_is_loading_page[page_idx].exchange(true, std::memory_order_relaxed);
+
+    if (already_loading) {
+        return;
+    }
+
+    // Make copy of shared_ptr to increment reference count and avoid concurrent deallocation.
+    auto pg = m_pages[page_idx].data;
+
+    if (pg) {
+        m_is_loading_page[page_idx].store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    auto num_bytes = page_num_bytes(page_idx);
+
+    while (cache_num_bytes() + num_bytes > m_max_cache_num_bytes) {
+        if (!unload_least_recently_visited_page()) {
+            break;
+        }
+    }
+
+    m_page_loader->load(this, page_idx);
+}
+
+void heightfield::mark_recent_visit(size_t page_idx) {
+    if (!m_page_loader) {
+        return;
+    }
+
+    auto lock = std::lock_guard(m_lru_mutex);
+
+    // Page could have been unloaded in another thread after being visited.
+    if (m_lru_head != page_idx && lru_contains(page_idx)) {
+        lru_unlink(page_idx);
+        lru_push_front(page_idx);
+    }
+}
+
+bool heightfield::unload_least_recently_visited_page() {
+    auto lock = std::lock_guard(m_lru_mutex);
+
+    if (m_lru_tail == lru_null) {
+        return false;
+    }
+
+    auto page_idx = m_lru_tail;
+    lru_unlink(page_idx);
+
+    auto &node = m_pages[page_idx];
+    node.data.reset();
+    m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+    node.num_bytes = 0;
+
+    return true;
+}
+
+void heightfield::clear_cache() {
+    if (!m_page_loader) {
+        return;
+    }
+
+    auto lock = std::lock_guard(m_lru_mutex);
+
+    while (m_lru_head != lru_null) {
+        auto &node = m_pages[m_lru_head];
+        node.data.reset();
+        node.num_bytes = 0;
+        lru_unlink(m_lru_head);
+    }
+
+    m_cache_num_bytes.store(0, std::memory_order_relaxed);
+}
+
+void heightfield::prefetch(const AABB &aabb) {
+    size_t column_begin, column_end, row_begin, row_end;
+
+    if (!get_cell_range(aabb, column_begin, column_end, row_begin, row_end)) {
+        return;
+    }
+
+    for (auto page_row = row_begin / m_page_size; page_row <= (row_end - 1) / m_page_size; ++page_row) {
+        for (auto page_column = column_begin / m_page_size; page_column <= (column_end - 1) / m_page_size; ++page_column) {
+            load_page_if_needed(page_row * m_num_page_columns + page_column);
+        }
+    }
+}
+
+AABB heightfield::get_aabb() const {
+    auto extent = vector3{
+        scalar(m_num_columns - 1) * m_cell_size.x,
+        0,
+        scalar(m_num_rows - 1) * m_cell_size.y
+    };
+    return {
+        m_origin + vector3{0, m_min_height, 0},
+        m_origin + extent + vector3{0, m_max_height, 0}
+    };
+}
+
+bool heightfield::get_cell_range(const AABB &aabb, size_t &column_begin, size_t &column_end,
+                                 size_t &row_begin, size_t &row_end) const {
+    if (aabb.min.y > m_origin.y + m_max_height || aabb.max.y < m_origin.y + m_min_height) {
+        return false;
+    }
+
+    const auto num_cell_columns = m_num_columns - 1;
+    const auto num_cell_rows = m_num_rows - 1;
+    auto min_column = (aabb.min.x - m_origin.x) / m_cell_size.x;
+    auto max_column = (aabb.max.x - m_origin.x) / m_cell_size.x;
+    auto min_row = (aabb.min.z - m_origin.z) / m_cell_size.y;
+    auto max_row = (aabb.max.z - m_origin.z) / m_cell_size.y;
+
+    if (max_column < 0 || min_column > scalar(num_cell_columns) ||
+        max_row < 0 || min_row > scalar(num_cell_rows)) {
+        return false;
+    }
+
+    column_begin = std::min(static_cast<size_t>(std::max(min_column, scalar(0))), num_cell_columns - 1);
+    column_end = std::min(static_cast<size_t>(max_column) + 1, num_cell_columns);
+    row_begin = std::min(static_cast<size_t>(std::max(min_row, scalar(0))), num_cell_rows - 1);
+    row_end = std::min(static_cast<size_t>(max_row) + 1, num_cell_rows);
+
+    return true;
+}
+
+scalar heightfield::get_height(size_t column, size_t row) const {
+    EDYN_ASSERT(column < m_num_columns && row < m_num_rows);
+    auto page_idx = get_cell_page_index(std::min(column, m_num_columns - 2),
+                                        std::min(row, m_num_rows - 2));
+    auto pg = m_pages[page_idx].data;
+    EDYN_ASSERT(pg);
+    auto ext = get_page_extent(page_idx);
+    return page_height(*pg, (row - ext.row) * ext.num_columns + (column - ext.column));
+}
+
+bool heightfield::sample_height(size_t column, size_t row, const page &pg,
+                                const page_extent &ext, scalar &height) const {
+    if (column >= ext.column && column < ext.column + ext.num_columns &&
+        row >= ext.row && row < ext.row + ext.num_rows) {
+        height = page_height(pg, (row - ext.row) * ext.num_columns + (column - ext.column));
+        return true;
+    }
+
+    auto page_idx = get_cell_page_index(std::min(column, m_num_columns - 2),
+                                        std::min(row, m_num_rows - 2));
+    auto other = m_pages[page_idx].data;
+
+    if (!other) {
+        return false;
+    }
+
+    auto other_ext = get_page_extent(page_idx);
+    height = page_height(*other, (row - other_ext.row) * other_ext.num_columns + (column - other_ext.column));
+    return true;
+}
+
+bool heightfield::triangle_heights(size_t column, size_t row, size_t k, const page &pg,
+                                   const page_extent &ext, std::array<scalar, 3> &heights) const {
+    if (k == 0) {
+        return sample_height(column, row, pg, ext, heights[0]) &&
+               sample_height(column, row + 1, pg, ext, heights[1]) &&
+               sample_height(column + 1, row + 1, pg, ext, heights[2]);
+    }
+
+    return sample_height(column, row, pg, ext, heights[0]) &&
+           sample_height(column + 1, row + 1, pg, ext, heights[1]) &&
+           sample_height(column + 1, row, pg, ext, heights[2]);
+}
+
+void heightfield::fill_packed_triangle(size_t column, size_t row, size_t k, const page &pg,
+                                       const page_extent &ext, packed_triangle &tri) const {
+    const auto num_cell_columns = m_num_columns - 1;
+    const auto num_cell_rows = m_num_rows - 1;
+    const auto cell_idx = row * num_cell_columns + column;
+    const auto num_horizontal_edges = m_num_rows * num_cell_columns;
+    const auto num_vertical_edges = num_cell_rows * m_num_columns;
+
+    auto horizontal_edge = [&](size_t i, size_t j) {
+        return static_cast<index_type>(j * num_cell_columns + i);
+    };
+    auto vertical_edge = [&](size_t i, size_t j) {
+        return static_cast<index_type>(num_horizontal_edges + j * m_num_columns + i);
+    };
+    auto diagonal_edge = static_cast<index_type>(num_horizontal_edges + num_vertical_edges + cell_idx);
+
+    // Neighboring triangle across each edge, as cell column, cell row and
+    // triangle in cell. Negative column or row means there's no neighbor.
+    struct neighbor { std::ptrdiff_t column, row; size_t k; };
+    std::array<neighbor, 3> neighbors;
+    std::array<std::array<size_t, 2>, 3> coords;
+    const auto c = static_cast<std::ptrdiff_t>(column);
+    const auto r = static_cast<std::ptrdiff_t>(row);
+    const auto last_column = static_cast<std::ptrdiff_t>(num_cell_columns) - 1;
+    const auto last_row = static_cast<std::ptrdiff_t>(num_cell_rows) - 1;
+
+    if (k == 0) {
+        coords = {{{column, row}, {column, row + 1}, {column + 1, row + 1}}};
+        tri.edge_indices = {vertical_edge(column, row), horizontal_edge(column, row + 1), diagonal_edge};
+        neighbors = {{
+            {c > 0 ? c - 1 : -1, r, 1},
+            {c, r < last_row ? r + 1 : -1, 1},
+            {c, r, 1}
+        }};
+    } else {
+        coords = {{{column, row}, {column + 1, row + 1}, {column + 1, row}}};
+        tri.edge_indices = {diagonal_edge, vertical_edge(column + 1, row), horizontal_edge(column, row)};
+        neighbors = {{
+            {c, r, 0},
+            {c < last_column ? c + 1 : -1, r, 0},
+            {c, r > 0 ? r - 1 : -1, 0}
+        }};
+    }
+
+    std::array<scalar, 3> heights;
+    [[maybe_unused]] auto loaded = triangle_heights(column, row, k, pg, ext, heights);
+    EDYN_ASSERT(loaded);
+
+    for (size_t i = 0; i < 3; ++i) {
+        tri.vertices[i] = sample_position(coords[i][0], coords[i][1], heights[i]);
+        tri.vertex_indices[i] = static_cast<index_type>(coords[i][1] * m_num_columns + coords[i][0]);
+    }
+
+    tri.normal = triangle_normal(tri.vertices);
+    tri.convex_edges = 0;
+
+    for (size_t i = 0; i < 3; ++i) {
+        auto edge_dir = tri.vertices[(i + 1) % 3] - tri.vertices[i];
+        auto edge_normal = cross(tri.normal, edge_dir);
+        auto &nb = neighbors[i];
+        std::array<scalar, 3> other_heights;
+
+        if (nb.column >= 0 && nb.row >= 0 &&
+            triangle_heights(size_t(nb.column), size_t(nb.row), nb.k, pg, ext, other_heights)) {
+            scalar cell_heights[2][2];
+
+            if (nb.k == 0) {
+                cell_heights[0][0] = other_heights[0];
+                cell_heights[0][1] = other_heights[1];
+                cell_heights[1][1] = other_heights[2];
+            } else {
+                cell_heights[0][0] = other_heights[0];
+                cell_heights[1][1] = other_heights[1];
+                cell_heights[1][0] = other_heights[2];
+            }
+
+            auto other_vertices = cell_triangle_vertices(size_t(nb.column), size_t(nb.row), nb.k, cell_heights);
+            auto other_normal = triangle_normal(other_vertices);
+            tri.adjacent_normals[i] = other_normal;
+
+            if (dot(other_normal, edge_normal) < -EDYN_EPSILON) {
+                tri.convex_edges |= uint8_t(1) << i;
+            }
+        } else {
+            // Boundary edge, or the neighbor is in a page that is not loaded.
+            // Same treatment as boundary edges in `triangle_mesh`.
+            tri.adjacent_normals[i] = -normalize(tri.normal + edge_normal * 0.1);
+            tri.convex_edges |= uint8_t(1) << i;
+        }
+    }
+}
+
+packed_triangle heightfield::make_packed_triangle(size_t tri_idx) const {
+    EDYN_ASSERT(tri_idx < num_triangles());
+    auto cell_idx = tri_idx / 2;
+    auto column = cell_idx % (m_num_columns - 1);
+    auto row = cell_idx / (m_num_columns - 1);
+    auto page_idx = get_cell_page_index(column, row);
+    auto pg = m_pages[page_idx].data;
+    EDYN_ASSERT(pg);
+
+    auto tri = packed_triangle{};
+    fill_packed_triangle(column, row, tri_idx % 2, *pg, get_page_extent(page_idx), tri);
+    return tri;
+}
+
+triangle_vertices heightfield::get_triangle_vertices(size_t tri_idx) const {
+    EDYN_ASSERT(tri_idx < num_triangles());
+    auto cell_idx = tri_idx / 2;
+    auto column = cell_idx % (m_num_columns - 1);
+    auto row = cell_idx / (m_num_columns - 1);
+    scalar heights[2][2] = {
+        {get_height(column, row), get_height(column, row + 1)},
+        {get_height(column + 1, row), get_height(column + 1, row + 1)}
+    };
+    return cell_triangle_vertices(column, row, tri_idx % 2, heights);
+}
+
+vector3 heightfield::get_triangle_normal(size_t tri_idx) const {
+    return triangle_normal(get_triangle_vertices(tri_idx));
+}
+
+}
@@ -1,11 +1,11 @@
 #include "edyn/shapes/paged_triangle_mesh.hpp"
 #include "edyn/parallel/message.hpp"
 #include <atomic>
-#include <limits>
 #include <mutex>
 #include <entt/entity/registry.hpp>
 #include "edyn/parallel/message_dispatcher.hpp"
 #include "edyn/shapes/triangle_mesh.hpp"
+#include "edyn/serialization/triangle_mesh_s11n.hpp"
 #include "edyn/util/paged_mesh_load_reporting.hpp"
 
 namespace edyn {
@@ -15,18 +15,72 @@ paged_triangle_mesh::paged_triangle_mesh(std::shared_ptr<triangle_mesh_page_load
 {
 }
 
-size_t paged_triangle_mesh::cache_num_vertices() const {
-    size_t count = 0;
+void paged_triangle_mesh::init_cache() {
+    auto lock = std::lock_guard(m_lru_mutex);
+    auto num_submeshes = m_cache.size();
 
-    for (auto &node : m_cache) {
-        if (!node.trimesh) {
-            continue;
+    m_lru_prev.assign(num_submeshes, lru_null);
+    m_lru_next.assign(num_submeshes, lru_null);
+    m_lru_head = m_lru_tail = lru_null;
+    m_is_loading_submesh = std::make_unique<std::atomic<bool>[]>(num_submeshes);
+
+    size_t num_vertices = 0;
+    size_t num_bytes = 0;
+
+    // Submeshes might have been loaded already during creation.
+    for (size_t i = 0; i < num_submeshes; ++i) {
+        auto &node = m_cache[i];
+
+        if (node.trimesh) {
+            node.num_bytes = serialization_sizeof(*node.trimesh);
+            num_vertices += node.num_vertices;
+            num_bytes += node.num_bytes;
+            lru_push_front(i);
+        } else {
+            node.num_bytes = 0;
         }
+    }
+
+    m_cache_num_vertices.store(num_vertices, std::memory_order_relaxed);
+    m_cache_num_bytes.store(num_bytes, std::memory_order_relaxed);
+}
+
+bool paged_triangle_mesh::lru_contains(size_t trimesh_idx) const {
+    return m_lru_head == trimesh_idx || m_lru_prev[trimesh_idx] != lru_null;
+}
+
+void paged_triangle_mesh::lru_push_front(size_t trimesh_idx) {
+    EDYN_ASSERT(!lru_contains(trimesh_idx));
+    m_lru_prev[trimesh_idx] = lru_null;
+    m_lru_next[trimesh_idx] = m_lru_head;
 
-        count += node.num_vertices;
+    if (m_lru_head != lru_null) {
+        m_lru_prev[m_lru_head] = trimesh_idx;
+    } else {
+        m_lru_tail = trimesh_idx;
     }
 
-    return count;
+    m_lru_head = trimesh_idx;
+}
+
+void paged_triangle_mesh::lru_unlink(size_t trimesh_idx) {
+    EDYN_ASSERT(lru_contains(trimesh_idx));
+    auto prev = m_lru_prev[trimesh_idx];
+    auto next = m_lru_next[trimesh_idx];
+
+    if (prev != lru_null) {
+        m_lru_next[prev] = next;
+    } else {
+        m_lru_head = next;
+    }
+
+    if (next != lru_null) {
+        m_lru_prev[next] = prev;
+    } else {
+        m_lru_tail = prev;
+    }
+
+    m_lru_prev[trimesh_idx] = m_lru_next[trimesh_idx] = lru_null;
 }
 
 void paged_triangle_mesh::load_node_if_needed(size_t trimesh_idx) {
@@ -50,8 +104,11 @@ void paged_triangle_mesh::load_node_if_needed(size_t trimesh_idx) {
 
     // Load triangle mesh into cache. Clear cache if it would go
     // above limits.
-    while (cache_num_vertices() + node.num_vertices > m_max_cache_num_vertices) {
-        unload_least_recently_visited_node();
+    while (cache_num_vertices() + node.num_vertices > m_max_cache_num_vertices ||
+           cache_num_bytes() > m_max_cache_num_bytes) {
+        if (!unload_least_recently_visited_node()) {
+            break;
+        }
     }
 
     m_page_loader->load(this, trimesh_idx);
@@ -59,22 +116,33 @@ void paged_triangle_mesh::load_node_if_needed(size_t trimesh_idx) {
 
 void paged_triangle_mesh::mark_recent_visit(size_t trimesh_idx) {
     auto lock = std::lock_guard(m_lru_mutex);
-    auto it = std::find(m_lru_indices.begin(), m_lru_indices.end(), trimesh_idx);
-    std::rotate(m_lru_indices.begin(), it, it + 1);
+
+    // Node could have been unloaded in another thread after being visited.
+    if (m_lru_head != trimesh_idx && lru_contains(trimesh_idx)) {
+        lru_unlink(trimesh_idx);
+        lru_push_front(trimesh_idx);
+    }
 }
 
-void paged_triangle_mesh::unload_least_recently_visited_node() {
+bool paged_triangle_mesh::unload_least_recently_visited_node(size_t keep_idx) {
     auto lock = std::lock_guard(m_lru_mutex);
 
-    for (auto it = m_lru_indices.rbegin(); it != m_lru_indices.rend(); ++it) {
-        auto &node = m_cache[*it];
-
-        if (node.trimesh) {
-            node.trimesh.reset();
-            message_dispatcher::global().send<msg::paged_triangle_mesh_load_page>({internal::paged_mesh_load_queue_identifier}, {}, this, *it);
-            break;
-        }
+    if (m_lru_tail == lru_null || m_lru_tail == keep_idx) {
+        return false;
     }
+
+    auto trimesh_idx = m_lru_tail;
+    lru_unlink(trimesh_idx);
+
+    auto &node = m_cache[trimesh_idx];
+    node.trimesh.reset();
+    m_cache_num_vertices.fetch_sub(node.num_vertices, std::memory_order_relaxed);
+    m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+    node.num_bytes = 0;
+
+    message_dispatcher::global().send<msg::paged_triangle_mesh_load_page>({internal::paged_mesh_load_queue_identifier}, {}, this, trimesh_idx);
+
+    return true;
 }
 
 triangle_vertices paged_triangle_mesh::get_triangle_vertices(size_t mesh_idx, size_t tri_idx) const {
@@ -84,19 +152,50 @@ triangle_vertices paged_triangle_mesh::get_triangle_vertices(size_t mesh_idx, si
 }
 
 void paged_triangle_mesh::clear_cache() {
-    for (auto &node : m_cache) {
+    auto lock = std::lock_guard(m_lru_mutex);
+
+    while (m_lru_head != lru_null) {
+        auto &node = m_cache[m_lru_head];
         node.trimesh.reset();
+        node.num_bytes = 0;
+        lru_unlink(m_lru_head);
     }
+
+    m_cache_num_vertices.store(0, std::memory_order_relaxed);
+    m_cache_num_bytes.store(0, std::memory_order_relaxed);
 }
 
 void paged_triangle_mesh::assign_mesh(size_t index, std::shared_ptr<triangle_mesh> mesh) {
-    // Use lock to prevent assigning to the same trimesh shared_ptr concurrently
-    // if `unload_least_recently_visited_node` is executing in another thread.
-    auto lock = std::lock_guard(m_lru_mutex);
-    m_cache[index].trimesh = mesh;
-    mesh->set_thickness(m_thickness);
-    m_is_loading_submesh[index].store(false, std::memory_order_release);
+    {
+        // Use lock to prevent assigning to the same trimesh shared_ptr concurrently
+        // if `unload_least_recently_visited_node` is executing in another thread.
+        auto lock = std::lock_guard(m_lru_mutex);
+        auto &node = m_cache[index];
+
+        if (lru_contains(index)) {
+            m_cache_num_bytes.fetch_sub(node.num_bytes, std::memory_order_relaxed);
+        } else {
+            m_cache_num_vertices.fetch_add(node.num_vertices, std::memory_order_relaxed);
+            lru_push_front(index);
+        }
+
+        node.trimesh = mesh;
+        node.num_bytes = serialization_sizeof(*mesh);
+        m_cache_num_bytes.fetch_add(node.num_bytes, std::memory_order_relaxed);
+        mesh->set_thickness(m_thickness);
+        m_is_loading_submesh[index].store(false, std::memory_order_release);
+    }
+
     message_dispatcher::global().send<msg::paged_triangle_mesh_load_page>({internal::paged_mesh_load_queue_identifier}, {}, this, index);
+
+    // The size in bytes of a node is only known once it's loaded, thus the
+    // new node could have taken the cache above the limit. Evict older nodes
+    // until it fits again, keeping the new node which is at the front.
+    while (cache_num_bytes() > m_max_cache_num_bytes) {
+        if (!unload_least_recently_visited_node(index)) {
+            break;
+        }
+    }
 }
 
 bool paged_triangle_mesh::has_per_vertex_friction() const {
@@ -2,7 +2,7 @@
 #include "edyn/comp/aabb.hpp"
 #include <array>
 #include <limits>
-#include <set>
+#include <algorithm>
 
 namespace edyn {
 
@@ -27,52 +27,131 @@ void triangle_mesh::calculate_face_normals() {
 
 void triangle_mesh::init_edge_indices() {
     constexpr auto idx_max = std::numeric_limits<index_type>::max();
-    m_face_edge_indices.resize(m_indices.size());
-    auto vertex_edge_indices = std::vector<std::set<index_type>>(m_vertices.size());
+    const auto num_vertices = m_vertices.size();
+    const auto num_half_edges = m_indices.size() * 3;
+
+    // Bucket the edge of each face (i.e. half-edges) by its smallest vertex
+    // index using a counting sort. Shared edges will end up in the same
+    // bucket.
+    auto bucket_starts = std::vector<index_type>(num_vertices + 1, 0);
+    auto half_edge_max = std::vector<index_type>(num_half_edges);
+
+    for (index_type half_edge_idx = 0; half_edge_idx < num_half_edges; ++half_edge_idx) {
+        auto &indices = m_indices[half_edge_idx / 3];
+        auto i = half_edge_idx % 3;
+        auto i0 = indices[i];
+        auto i1 = indices[(i + 1) % 3];
+        half_edge_max[half_edge_idx] = std::max(i0, i1);
+        ++bucket_starts[std::min(i0, i1) + 1];
+    }
 
-    for (size_t face_idx = 0; face_idx < m_indices.size(); ++face_idx) {
-        auto indices = m_indices[face_idx];
+    for (size_t i = 0; i < num_vertices; ++i) {
+        bucket_starts[i + 1] += bucket_starts[i];
+    }
 
-        for (size_t i = 0; i < 3; ++i) {
-            auto j = (i + 1) % 3;
-            auto i0 = indices[i];
-            auto i1 = indices[j];
-            auto pair = unordered_pair(i0, i1);
-            auto edge_idx = SIZE_MAX;
-
-            for (size_t k = 0; k < m_edge_vertex_indices.size(); ++k) {
-                if (m_edge_vertex_indices[k] == pair) {
-                    edge_idx = k;
-                    break;
-                }
+    auto bucket_half_edges = std::vector<index_type>(num_half_edges);
+
+    {
+        auto bucket_ends = std::vector<index_type>(bucket_starts.begin(), bucket_starts.end() - 1);
+
+        for (index_type half_edge_idx = 0; half_edge_idx < num_half_edges; ++half_edge_idx) {
+            auto &indices = m_indices[half_edge_idx / 3];
+            auto i = half_edge_idx % 3;
+            auto min_idx = std::min(indices[i], indices[(i + 1) % 3]);
+            bucket_half_edges[bucket_ends[min_idx]++] = half_edge_idx;
+        }
+    }
+
+    // Sort each bucket by the largest vertex index and then by half-edge
+    // index. Half-edges of the same edge become adjacent and the first one
+    // in each run is where the edge first appears. This is O(k log k) for a
+    // bucket of size k, thus high valence vertices such as the center of a
+    // fan do not degrade into a quadratic search.
+    auto first_half_edge = std::vector<index_type>(num_half_edges);
+
+    for (size_t vertex_idx = 0; vertex_idx < num_vertices; ++vertex_idx) {
+        auto begin = bucket_half_edges.begin() + bucket_starts[vertex_idx];
+        auto end = bucket_half_edges.begin() + bucket_starts[vertex_idx + 1];
+
+        std::sort(begin, end, [&](index_type lhs, index_type rhs) {
+            return half_edge_max[lhs] < half_edge_max[rhs] ||
+                  (half_edge_max[lhs] == half_edge_max[rhs] && lhs < rhs);
+        });
+
+        for (auto it = begin; it != end; ++it) {
+            if (it != begin && half_edge_max[*it] == half_edge_max[*(it - 1)]) {
+                first_half_edge[*it] = first_half_edge[*(it - 1)];
+            } else {
+                first_half_edge[*it] = *it;
             }
+        }
+    }
 
-            if (edge_idx == SIZE_MAX) {
-                edge_idx = m_edge_vertex_indices.size();
-                m_edge_vertex_indices.push_back(pair);
-                m_edge_face_indices.push_back({idx_max, idx_max});
+    // Assign edge indices in order of first appearance.
+    m_face_edge_indices.resize(m_indices.size());
+    auto vertex_num_edges = std::vector<index_type>(num_vertices + 1, 0);
+
+    for (index_type half_edge_idx = 0; half_edge_idx < num_half_edges; ++half_edge_idx) {
+        auto face_idx = half_edge_idx / 3;
+        auto i = half_edge_idx % 3;
+        auto first_idx = first_half_edge[half_edge_idx];
+        index_type edge_idx;
+
+        if (first_idx == half_edge_idx) {
+            auto i0 = m_indices[face_idx][i];
+            auto i1 = m_indices[face_idx][(i + 1) % 3];
+            edge_idx = static_cast<index_type>(m_edge_vertex_indices.size());
+            m_edge_vertex_indices.emplace_back(i0, i1);
+            m_edge_face_indices.push_back({idx_max, idx_max});
+            ++vertex_num_edges[i0 + 1];
+
+            if (i1 != i0) {
+                ++vertex_num_edges[i1 + 1];
             }
+        } else {
+            edge_idx = m_face_edge_indices[first_idx / 3][first_idx % 3];
+        }
 
-            vertex_edge_indices[i0].insert(edge_idx);
-            vertex_edge_indices[i1].insert(edge_idx);
+        m_face_edge_indices[face_idx][i] = edge_idx;
 
-            m_face_edge_indices[face_idx][i] = edge_idx;
+        auto &edge_face_indices = m_edge_face_indices[edge_idx];
 
-            auto &edge_face_indices = m_edge_face_indices[edge_idx];
+        if (edge_face_indices[0] == idx_max) {
+            edge_face_indices[0] = face_idx;
+        } else if (face_idx != edge_face_indices[0]) {
+            edge_face_indices[1] = face_idx;
+        }
+    }
 
-            if (edge_face_indices[0] == idx_max) {
-                edge_face_indices[0] = face_idx;
-            } else if (face_idx != edge_face_indices[0]){
-                edge_face_indices[1] = face_idx;
+    // Edges are visited in increasing order, thus the edges of each vertex
+    // come out sorted.
+    for (size_t i = 0; i < num_vertices; ++i) {
+        vertex_num_edges[i + 1] += vertex_num_edges[i];
+    }
+
+    auto vertex_edges = std::vector<index_type>(vertex_num_edges.back());
+
+    {
+        auto vertex_ends = std::vector<index_type>(vertex_num_edges.begin(), vertex_num_edges.end() - 1);
+
+        for (index_type edge_idx = 0; edge_idx < m_edge_vertex_indices.size(); ++edge_idx) {
+            auto &pair = m_edge_vertex_indices[edge_idx];
+            vertex_edges[vertex_ends[pair.first]++] = edge_idx;
+
+            if (pair.second != pair.first) {
+                vertex_edges[vertex_ends[pair.second]++] = edge_idx;
             }
         }
     }
 
-    for (auto edge_indices : vertex_edge_indices) {
+    m_vertex_edge_indices.reserve_nested(num_vertices);
+    m_vertex_edge_indices.reserve_data(vertex_edges.size());
+
+    for (size_t vertex_idx = 0; vertex_idx < num_vertices; ++vertex_idx) {
         m_vertex_edge_indices.push_array();
 
-        for (auto edge_idx : edge_indices) {
-            m_vertex_edge_indices.push_back(edge_idx);
+        for (auto k = vertex_num_edges[vertex_idx]; k < vertex_num_edges[vertex_idx + 1]; ++k) {
+            m_vertex_edge_indices.push_back(vertex_edges[k]);
         }
     }
 
@@ -137,6 +216,8 @@ void triangle_mesh::build_triangle_tree() {
         aabbs.push_back(tri_aabb);
     }
 
+    // Leaf ids are the triangle indices, thus the input order of triangles
+    // is kept and the indices reported by queries match the input.
     auto report_leaf = [](static_tree::tree_node &node, auto ids_begin, auto ids_end) {
         node.id = *ids_begin;
     };
@@ -153,6 +234,40 @@ triangle_vertices triangle_mesh::get_triangle_vertices(size_t tri_idx) const {
     };
 }
 
+packed_triangle triangle_mesh::make_packed_triangle(size_t tri_idx) const {
+    EDYN_ASSERT(tri_idx < m_indices.size());
+    auto tri = packed_triangle{};
+    tri.vertices = get_triangle_vertices(tri_idx);
+    tri.normal = m_normals[tri_idx];
+    tri.adjacent_normals = m_adjacent_normals[tri_idx];
+    tri.vertex_indices = m_indices[tri_idx];
+    tri.edge_indices = m_face_edge_indices[tri_idx];
+    tri.convex_edges = 0;
+
+    for (size_t i = 0; i < 3; ++i) {
+        if (m_is_convex_edge[tri.edge_indices[i]]) {
+            tri.convex_edges |= uint8_t(1) << i;
+        }
+    }
+
+    return tri;
+}
+
+void triangle_mesh::build_triangle_cache() {
+    EDYN_ASSERT(m_normals.size() == num_triangles());
+    m_packed_triangles.clear();
+    m_packed_triangles.reserve(num_triangles());
+
+    for (size_t i = 0; i < num_triangles(); ++i) {
+        m_packed_triangles.push_back(make_packed_triangle(i));
+    }
+}
+
+void triangle_mesh::clear_triangle_cache() {
+    m_packed_triangles.clear();
+    m_packed_triangles.shrink_to_fit();
+}
+
 bool triangle_mesh::has_per_vertex_friction() const {
     return !m_friction.empty();
 }
@@ -1,18 +1,36 @@
 #include "edyn/simulation/island_manager.hpp"
+#include "edyn/collision/contact_manifold.hpp"
+#include "edyn/collision/contact_manifold_events.hpp"
+#include "edyn/comp/aabb.hpp"
 #include "edyn/comp/angvel.hpp"
+#include "edyn/comp/delta_angvel.hpp"
+#include "edyn/comp/delta_linvel.hpp"
+#include "edyn/comp/gravity.hpp"
 #include "edyn/comp/graph_node.hpp"
 #include "edyn/comp/graph_edge.hpp"
 #include "edyn/comp/island.hpp"
+#include "edyn/comp/inertia.hpp"
 #include "edyn/comp/linvel.hpp"
+#include "edyn/comp/orientation.hpp"
+#include "edyn/comp/origin.hpp"
+#include "edyn/comp/position.hpp"
 #include "edyn/comp/tag.hpp"
+#include "edyn/comp/tree_resident.hpp"
+#include "edyn/constraints/constraint.hpp"
 #include "edyn/config/execution_mode.hpp"
 #include "edyn/context/settings.hpp"
+#include "edyn/dynamics/row_cache.hpp"
 #include "edyn/math/vector3.hpp"
 #include "edyn/util/island_util.hpp"
 #include "edyn/util/vector_util.hpp"
 #include "edyn/util/entt_util.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
 #include <set>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace edyn {
 
@@ -30,6 +48,7 @@ island_manager::island_manager(entt::registry &registry)
 island_manager::~island_manager() {
     // Clear here to avoid invalid island entities in `on_destroy<island_resident>` events.
     m_connections.clear();
+    m_compaction_connections.clear();
 
     // Destroy all island entities created by this manager.
     auto island_view = m_registry->view<island>();
@@ -531,11 +550,148 @@ void island_manager::wake_up_islands() {
     m_islands_to_wake_up.clear();
 }
 
+void island_manager::on_compaction_candidate(entt::registry &, entt::entity entity) {
+    // Entity changed between awake and dormant, or got a component of a
+    // compacted pool, which is appended at the end of the pool, i.e. on the
+    // awake side.
+    m_compaction_candidates.push_back(entity);
+}
+
+namespace {
+    // Pools iterated by the systems that run every step, excluding sleeping
+    // and disabled entities.
+    using compacted_pools_tuple_t = decltype(std::tuple_cat(
+        std::declval<std::tuple<position, orientation, linvel, angvel, delta_linvel, delta_angvel,
+                                origin, AABB, inertia_world_inv, gravity, tree_resident,
+                                procedural_tag, dynamic_tag, contact_manifold, contact_manifold_events,
+                                constraint_row_prep_cache>>(),
+        std::declval<constraints_tuple_t>()));
+
+    template<typename Func, typename... Ts>
+    void for_each_compacted_pool(Func func, [[maybe_unused]] std::tuple<Ts...> *) {
+        size_t index = 0;
+        (func(static_cast<Ts *>(nullptr), index++), ...);
+    }
+
+    template<typename Func>
+    void for_each_compacted_pool(Func func) {
+        for_each_compacted_pool(func, static_cast<compacted_pools_tuple_t *>(nullptr));
+    }
+
+    // Moves the given entities across the boundary between dormant and awake
+    // entities in the pool, if they're on the wrong side. Dormant entities
+    // are kept at the front of the packed array and awake ones at the back,
+    // which is where iteration starts. Each move is a single swap with the
+    // entity next to the boundary, thus the cost is proportional to the
+    // number of entities given, not to the pool size.
+    template<typename Component>
+    void move_across_boundary(entt::registry &registry, size_t &dormant_count,
+                              const std::vector<entt::entity> &entities) {
+        auto &storage = registry.storage<Component>();
+        auto &sleeping = registry.storage<sleeping_tag>();
+        auto &disabled = registry.storage<disabled_tag>();
+        dormant_count = std::min(dormant_count, storage.size());
+
+        for (auto entity : entities) {
+            if (!storage.contains(entity)) {
+                continue;
+            }
+
+            auto index = storage.index(entity);
+            auto dormant = sleeping.contains(entity) || disabled.contains(entity);
+
+            if (dormant && index >= dormant_count) {
+                auto other = storage.data()[dormant_count];
+                ++dormant_count;
+
+                if (other != entity) {
+                    storage.swap_elements(entity, other);
+                }
+            } else if (!dormant && index < dormant_count) {
+                --dormant_count;
+                auto other = storage.data()[dormant_count];
+
+                if (other != entity) {
+                    storage.swap_elements(entity, other);
+                }
+            }
+        }
+    }
+}
+
+template<typename Component>
+void island_manager::on_destroy_compacted_component(entt::registry &registry, entt::entity entity) {
+    // The last element of the pool will be moved into the slot of the
+    // destroyed one, which could be on the other side of the boundary.
+    auto &storage = registry.storage<Component>();
+    auto last = storage.data()[storage.size() - 1];
+
+    if (last != entity) {
+        m_compaction_candidates.push_back(last);
+    }
+}
+
+void island_manager::set_pool_compaction_enabled(bool enabled) {
+    m_pool_compaction_enabled = enabled;
+    m_compaction_connections.clear();
+    m_compaction_candidates.clear();
+
+    if (!enabled) {
+        return;
+    }
+
+    auto &registry = *m_registry;
+    m_compaction_connections.push_back(registry.on_construct<sleeping_tag>().connect<&island_manager::on_compaction_candidate>(*this));
+    m_compaction_connections.push_back(registry.on_destroy<sleeping_tag>().connect<&island_manager::on_compaction_candidate>(*this));
+    m_compaction_connections.push_back(registry.on_construct<disabled_tag>().connect<&island_manager::on_compaction_candidate>(*this));
+    m_compaction_connections.push_back(registry.on_destroy<disabled_tag>().connect<&island_manager::on_compaction_candidate>(*this));
+
+    m_dormant_counts.assign(std::tuple_size_v<compacted_pools_tuple_t>, 0);
+    auto entities = std::vector<entt::entity>{};
+
+    for_each_compacted_pool([&](auto *tag, size_t index) {
+        using component_type = std::remove_pointer_t<decltype(tag)>;
+        m_compaction_connections.push_back(registry.on_construct<component_type>().template connect<&island_manager::on_compaction_candidate>(*this));
+        m_compaction_connections.push_back(registry.on_destroy<component_type>().template connect<&island_manager::on_destroy_compacted_component<component_type>>(*this));
+
+        // Partition the entire pool once, which is linear in its size. From
+        // here on, only entities which could be misplaced are moved.
+        const entt::sparse_set &storage = registry.storage<component_type>();
+        entities.assign(storage.data(), storage.data() + storage.size());
+        move_across_boundary<component_type>(registry, m_dormant_counts[index], entities);
+    });
+}
+
+void island_manager::compact_pools() {
+    auto enabled = m_registry->ctx().get<settings>().compact_sleeping_pools;
+
+    if (enabled != m_pool_compaction_enabled) {
+        set_pool_compaction_enabled(enabled);
+        return;
+    }
+
+    if (!enabled || m_compaction_candidates.empty()) {
+        return;
+    }
+
+    // Move sleeping and disabled entities to the front of the hot pools so
+    // awake entities are iterated first with their components stored
+    // contiguously. Components are only reordered, thus views and signals
+    // are unaffected.
+    for_each_compacted_pool([&](auto *tag, size_t index) {
+        using component_type = std::remove_pointer_t<decltype(tag)>;
+        move_across_boundary<component_type>(*m_registry, m_dormant_counts[index], m_compaction_candidates);
+    });
+
+    m_compaction_candidates.clear();
+}
+
 void island_manager::update(double timestamp) {
     wake_up_islands();
     init_new_nodes_and_edges();
     split_islands();
     put_islands_to_sleep();
+    compact_pools();
     m_last_time = timestamp;
 }
 
@@ -1,6 +1,7 @@
 #include "edyn/simulation/simulation_worker.hpp"
 #include "edyn/collision/broadphase.hpp"
 #include "edyn/collision/contact_manifold.hpp"
+#include "edyn/collision/contact_manifold_events.hpp"
 #include "edyn/collision/contact_manifold_map.hpp"
 #include "edyn/collision/narrowphase.hpp"
 #include "edyn/comp/angvel.hpp"
@@ -24,14 +25,12 @@
 #include "edyn/replication/entity_map.hpp"
 #include "edyn/sys/update_aabbs.hpp"
 #include "edyn/sys/update_inertias.hpp"
-#include "edyn/sys/update_rotated_meshes.hpp"
 #include "edyn/parallel/job_dispatcher.hpp"
 #include "edyn/parallel/message.hpp"
 #include "edyn/core/entity_graph.hpp"
 #include "edyn/serialization/memory_archive.hpp"
 #include "edyn/comp/graph_node.hpp"
 #include "edyn/comp/graph_edge.hpp"
-#include "edyn/comp/rotated_mesh_list.hpp"
 #include "edyn/math/constants.hpp"
 #include "edyn/math/transform.hpp"
 #include "edyn/util/aabb_util.hpp"
@@ -49,6 +48,7 @@
 #include <entt/entity/registry.hpp>
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 
 namespace edyn {
@@ -86,10 +86,13 @@ simulation_worker::simulation_worker(const settings &settings,
     m_registry.ctx().emplace<edyn::settings>(settings);
     m_registry.ctx().emplace<registry_operation_context>(reg_op_ctx);
     m_registry.ctx().emplace<material_mix_table>(material_table);
+
+    m_message_queue.push_sink().connect<&simulation_worker::on_push_message>(*this);
 }
 
 simulation_worker::~simulation_worker() {
     stop();
+    m_message_queue.push_sink().disconnect<&simulation_worker::on_push_message>(*this);
 
     // The destructor of `polyhedron_shape_initializer` touches `m_registry` when
     // destroying `rotated_mesh_list` elements it creates for compound shapes
@@ -105,6 +108,8 @@ void simulation_worker::init() {
     m_connections.push_back(m_registry.on_destroy<graph_node>().connect<&simulation_worker::on_destroy_shared_entity>(*this));
     m_connections.push_back(m_registry.on_destroy<graph_edge>().connect<&simulation_worker::on_destroy_shared_entity>(*this));
     m_connections.push_back(m_registry.on_destroy<island_tag>().connect<&simulation_worker::on_destroy_shared_entity>(*this));
+    m_connections.push_back(m_registry.on_update<contact_manifold_events>().connect<&simulation_worker::on_update_contact_manifold_events>(*this));
+    m_connections.push_back(m_registry.on_construct<sleeping_tag>().connect<&simulation_worker::on_construct_sleeping_tag>(*this));
 
     m_message_queue.sink<msg::update_entities>().connect<&simulation_worker::on_update_entities>(*this);
     m_message_queue.sink<msg::set_paused>().connect<&simulation_worker::on_set_paused>(*this);
@@ -144,6 +149,15 @@ void simulation_worker::deinit() {
     }
 }
 
+void simulation_worker::on_push_message() {
+    {
+        auto lock = std::lock_guard(m_wait_mutex);
+        m_has_messages = true;
+    }
+
+    m_wait_cv.notify_one();
+}
+
 void simulation_worker::on_construct_shared_entity(entt::registry &registry, entt::entity entity) {
     m_op_observer->observe(entity);
 }
@@ -156,6 +170,19 @@ void simulation_worker::on_destroy_shared_entity(entt::registry &registry, entt:
     }
 }
 
+void simulation_worker::on_update_contact_manifold_events(entt::registry &registry, entt::entity entity) {
+    m_contact_events_pending = true;
+}
+
+void simulation_worker::on_construct_sleeping_tag(entt::registry &registry, entt::entity entity) {
+    // When coalescing steps, bodies that fall asleep in an intermediate step
+    // would be excluded from the transforms sent after the last step, thus
+    // leaving the main registry with the transforms of an older step.
+    if (registry.ctx().get<edyn::settings>().coalesce_substep_updates) {
+        m_fell_asleep_entities.push_back(entity);
+    }
+}
+
 void simulation_worker::on_update_entities(message<msg::update_entities> &msg) {
     auto &ops = msg.content.ops;
     auto &registry = m_registry;
@@ -215,7 +242,7 @@ void simulation_worker::on_update_entities(message<msg::update_entities> &msg) {
         }
 
         // When orientation is set manually, a few dependent components must be
-        // updated, e.g. AABB, cached origin, inertia_world_inv, rotated meshes...
+        // updated, e.g. AABB, cached origin, inertia_world_inv...
         if (op_type == registry_operation_type::replace &&
             op->payload_type_any_of<orientation>())
         {
@@ -235,10 +262,6 @@ void simulation_worker::on_update_entities(message<msg::update_entities> &msg) {
             if (registry.any_of<dynamic_tag>(local_entity)) {
                 update_inertia(registry, local_entity);
             }
-
-            if (registry.any_of<rotated_mesh_list>(local_entity)) {
-                update_rotated_mesh(registry, local_entity);
-            }
         }
 
         // When position is set manually, the AABB and cached origin must be updated.
@@ -297,11 +320,27 @@ void simulation_worker::wake_up_affected_islands(const registry_operation &ops)
 }
 
 void simulation_worker::sync() {
-    if (!m_op_builder->empty()) {
+    if (!m_op_builder->empty() || !m_transforms.empty()) {
         auto &&ops = std::move(m_op_builder->finish());
+
+        // Operations of multiple steps might have been accumulated, in which
+        // case only the latest value of each component matters.
+        if (m_registry.ctx().get<edyn::settings>().coalesce_substep_updates) {
+            ops.coalesce_replacements();
+        }
+
         message_dispatcher::global().send<msg::step_update>(
-            {"main"}, m_message_queue.identifier, std::move(ops), m_sim_time);
+            {"main"}, m_message_queue.identifier, std::move(ops), std::move(m_transforms), m_sim_time);
+        // Continue with a buffer and operation blocks that were recycled by
+        // the main thread.
+        m_transforms = m_transform_channel.acquire();
+
+        if (auto recycled = m_op_pool.acquire()) {
+            m_op_builder->reuse(std::move(*recycled));
+        }
     }
+
+    m_contact_events_pending = false;
 }
 
 void simulation_worker::start() {
@@ -315,6 +354,7 @@ void simulation_worker::start() {
 
 void simulation_worker::stop() {
     m_running.store(false, std::memory_order_release);
+    m_wait_cv.notify_one();
 
     std::unique_lock<std::mutex> lock(m_finish_mutex);
     m_finish_cv.wait(lock, [&]() {
@@ -383,8 +423,16 @@ void simulation_worker::update() {
             (*settings.post_step_callback)(m_registry);
         }
 
-        mark_transforms_replaced();
-        sync();
+        // When coalescing, transforms are only sent after the last step and
+        // the other operations accumulate until then.
+        if (!settings.coalesce_substep_updates || i + 1 == effective_steps) {
+            mark_transforms_replaced();
+            sync();
+        } else if (m_contact_events_pending) {
+            // Contact events are cleared in the next step thus they must be
+            // sent now. The main thread consumes them once per update.
+            sync();
+        }
     }
 
     m_last_time = m_current_time;
@@ -401,6 +449,8 @@ void simulation_worker::run() {
     m_current_time = (*m_registry.ctx().get<settings>().time_func)();
     init();
 
+    auto deadline = m_current_time;
+
     while (m_running.load(std::memory_order_relaxed)) {
         auto t1 = (*m_registry.ctx().get<settings>().time_func)();
         auto dt = t1 - m_current_time;
@@ -408,12 +458,20 @@ void simulation_worker::run() {
         update();
         sync();
 
-        // Apply delay to maintain a fixed update rate.
-        auto desired_dt = m_registry.ctx().get<settings>().fixed_dt;
-        auto error = desired_dt - dt;
-        i_term = std::max(-1.0, std::min(i_term + integral_term * error, 1.0));
-        auto delay = std::max(0.0, proportional_term * error + i_term);
-        edyn::delay(delay * 1000);
+        auto &settings = m_registry.ctx().get<edyn::settings>();
+        auto desired_dt = settings.fixed_dt;
+
+        if (settings.worker_pacing == worker_pacing::deadline) {
+            deadline = next_pacing_deadline(deadline, t1, desired_dt);
+            wait_until(deadline);
+        } else {
+            // Apply delay to maintain a fixed update rate.
+            auto error = desired_dt - dt;
+            i_term = std::max(-1.0, std::min(i_term + integral_term * error, 1.0));
+            auto delay = std::max(0.0, proportional_term * error + i_term);
+            edyn::delay(delay * 1000);
+            record_pacing_error(-error);
+        }
     }
 
     deinit();
@@ -423,6 +481,46 @@ void simulation_worker::run() {
     m_finish_cv.notify_one();
 }
 
+bool simulation_worker::wait_until(double deadline) {
+    auto &settings = m_registry.ctx().get<edyn::settings>();
+    auto *time_func = settings.time_func;
+    auto now = (*time_func)();
+    auto sleep_time = deadline - now - settings.worker_spin_time;
+
+    // Sleep until shortly before the deadline. Waiting on the condition
+    // variable converts the timeout into an absolute time point on a steady
+    // clock and wakes up as soon as a message arrives.
+    if (sleep_time > 0) {
+        auto lock = std::unique_lock(m_wait_mutex);
+        auto woken = m_wait_cv.wait_for(lock, std::chrono::duration<double>(sleep_time), [&]() {
+            return m_has_messages || !m_running.load(std::memory_order_relaxed);
+        });
+        m_has_messages = false;
+
+        if (woken) {
+            auto stats_lock = std::lock_guard(m_stats_mutex);
+            ++m_pacing_stats.num_early_wakeups;
+            return false;
+        }
+    }
+
+    // Spin for the remaining time since sleeping isn't precise enough.
+    now = spin_until(deadline, time_func);
+    record_pacing_error(now - deadline);
+
+    return true;
+}
+
+void simulation_worker::record_pacing_error(double error) {
+    auto lock = std::lock_guard(m_stats_mutex);
+    edyn::record_pacing_error(m_pacing_stats, error);
+}
+
+worker_pacing_stats simulation_worker::get_pacing_stats() const {
+    auto lock = std::lock_guard(m_stats_mutex);
+    return m_pacing_stats;
+}
+
 void simulation_worker::consume_raycast_results() {
     auto &dispatcher = message_dispatcher::global();
     m_raycast_service.consume_results([&](unsigned id, raycast_result &result) {
@@ -433,10 +531,49 @@ void simulation_worker::consume_raycast_results() {
 
 void simulation_worker::mark_transforms_replaced() {
     auto body_view = m_registry.view<position, orientation, linvel, angvel, dynamic_tag>(exclude_sleeping_disabled);
-    m_op_builder->replace<position>(body_view.begin(), body_view.end());
-    m_op_builder->replace<orientation>(body_view.begin(), body_view.end());
-    m_op_builder->replace<linvel>(body_view.begin(), body_view.end());
-    m_op_builder->replace<angvel>(body_view.begin(), body_view.end());
+    m_transforms.reserve(m_transforms.size() + body_view.size_hint());
+
+    auto insert_transform = [&](entt::entity entity, const position &pos, const orientation &orn,
+                                const linvel &v, const angvel &w) {
+        // Resolve the main registry entity here so the main thread can
+        // apply the buffer directly.
+        if (m_entity_map.contains_local(entity)) {
+            m_transforms.push_back(m_entity_map.at_local(entity), pos, orn, v, w);
+        } else {
+            // Entity was created in this worker and the main thread hasn't sent
+            // back a mapping yet. Send it as regular operations which are mapped
+            // after the entity is created in the main registry.
+            m_op_builder->replace<position>(entity);
+            m_op_builder->replace<orientation>(entity);
+            m_op_builder->replace<linvel>(entity);
+            m_op_builder->replace<angvel>(entity);
+        }
+    };
+
+    for (auto [entity, pos, orn, v, w] : body_view.each()) {
+        insert_transform(entity, pos, orn, v, w);
+    }
+
+    if (!m_fell_asleep_entities.empty()) {
+        // An entity could have fallen asleep more than once in the steps
+        // that were coalesced.
+        std::sort(m_fell_asleep_entities.begin(), m_fell_asleep_entities.end());
+        auto last = std::unique(m_fell_asleep_entities.begin(), m_fell_asleep_entities.end());
+        m_fell_asleep_entities.erase(last, m_fell_asleep_entities.end());
+
+        auto sleeping_body_view = m_registry.view<position, orientation, linvel, angvel, dynamic_tag, sleeping_tag>();
+
+        for (auto entity : m_fell_asleep_entities) {
+            if (!sleeping_body_view.contains(entity)) {
+                continue;
+            }
+
+            auto [pos, orn, v, w] = sleeping_body_view.get<position, orientation, linvel, angvel>(entity);
+            insert_transform(entity, pos, orn, v, w);
+        }
+
+        m_fell_asleep_entities.clear();
+    }
 }
 
 void simulation_worker::on_set_paused(message<msg::set_paused> &msg) {
@@ -15,6 +15,7 @@
 #include "edyn/comp/graph_node.hpp"
 #include "edyn/comp/graph_edge.hpp"
 #include "edyn/replication/registry_operation.hpp"
+#include "edyn/replication/transform_sync.hpp"
 #include "edyn/context/settings.hpp"
 #include "edyn/dynamics/material_mixing.hpp"
 #include "edyn/util/constraint_util.hpp"
@@ -118,6 +119,11 @@ void stepper_async::on_step_update(message<msg::step_update> &msg) {
     m_should_calculate_presentation_delay = true;
 
     auto &ops = msg.content.ops;
+
+    // Imported on this thread in the original order of operations since the
+    // callback below creates graph nodes and edges, and observers of update
+    // signals expect them in order. Consecutive operations of the same kind
+    // are executed as typed runs.
     ops.execute(registry, m_entity_map, [&](operation_base *op) {
         auto op_type = op->operation_type();
         auto remote_entity = op->entity;
@@ -157,6 +163,13 @@ void stepper_async::on_step_update(message<msg::step_update> &msg) {
         }
     });
 
+    // Transforms refer to entities in this registry already, thus they can be
+    // assigned directly. Then give the buffer back to the worker for reuse.
+    auto &transforms = msg.content.transforms;
+    apply_transform_sync(registry, transforms);
+    m_worker.get_transform_sync_channel().release(std::move(transforms));
+    m_worker.get_registry_operation_pool().release(std::move(ops));
+
     m_importing = false;
     m_op_observer->set_active(true);
 
@@ -0,0 +1,49 @@
+#include "edyn/simulation/worker_pacing_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace edyn {
+
+void record_pacing_error(worker_pacing_stats &stats, double error) {
+    // Weight of the latest error in the moving average.
+    constexpr auto average_weight = 0.05;
+    auto abs_error = std::abs(error);
+
+    stats.last_error = error;
+    stats.average_error = stats.num_updates == 0 ? abs_error :
+        stats.average_error + (abs_error - stats.average_error) * average_weight;
+    stats.max_error = std::max(stats.max_error, abs_error);
+    ++stats.num_updates;
+}
+
+double next_pacing_deadline(double deadline, double time, double fixed_dt) {
+    // Deadlines are absolute so that the update rate doesn't drift. If the
+    // update was triggered by a message before the deadline, keep waiting for
+    // the same one. If the worker fell too far behind, restart from now since
+    // the accumulator catches up.
+    if (time < deadline) {
+        return deadline;
+    }
+
+    deadline += fixed_dt;
+
+    if (deadline < time) {
+        deadline = time + fixed_dt;
+    }
+
+    return deadline;
+}
+
+double spin_until(double deadline, double(*time_func)(void)) {
+    auto now = (*time_func)();
+
+    while (now < deadline) {
+        std::this_thread::yield();
+        now = (*time_func)();
+    }
+
+    return now;
+}
+
+}
@@ -0,0 +1,92 @@
+#include "edyn/sys/presentation_exporter.hpp"
+#include "edyn/comp/present_position.hpp"
+#include "edyn/comp/present_orientation.hpp"
+#include <entt/entity/registry.hpp>
+#include <algorithm>
+
+namespace edyn {
+
+presentation_exporter::presentation_exporter(entt::registry &registry)
+    : m_registry(&registry)
+{
+    registry.on_construct<present_position>().connect<&presentation_exporter::on_construct_present_position>(*this);
+    registry.on_destroy<present_position>().connect<&presentation_exporter::on_destroy_present_position>(*this);
+
+    for (auto entity : registry.view<present_position>()) {
+        on_construct_present_position(registry, entity);
+    }
+}
+
+presentation_exporter::~presentation_exporter() {
+    m_registry->on_construct<present_position>().disconnect<&presentation_exporter::on_construct_present_position>(*this);
+    m_registry->on_destroy<present_position>().disconnect<&presentation_exporter::on_destroy_present_position>(*this);
+}
+
+void presentation_exporter::on_construct_present_position(entt::registry &, entt::entity entity) {
+    size_t index;
+
+    if (m_free_slots.empty()) {
+        index = m_transforms.size();
+        m_transforms.emplace_back();
+    } else {
+        index = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+
+    m_transforms[index].entity = entity;
+    m_slots.emplace(entity, index);
+
+    // The orientation might not have been assigned yet. Fill in the slot later.
+    m_pending.push_back(entity);
+}
+
+void presentation_exporter::on_destroy_present_position(entt::registry &, entt::entity entity) {
+    auto index = m_slots.get(entity);
+    m_slots.erase(entity);
+
+    // Leave a hole to keep the indices of all other slots unchanged.
+    m_transforms[index] = {};
+    m_free_slots.push_back(index);
+    mark_dirty(index);
+}
+
+void presentation_exporter::update() {
+    for (auto entity : m_pending) {
+        // The body could have been destroyed since.
+        if (!m_slots.contains(entity)) {
+            continue;
+        }
+
+        if (auto [pos, orn] = m_registry->try_get<present_position, present_orientation>(entity); pos && orn) {
+            assign(entity, *pos, *orn);
+        }
+    }
+
+    m_pending.clear();
+
+    if (m_dirty_ranges.size() < 2) {
+        return;
+    }
+
+    std::sort(m_dirty_ranges.begin(), m_dirty_ranges.end(), [](auto &lhs, auto &rhs) {
+        return lhs.begin < rhs.begin;
+    });
+
+    // Merge overlapping and adjacent ranges.
+    size_t count = 1;
+
+    for (size_t i = 1; i < m_dirty_ranges.size(); ++i) {
+        auto &last = m_dirty_ranges[count - 1];
+        auto &curr = m_dirty_ranges[i];
+
+        if (curr.begin <= last.end) {
+            last.end = std::max(last.end, curr.end);
+        } else {
+            m_dirty_ranges[count++] = curr;
+        }
+    }
+
+    m_dirty_ranges.resize(count);
+}
+
+}
@@ -18,18 +18,6 @@ AABB updated_aabb(const ShapeType &shape, const vector3 &pos, const quaternion &
     return shape_aabb(shape, pos, orn);
 }
 
-template<>
-AABB updated_aabb(const polyhedron_shape &polyhedron,
-                  const vector3 &pos, const quaternion &orn) {
-    // `shape_aabb(const polyhedron_shape &, ...)` rotates each vertex of a
-    // polyhedron to calculate the AABB. Specialize `updated_aabb` for
-    // polyhedrons to use the rotated mesh.
-    auto aabb = point_cloud_aabb(polyhedron.rotated->vertices);
-    aabb.min += pos;
-    aabb.max += pos;
-    return aabb;
-}
-
 template<typename ShapeType, typename TransformView, typename OriginView>
 void update_aabb(entt::entity entity, ShapeType &shape, TransformView &tr_view,
                  OriginView &origin_view) {
@@ -1,4 +1,5 @@
 #include "edyn/sys/update_presentation.hpp"
+#include "edyn/sys/presentation_exporter.hpp"
 #include "edyn/comp/position.hpp"
 #include "edyn/comp/present_position.hpp"
 #include "edyn/comp/orientation.hpp"
@@ -13,6 +14,9 @@
 #include "edyn/networking/comp/discontinuity.hpp"
 #include "edyn/util/island_util.hpp"
 #include <entt/entity/registry.hpp>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
 
 namespace edyn {
 
@@ -53,34 +57,175 @@ static void update_discontinuities(entt::registry &registry, double dt) {
     });
 }
 
+/**
+ * Extrapolates presentation transforms of up to `max_size` bodies at once.
+ * Inputs are gathered into a structure of arrays so each stage runs as a
+ * single loop over all lanes. Results are scattered back into the
+ * presentation components and the optional output buffer in the order bodies
+ * were pushed, applying discontinuity offsets on the way.
+ */
+class presentation_batch {
+public:
+    static constexpr size_t max_size = 8;
+
+    presentation_batch(scalar dt, const entt::registry::storage_for_type<discontinuity> &discontinuities,
+                       presentation_output *output, presentation_exporter *exporter)
+        : m_dt(dt)
+        , m_discontinuities(&discontinuities)
+        , m_output(output)
+        , m_exporter(exporter)
+    {
+        // Lanes beyond `m_count` are still processed, thus they must hold
+        // valid values. Zero velocities and identity orientations do.
+        std::fill(std::begin(m_qw), std::end(m_qw), scalar(1));
+    }
+
+    void push(entt::entity entity, const position &pos, const orientation &orn,
+              const linvel &v, const angvel &w,
+              present_position &p_pos, present_orientation &p_orn) {
+        m_entities[m_count] = entity;
+        m_present_positions[m_count] = &p_pos;
+        m_present_orientations[m_count] = &p_orn;
+        m_px[m_count] = pos.x; m_py[m_count] = pos.y; m_pz[m_count] = pos.z;
+        m_vx[m_count] = v.x; m_vy[m_count] = v.y; m_vz[m_count] = v.z;
+        m_qx[m_count] = orn.x; m_qy[m_count] = orn.y; m_qz[m_count] = orn.z; m_qw[m_count] = orn.w;
+        m_wx[m_count] = w.x; m_wy[m_count] = w.y; m_wz[m_count] = w.z;
+
+        if (++m_count == max_size) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (m_count == 0) {
+            return;
+        }
+
+        const auto dt = m_dt;
+
+        for (size_t i = 0; i < max_size; ++i) {
+            m_px[i] += m_vx[i] * dt;
+            m_py[i] += m_vy[i] * dt;
+            m_pz[i] += m_vz[i] * dt;
+        }
+
+        // Same as `integrate(orn, w, dt)` with both branches evaluated and
+        // the result selected per lane.
+        constexpr auto min_ws = scalar(0.001);
+        constexpr auto half = scalar(0.5);
+        constexpr auto k = scalar(1) / scalar(48);
+
+        for (size_t i = 0; i < max_size; ++i) {
+            auto ws = std::sqrt(m_wx[i] * m_wx[i] + m_wy[i] * m_wy[i] + m_wz[i] * m_wz[i]);
+            auto half_angle = half * ws * dt;
+            auto t_small = half * dt - dt * dt * dt * k * ws * ws;
+            auto t_large = std::sin(half_angle) / std::max(ws, min_ws);
+            auto t = ws < min_ws ? t_small : t_large;
+
+            auto rx = m_wx[i] * t;
+            auto ry = m_wy[i] * t;
+            auto rz = m_wz[i] * t;
+            auto rw = std::cos(half_angle);
+
+            auto qx = m_qx[i], qy = m_qy[i], qz = m_qz[i], qw = m_qw[i];
+            auto x = rw * qx + rx * qw + ry * qz - rz * qy;
+            auto y = rw * qy + ry * qw + rz * qx - rx * qz;
+            auto z = rw * qz + rz * qw + rx * qy - ry * qx;
+            auto w = rw * qw - rx * qx - ry * qy - rz * qz;
+            auto inv_len = scalar(1) / std::sqrt(x * x + y * y + z * z + w * w);
+
+            m_qx[i] = x * inv_len;
+            m_qy[i] = y * inv_len;
+            m_qz[i] = z * inv_len;
+            m_qw[i] = w * inv_len;
+        }
+
+        for (size_t i = 0; i < m_count; ++i) {
+            auto pos = vector3{m_px[i], m_py[i], m_pz[i]};
+            auto orn = quaternion{m_qx[i], m_qy[i], m_qz[i], m_qw[i]};
+
+            if (m_discontinuities->contains(m_entities[i])) {
+                auto &dis = m_discontinuities->get(m_entities[i]);
+                pos += dis.position_offset;
+                orn = dis.orientation_offset * orn;
+            }
+
+            *m_present_positions[i] = pos;
+            *m_present_orientations[i] = orn;
+
+            if (m_output) {
+                if (m_output->size < m_output->capacity) {
+                    m_output->data[m_output->size] = {pos, orn, m_entities[i]};
+                }
+
+                ++m_output->size;
+            }
+
+            if (m_exporter) {
+                m_exporter->assign(m_entities[i], pos, orn);
+            }
+        }
+
+        m_count = 0;
+    }
+
+private:
+    scalar m_dt;
+    const entt::registry::storage_for_type<discontinuity> *m_discontinuities;
+    presentation_output *m_output;
+    presentation_exporter *m_exporter;
+
+    size_t m_count {0};
+    entt::entity m_entities[max_size];
+    present_position *m_present_positions[max_size];
+    present_orientation *m_present_orientations[max_size];
+
+    scalar m_px[max_size] {}, m_py[max_size] {}, m_pz[max_size] {};
+    scalar m_vx[max_size] {}, m_vy[max_size] {}, m_vz[max_size] {};
+    scalar m_qx[max_size] {}, m_qy[max_size] {}, m_qz[max_size] {}, m_qw[max_size] {};
+    scalar m_wx[max_size] {}, m_wy[max_size] {}, m_wz[max_size] {};
+};
+
 void update_presentation(entt::registry &registry, double sim_time, double current_time,
-                         double delta_time, double presentation_delay) {
+                         double delta_time, double presentation_delay,
+                         presentation_output *output) {
     auto &settings = registry.ctx().get<edyn::settings>();
 
     if (std::holds_alternative<client_network_settings>(settings.network_settings)) {
         update_discontinuities(registry, delta_time);
     }
 
-    auto linear_view = registry.view<position, linvel, present_position, procedural_tag>(exclude_sleeping_disabled);
-    auto angular_view = registry.view<orientation, angvel, present_orientation, procedural_tag>(exclude_sleeping_disabled);
+    if (output == nullptr) {
+        output = settings.presentation_output;
+    }
+
+    if (output) {
+        output->size = 0;
+    }
+
+    // Only dynamic bodies have presentation components and the transforms of
+    // sleeping bodies remain constant, thus only awake bodies are visited.
+    auto view = registry.view<position, orientation, linvel, angvel,
+                              present_position, present_orientation, procedural_tag>(exclude_sleeping_disabled);
 
     // Interpolate transforms at `sim_time` towards a consistent point in time
     // which is `presentation_delay` seconds behind the current time.
     const auto interpolation_dt = std::min(static_cast<scalar>(current_time - presentation_delay - sim_time), settings.fixed_dt);
 
-    linear_view.each([interpolation_dt](position &pos, linvel &vel, present_position &pre) {
-        pre = pos + vel * interpolation_dt;
-    });
+    auto *exporter = registry.ctx().find<presentation_exporter>();
+    auto batch = presentation_batch(interpolation_dt, registry.storage<discontinuity>(), output, exporter);
 
-    angular_view.each([interpolation_dt](orientation &orn, angvel &vel, present_orientation &pre) {
-        pre = integrate(orn, vel, interpolation_dt);
-    });
+    for (auto entity : view) {
+        auto [pos, orn, v, w, p_pos, p_orn] =
+            view.get<position, orientation, linvel, angvel, present_position, present_orientation>(entity);
+        batch.push(entity, pos, orn, v, w, p_pos, p_orn);
+    }
 
-    auto discontinuity_view = registry.view<discontinuity, present_position, present_orientation>();
-    discontinuity_view.each([](discontinuity &dis, present_position &p_pos, present_orientation &p_orn) {
-        p_pos += dis.position_offset;
-        p_orn = dis.orientation_offset * p_orn;
-    });
+    batch.flush();
+
+    if (exporter) {
+        exporter->update();
+    }
 }
 
 void snap_presentation(entt::registry &registry) {
@@ -89,6 +234,14 @@ void snap_presentation(entt::registry &registry) {
         p_pos = pos;
         p_orn = orn;
     });
+
+    if (auto *exporter = registry.ctx().find<presentation_exporter>()) {
+        for (auto [entity, pos, orn] : registry.view<present_position, present_orientation>().each()) {
+            exporter->assign(entity, pos, orn);
+        }
+
+        exporter->update();
+    }
 }
 
 }
@@ -4,34 +4,29 @@
 #include "edyn/comp/rotated_mesh_list.hpp"
 #include "edyn/comp/tag.hpp"
 #include "edyn/util/island_util.hpp"
+#include "edyn/math/matrix3x3.hpp"
 #include <entt/entity/registry.hpp>
 #include <variant>
 
 namespace edyn {
 
-static void update_rotated_mesh_vertices(rotated_mesh &rotated, const convex_mesh &mesh,
-                                         const quaternion &orn) {
-    EDYN_ASSERT(mesh.vertices.size() == rotated.vertices.size());
-    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-        auto &vertex_local = mesh.vertices[i];
-        rotated.vertices[i] = rotate(orn, vertex_local);
-    }
-}
-
-static void update_rotated_mesh_normals(rotated_mesh &rotated, const convex_mesh &mesh,
-                                        const quaternion &orn) {
-    EDYN_ASSERT(mesh.normals.size() == rotated.normals.size());
+static void rotate_vectors(const matrix3x3 &basis, const std::vector<vector3> &input,
+                           std::vector<vector3> &output) {
+    EDYN_ASSERT(input.size() == output.size());
 
-    for (size_t i = 0; i < mesh.normals.size(); ++i) {
-        auto &normal_local = mesh.normals[i];
-        rotated.normals[i] = rotate(orn, normal_local);
+    for (size_t i = 0; i < input.size(); ++i) {
+        output[i] = basis * input[i];
     }
 }
 
 void update_rotated_mesh(rotated_mesh &rotated, const convex_mesh &mesh,
                          const quaternion &orn) {
-    update_rotated_mesh_vertices(rotated, mesh, orn);
-    update_rotated_mesh_normals(rotated, mesh, orn);
+    // Converting to a matrix once is cheaper than a quaternion rotation for
+    // each vector.
+    auto basis = to_matrix3x3(orn);
+    rotate_vectors(basis, mesh.vertices, rotated.vertices);
+    rotate_vectors(basis, mesh.normals, rotated.normals);
+    rotated.orientation = orn;
 }
 
 template<typename RotatedView, typename OrientationView>
@@ -40,9 +35,14 @@ void update_rotated_mesh(entt::entity entity, RotatedView &rotated_view, Orienta
 
     do {
         auto &rotated = rotated_view.template get<rotated_mesh_list>(entity);
-        // TODO: `rot_list_ptr->orientation` is often `quaternion_identity`.
-        // What could be done to avoid this often unnecessary multiplication?
-        update_rotated_mesh(*rotated.rotated, *rotated.mesh, orn * rotated.orientation);
+        auto rotated_orn = rotated.orientation == quaternion_identity ?
+            static_cast<quaternion>(orn) : orn * rotated.orientation;
+
+        // Skip if the orientation has not changed since the last update.
+        if (rotated.rotated->orientation != rotated_orn) {
+            update_rotated_mesh(*rotated.rotated, *rotated.mesh, rotated_orn);
+        }
+
         entity = rotated.next;
     } while (entity != entt::null);
 }
@@ -193,7 +193,25 @@ AABB shape_aabb(const box_shape &sh, const vector3 &pos, const quaternion &orn)
 }
 
 AABB shape_aabb(const polyhedron_shape &sh, const vector3 &pos, const quaternion &orn) {
-    return point_cloud_aabb(sh.mesh->vertices, pos, orn);
+    // Find the support vertices along the world axes in object space by
+    // hill-climbing instead of transforming all vertices. Each search starts
+    // at the result of the previous one, which is usually close by.
+    const auto &mesh = *sh.mesh;
+    const auto conj_orn = conjugate(orn);
+    auto aabb = AABB{};
+    uint32_t vertex_idx = 0;
+
+    for (size_t i = 0; i < 3; ++i) {
+        auto axis = vector3_zero;
+        axis[i] = 1;
+        auto dir = rotate(conj_orn, axis);
+        aabb.max[i] = pos[i] + polyhedron_support_projection(mesh.vertices, mesh.neighbors_start,
+                                                             mesh.neighbor_indices, dir, vertex_idx);
+        aabb.min[i] = pos[i] - polyhedron_support_projection(mesh.vertices, mesh.neighbors_start,
+                                                             mesh.neighbor_indices, -dir, vertex_idx);
+    }
+
+    return aabb;
 }
 
 AABB shape_aabb(const paged_mesh_shape &sh, const vector3 &pos, const quaternion &orn) {
@@ -203,6 +221,13 @@ AABB shape_aabb(const paged_mesh_shape &sh, const vector3 &pos, const quaternion
     };
 }
 
+AABB shape_aabb(const heightfield_shape &sh, const vector3 &pos, const quaternion &orn) {
+    return {
+        sh.field->get_aabb().min + pos,
+        sh.field->get_aabb().max + pos
+    };
+}
+
 AABB shape_aabb(const compound_shape &sh, const vector3 &pos, const quaternion &orn) {
     // Using AABB of transformed AABB for greater performance.
     auto aabb = aabb_to_world_space(sh.nodes.front().aabb, pos, orn);
@@ -0,0 +1,649 @@
+#include "edyn/util/convex_decomposition.hpp"
+#include "edyn/util/convex_hull.hpp"
+#include "edyn/util/shape_io.hpp"
+#include "edyn/util/shape_util.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
+#include "edyn/serialization/file_archive.hpp"
+#include "edyn/serialization/mapped_file.hpp"
+#include <entt/signal/delegate.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace edyn {
+
+namespace {
+
+// Solid voxelization of the interior of a mesh. Voxels are stored in columns
+// along the z axis, i.e. the index of voxel (i, j, k) is `(i * ny + j) * nz + k`.
+struct voxel_grid {
+    AABB aabb;
+    vector3 voxel_size;
+    std::array<uint32_t, 3> size;
+    std::vector<uint8_t> solid;
+
+    size_t column_index(uint32_t i, uint32_t j) const {
+        return size_t(i) * size[1] + j;
+    }
+
+    bool is_solid(uint32_t i, uint32_t j, uint32_t k) const {
+        return solid[column_index(i, j) * size[2] + k];
+    }
+};
+
+// Range of voxels [min, max).
+struct voxel_box {
+    std::array<uint32_t, 3> min;
+    std::array<uint32_t, 3> max;
+};
+
+struct voxel_piece {
+    voxel_box box;
+    size_t num_voxels {0};
+    // Points whose convex hull is the convex hull of the voxels.
+    std::vector<vector3> points;
+    // Volume of the convex hull not occupied by voxels.
+    scalar concavity {0};
+    bool splittable {true};
+};
+
+// Weight of the preference for balanced cuts across long axes, relative to
+// the concavity of the piece being split.
+constexpr auto split_bias = scalar(0.05);
+
+struct split_candidate {
+    size_t axis;
+    uint32_t position;
+    voxel_piece pieces[2];
+};
+
+template<typename Func>
+void run_tasks(size_t count, enqueue_task_wait_t *enqueue_task_wait, Func func) {
+    if (count == 0) {
+        return;
+    }
+
+    auto task_func = [&](unsigned start, unsigned end) {
+        for (auto i = start; i < end; ++i) {
+            func(size_t(i));
+        }
+    };
+
+    if (enqueue_task_wait != nullptr && count > 1) {
+        auto task = task_delegate_t(entt::connect_arg_t<&decltype(task_func)::operator()>{}, task_func);
+        (*enqueue_task_wait)(task, count);
+    } else {
+        task_func(0, count);
+    }
+}
+
+scalar cross2(scalar ax, scalar ay, scalar bx, scalar by) {
+    return ax * by - ay * bx;
+}
+
+bool voxelize(const std::vector<vector3> &vertices, const std::vector<uint32_t> &indices,
+              size_t resolution, voxel_grid &grid) {
+    if (vertices.empty() || resolution == 0) {
+        return false;
+    }
+
+    grid.aabb = {vertices.front(), vertices.front()};
+
+    for (auto &v : vertices) {
+        grid.aabb.min = min(grid.aabb.min, v);
+        grid.aabb.max = max(grid.aabb.max, v);
+    }
+
+    auto extent = grid.aabb.max - grid.aabb.min;
+    auto volume = extent.x * extent.y * extent.z;
+
+    if (!(volume > 0)) {
+        return false;
+    }
+
+    // Voxels are nearly cubic and stretched to fit the AABB exactly, so that
+    // faces aligned with the AABB are captured without error.
+    auto cube_size = std::cbrt(volume / scalar(resolution));
+
+    for (size_t i = 0; i < 3; ++i) {
+        grid.size[i] = std::max(uint32_t(1), static_cast<uint32_t>(std::round(extent[i] / cube_size)));
+        grid.voxel_size[i] = extent[i] / scalar(grid.size[i]);
+    }
+
+    // Cast a ray along the z axis through the center of each column and fill
+    // the voxels between pairs of intersections with the mesh. The rays are
+    // slightly offset to avoid hitting edges and vertices of meshes aligned
+    // with the grid, which would be counted twice.
+    auto num_columns = size_t(grid.size[0]) * grid.size[1];
+    auto column_hits = std::vector<std::vector<scalar>>(num_columns);
+    auto &origin = grid.aabb.min;
+    auto size = grid.voxel_size;
+    const auto offset_x = scalar(0.5) + scalar(1.3e-3);
+    const auto offset_y = scalar(0.5) + scalar(2.9e-3);
+
+    for (size_t tri_idx = 0; tri_idx + 2 < indices.size(); tri_idx += 3) {
+        auto &p0 = vertices[indices[tri_idx + 0]];
+        auto &p1 = vertices[indices[tri_idx + 1]];
+        auto &p2 = vertices[indices[tri_idx + 2]];
+        auto area = cross2(p1.x - p0.x, p1.y - p0.y, p2.x - p0.x, p2.y - p0.y);
+
+        if (area == 0) {
+            continue; // Parallel to rays.
+        }
+
+        auto tri_min = min(min(p0, p1), p2);
+        auto tri_max = max(max(p0, p1), p2);
+        auto i_min = static_cast<uint32_t>(std::max(scalar(0), std::floor((tri_min.x - origin.x) / size.x - offset_x)));
+        auto j_min = static_cast<uint32_t>(std::max(scalar(0), std::floor((tri_min.y - origin.y) / size.y - offset_y)));
+        auto i_max = std::min(grid.size[0] - 1, static_cast<uint32_t>(std::max(scalar(0), (tri_max.x - origin.x) / size.x)));
+        auto j_max = std::min(grid.size[1] - 1, static_cast<uint32_t>(std::max(scalar(0), (tri_max.y - origin.y) / size.y)));
+
+        for (auto i = i_min; i <= i_max; ++i) {
+            auto x = origin.x + (scalar(i) + offset_x) * size.x;
+
+            for (auto j = j_min; j <= j_max; ++j) {
+                auto y = origin.y + (scalar(j) + offset_y) * size.y;
+                auto w0 = cross2(p1.x - x, p1.y - y, p2.x - x, p2.y - y) / area;
+                auto w1 = cross2(p2.x - x, p2.y - y, p0.x - x, p0.y - y) / area;
+                auto w2 = scalar(1) - w0 - w1;
+
+                if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
+                    column_hits[grid.column_index(i, j)].push_back(w0 * p0.z + w1 * p1.z + w2 * p2.z);
+                }
+            }
+        }
+    }
+
+    grid.solid.assign(num_columns * grid.size[2], 0);
+    auto num_solid = size_t{0};
+
+    for (size_t column = 0; column < num_columns; ++column) {
+        auto &hits = column_hits[column];
+        std::sort(hits.begin(), hits.end());
+
+        // An odd number of hits means the mesh is not closed. The last hit
+        // is ignored.
+        for (size_t h = 0; h + 1 < hits.size(); h += 2) {
+            auto k_begin = std::max(scalar(0), std::ceil((hits[h] - origin.z) / size.z - scalar(0.5)));
+            auto k_end = std::min(scalar(grid.size[2]), std::floor((hits[h + 1] - origin.z) / size.z - scalar(0.5)) + 1);
+
+            for (auto k = static_cast<uint32_t>(k_begin); k < k_end; ++k) {
+                grid.solid[column * grid.size[2] + k] = 1;
+                ++num_solid;
+            }
+        }
+    }
+
+    return num_solid > 0;
+}
+
+// Volume of a convex polyhedron with counter-clockwise faces.
+scalar convex_hull_volume(const std::vector<vector3> &vertices,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &faces) {
+    auto volume = scalar(0);
+
+    for (size_t i = 0; i < faces.size(); i += 2) {
+        auto first = faces[i];
+        auto count = faces[i + 1];
+        auto &v0 = vertices[indices[first]];
+
+        for (size_t j = 1; j + 1 < count; ++j) {
+            auto &v1 = vertices[indices[first + j]];
+            auto &v2 = vertices[indices[first + j + 1]];
+            volume += dot(v0, cross(v1, v2));
+        }
+    }
+
+    return volume / scalar(6);
+}
+
+// Gathers the voxels inside a box into a piece and measures its concavity.
+voxel_piece make_piece(const voxel_grid &grid, const voxel_box &box) {
+    auto piece = voxel_piece{};
+    piece.box.min = box.max;
+    piece.box.max = box.min;
+
+    // The convex hull of the voxels in a column is the convex hull of the
+    // bottom face of the lowest voxel and the top face of the highest voxel.
+    // Corners are identified by their index in the grid of corners.
+    auto corner_ids = std::vector<uint64_t>{};
+    const uint64_t stride_k = 1;
+    const uint64_t stride_j = grid.size[2] + 1;
+    const uint64_t stride_i = stride_j * (grid.size[1] + 1);
+
+    for (auto i = box.min[0]; i < box.max[0]; ++i) {
+        for (auto j = box.min[1]; j < box.max[1]; ++j) {
+            auto k_first = box.max[2];
+            auto k_last = box.max[2];
+
+            for (auto k = box.min[2]; k < box.max[2]; ++k) {
+                if (grid.is_solid(i, j, k)) {
+                    if (k_first == box.max[2]) {
+                        k_first = k;
+                    }
+
+                    k_last = k;
+                    ++piece.num_voxels;
+                }
+            }
+
+            if (k_first == box.max[2]) {
+                continue;
+            }
+
+            piece.box.min = {std::min(piece.box.min[0], i), std::min(piece.box.min[1], j), std::min(piece.box.min[2], k_first)};
+            piece.box.max = {std::max(piece.box.max[0], i + 1), std::max(piece.box.max[1], j + 1), std::max(piece.box.max[2], k_last + 1)};
+
+            for (uint64_t di = 0; di < 2; ++di) {
+                for (uint64_t dj = 0; dj < 2; ++dj) {
+                    auto column_id = (i + di) * stride_i + (j + dj) * stride_j;
+                    corner_ids.push_back(column_id + k_first * stride_k);
+                    corner_ids.push_back(column_id + (k_last + 1) * stride_k);
+                }
+            }
+        }
+    }
+
+    if (piece.num_voxels == 0) {
+        piece.splittable = false;
+        return piece;
+    }
+
+    std::sort(corner_ids.begin(), corner_ids.end());
+    corner_ids.erase(std::unique(corner_ids.begin(), corner_ids.end()), corner_ids.end());
+    piece.points.reserve(corner_ids.size());
+
+    for (auto id : corner_ids) {
+        auto corner = vector3{
+            scalar(id / stride_i),
+            scalar((id % stride_i) / stride_j),
+            scalar(id % stride_j)
+        };
+        piece.points.push_back(grid.aabb.min + corner * grid.voxel_size);
+    }
+
+    std::vector<vector3> hull_vertices;
+    std::vector<uint32_t> hull_indices, hull_faces;
+    auto voxel_volume = grid.voxel_size.x * grid.voxel_size.y * grid.voxel_size.z;
+    auto volume = scalar(piece.num_voxels) * voxel_volume;
+
+    if (make_convex_hull_mesh(piece.points, hull_vertices, hull_indices, hull_faces)) {
+        auto hull_volume = convex_hull_volume(hull_vertices, hull_indices, hull_faces);
+        piece.concavity = std::max(scalar(0), hull_volume - volume);
+    } else {
+        piece.splittable = false;
+    }
+
+    return piece;
+}
+
+// Finds the axis-aligned plane which splits the piece into two parts whose
+// total concavity is the lowest. Often, a single cut does not reduce the
+// concavity by itself, e.g. cutting a torus in half, in which case it's
+// preferable to cut across the longest axis close to the middle, which
+// makes it more likely for the next cuts to be effective.
+bool split_piece(const voxel_grid &grid, const voxel_piece &piece, size_t num_planes,
+                 enqueue_task_wait_t *enqueue_task_wait, voxel_piece &first, voxel_piece &second) {
+    auto candidates = std::vector<split_candidate>{};
+    auto positions = std::vector<uint32_t>{};
+    uint32_t max_length = 0;
+
+    for (size_t axis = 0; axis < 3; ++axis) {
+        max_length = std::max(max_length, piece.box.max[axis] - piece.box.min[axis]);
+    }
+
+    for (size_t axis = 0; axis < 3; ++axis) {
+        auto begin = piece.box.min[axis];
+        auto length = piece.box.max[axis] - begin;
+        positions.clear();
+        positions.push_back(begin + length / 2);
+
+        for (size_t i = 0; i < num_planes; ++i) {
+            positions.push_back(begin + static_cast<uint32_t>(length * (i + 1) / (num_planes + 1)));
+        }
+
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+        for (auto position : positions) {
+            if (position > begin && position < piece.box.max[axis]) {
+                candidates.push_back({axis, position});
+            }
+        }
+    }
+
+    run_tasks(candidates.size(), enqueue_task_wait, [&](size_t idx) {
+        auto &candidate = candidates[idx];
+        auto box0 = piece.box;
+        auto box1 = piece.box;
+        box0.max[candidate.axis] = candidate.position;
+        box1.min[candidate.axis] = candidate.position;
+        candidate.pieces[0] = make_piece(grid, box0);
+        candidate.pieces[1] = make_piece(grid, box1);
+    });
+
+    auto best_idx = candidates.size();
+    auto best_cost = EDYN_SCALAR_MAX;
+
+    for (size_t idx = 0; idx < candidates.size(); ++idx) {
+        auto &candidate = candidates[idx];
+
+        if (candidate.pieces[0].num_voxels == 0 || candidate.pieces[1].num_voxels == 0) {
+            continue;
+        }
+
+        auto num_voxels0 = scalar(candidate.pieces[0].num_voxels);
+        auto num_voxels1 = scalar(candidate.pieces[1].num_voxels);
+        auto balance = std::abs(num_voxels0 - num_voxels1) / (num_voxels0 + num_voxels1);
+        auto length = piece.box.max[candidate.axis] - piece.box.min[candidate.axis];
+        auto shortness = scalar(1) - scalar(length) / scalar(max_length);
+        auto cost = candidate.pieces[0].concavity + candidate.pieces[1].concavity +
+                    split_bias * piece.concavity * (balance + shortness);
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_idx = idx;
+        }
+    }
+
+    if (best_idx == candidates.size()) {
+        return false;
+    }
+
+    first = std::move(candidates[best_idx].pieces[0]);
+    second = std::move(candidates[best_idx].pieces[1]);
+    return true;
+}
+
+uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+    // FNV-1a.
+    auto *bytes = static_cast<const uint8_t *>(data);
+
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+uint64_t decomposition_key(const std::vector<vector3> &vertices,
+                           const std::vector<uint32_t> &indices,
+                           const convex_decomposition_settings &settings) {
+    auto hash = uint64_t(0xcbf29ce484222325ull);
+    hash = hash_bytes(hash, vertices.data(), vertices.size() * sizeof(vector3));
+    hash = hash_bytes(hash, indices.data(), indices.size() * sizeof(uint32_t));
+    uint64_t params[] = {settings.resolution, settings.max_hulls, settings.max_hull_vertices, settings.num_split_planes};
+    hash = hash_bytes(hash, params, sizeof(params));
+    hash = hash_bytes(hash, &settings.max_concavity, sizeof(scalar));
+    return hash;
+}
+
+// Vertices are written as three scalars each and read back in bulk.
+static_assert(sizeof(vector3) == 3 * sizeof(scalar));
+
+// Reads values from a memory buffer. Counts are checked against the bytes
+// left before anything is allocated, thus a truncated or corrupted cache
+// file is rejected instead of being read past its end.
+struct cache_reader {
+    const uint8_t *data;
+    size_t size;
+    size_t position {0};
+
+    template<typename T>
+    bool read(T *values, uint64_t count) {
+        if (count > (size - position) / sizeof(T)) {
+            return false;
+        }
+
+        if (count == 0) {
+            return true;
+        }
+
+        std::memcpy(values, data + position, count * sizeof(T));
+        position += count * sizeof(T);
+        return true;
+    }
+
+    template<typename T>
+    bool read(std::vector<T> &values) {
+        auto count = uint64_t{};
+
+        if (!read(&count, 1) || count > (size - position) / sizeof(T)) {
+            return false;
+        }
+
+        values.resize(count);
+        return read(values.data(), count);
+    }
+};
+
+// Cache layout: key, number of hulls and, for each hull, its position
+// followed by its vertices, indices and faces, each prefixed by its count.
+bool read_decomposition_cache(const mapped_file &file, uint64_t key, compound_shape &compound) {
+    auto reader = cache_reader{file.data(), file.size()};
+    auto stored_key = uint64_t{};
+    auto num_hulls = uint64_t{};
+
+    if (!reader.read(&stored_key, 1) || stored_key != key || !reader.read(&num_hulls, 1)) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < num_hulls; ++i) {
+        scalar position[3];
+        auto mesh = std::make_shared<convex_mesh>();
+
+        if (!reader.read(position, 3) ||
+            !reader.read(mesh->vertices) ||
+            !reader.read(mesh->indices) ||
+            !reader.read(mesh->faces)) {
+            return false;
+        }
+
+        if (mesh->vertices.size() < 4 || mesh->faces.size() < 8 || mesh->faces.size() % 2 != 0) {
+            return false;
+        }
+
+        for (auto idx : mesh->indices) {
+            if (idx >= mesh->vertices.size()) {
+                return false;
+            }
+        }
+
+        for (size_t j = 0; j < mesh->faces.size(); j += 2) {
+            if (mesh->faces[j + 1] < 3 ||
+                size_t(mesh->faces[j]) + mesh->faces[j + 1] > mesh->indices.size()) {
+                return false;
+            }
+        }
+
+        mesh->update_calculated_properties();
+        compound.add_shape(polyhedron_shape(mesh), {position[0], position[1], position[2]}, quaternion_identity);
+    }
+
+    if (reader.position != reader.size || compound.nodes.empty()) {
+        return false;
+    }
+
+    compound.finish();
+    return true;
+}
+
+void write_decomposition_cache(const std::string &path, uint64_t key, const compound_shape &compound) {
+    auto output = file_output_archive(path);
+    auto num_hulls = uint64_t(compound.nodes.size());
+    output(key);
+    output(num_hulls);
+
+    auto write_vector = [&](const auto &values) {
+        auto count = uint64_t(values.size());
+        output(count);
+        output.serialize_range(values.data(), values.size());
+    };
+
+    for (auto &node : compound.nodes) {
+        auto &mesh = *std::get<polyhedron_shape>(node.shape_var).mesh;
+        auto position = node.position;
+        output(position.x, position.y, position.z);
+
+        auto count = uint64_t(mesh.vertices.size());
+        output(count);
+
+        for (auto v : mesh.vertices) {
+            output(v.x, v.y, v.z);
+        }
+
+        write_vector(mesh.indices);
+        write_vector(mesh.faces);
+    }
+}
+
+compound_shape decompose_convex_uncached(const std::vector<vector3> &vertices,
+                                         const std::vector<uint32_t> &indices,
+                                         const convex_decomposition_settings &settings,
+                                         enqueue_task_wait_t *enqueue_task_wait) {
+    auto grid = voxel_grid{};
+
+    if (!voxelize(vertices, indices, settings.resolution, grid)) {
+        return {};
+    }
+
+    auto pieces = std::vector<voxel_piece>{};
+    pieces.push_back(make_piece(grid, {{0, 0, 0}, grid.size}));
+
+    auto voxel_volume = grid.voxel_size.x * grid.voxel_size.y * grid.voxel_size.z;
+    auto max_concavity = settings.max_concavity * scalar(pieces.front().num_voxels) * voxel_volume;
+
+    // Split the most concave piece until the budget is exhausted.
+    while (pieces.size() < settings.max_hulls) {
+        auto piece_it = std::max_element(pieces.begin(), pieces.end(), [](auto &a, auto &b) {
+            return (a.splittable ? a.concavity : scalar(0)) < (b.splittable ? b.concavity : scalar(0));
+        });
+
+        if (!piece_it->splittable || piece_it->concavity <= max_concavity) {
+            break;
+        }
+
+        auto first = voxel_piece{};
+        auto second = voxel_piece{};
+
+        if (split_piece(grid, *piece_it, settings.num_split_planes, enqueue_task_wait, first, second)) {
+            *piece_it = std::move(first);
+            pieces.push_back(std::move(second));
+        } else {
+            piece_it->splittable = false;
+        }
+    }
+
+    auto polyhedrons = std::vector<polyhedron_with_center>(pieces.size());
+    auto valid = std::vector<uint8_t>(pieces.size(), 0);
+
+    run_tasks(pieces.size(), enqueue_task_wait, [&](size_t idx) {
+        auto mesh = std::make_shared<convex_mesh>();
+
+        if (!make_convex_hull_mesh(pieces[idx].points, mesh->vertices, mesh->indices,
+                                   mesh->faces, settings.max_hull_vertices)) {
+            return;
+        }
+
+        // Position vertices with respect to the centroid, which is where the
+        // polyhedron is placed in the compound.
+        auto center = mesh_centroid(mesh->vertices, mesh->indices, mesh->faces);
+
+        for (auto &v : mesh->vertices) {
+            v -= center;
+        }
+
+        mesh->update_calculated_properties();
+        polyhedrons[idx].shape = polyhedron_shape(mesh);
+        polyhedrons[idx].center = center;
+        valid[idx] = 1;
+    });
+
+    auto compound = compound_shape{};
+
+    for (size_t idx = 0; idx < polyhedrons.size(); ++idx) {
+        if (valid[idx]) {
+            compound.add_shape(polyhedrons[idx].shape, polyhedrons[idx].center, quaternion_identity);
+        }
+    }
+
+    if (!compound.nodes.empty()) {
+        compound.finish();
+    }
+
+    return compound;
+}
+
+}
+
+compound_shape decompose_convex(const std::vector<vector3> &vertices,
+                                const std::vector<uint32_t> &indices,
+                                const convex_decomposition_settings &settings,
+                                enqueue_task_wait_t *enqueue_task_wait) {
+    if (settings.cache_path.empty()) {
+        return decompose_convex_uncached(vertices, indices, settings, enqueue_task_wait);
+    }
+
+    // The cache file starts with a key derived from the input, which must
+    // match for the stored decomposition to be used.
+    auto key = decomposition_key(vertices, indices, settings);
+
+    {
+        auto file = mapped_file(settings.cache_path);
+        auto compound = compound_shape{};
+
+        if (file.is_open() && read_decomposition_cache(file, key, compound)) {
+            return compound;
+        }
+    }
+
+    auto compound = decompose_convex_uncached(vertices, indices, settings, enqueue_task_wait);
+
+    if (!compound.nodes.empty()) {
+        write_decomposition_cache(settings.cache_path, key, compound);
+    }
+
+    return compound;
+}
+
+compound_shape decompose_convex(const triangle_mesh &mesh,
+                                const convex_decomposition_settings &settings,
+                                enqueue_task_wait_t *enqueue_task_wait) {
+    auto vertices = std::vector<vector3>(mesh.num_vertices());
+    auto indices = std::vector<uint32_t>(mesh.num_triangles() * 3);
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i] = mesh.get_vertex_position(i);
+    }
+
+    for (size_t i = 0; i < mesh.num_triangles(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            indices[i * 3 + j] = mesh.get_face_vertex_index(i, j);
+        }
+    }
+
+    return decompose_convex(vertices, indices, settings, enqueue_task_wait);
+}
+
+compound_shape decompose_convex(const obj_mesh &mesh,
+                                const convex_decomposition_settings &settings,
+                                enqueue_task_wait_t *enqueue_task_wait) {
+    auto indices = std::vector<uint32_t>{};
+
+    for (size_t i = 0; i + 1 < mesh.faces.size(); i += 2) {
+        auto first = mesh.faces[i];
+        auto count = mesh.faces[i + 1];
+
+        for (size_t j = 1; j + 1 < count; ++j) {
+            indices.push_back(mesh.indices[first]);
+            indices.push_back(mesh.indices[first + j]);
+            indices.push_back(mesh.indices[first + j + 1]);
+        }
+    }
+
+    return decompose_convex(mesh.vertices, indices, settings, enqueue_task_wait);
+}
+
+}
@@ -0,0 +1,623 @@
+#include "edyn/util/convex_hull.hpp"
+#include "edyn/config/config.h"
+#include "edyn/config/constants.hpp"
+#include "edyn/math/math.hpp"
+#include <entt/signal/delegate.hpp>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <array>
+#include <queue>
+#include <tuple>
+
+namespace edyn {
+
+namespace {
+
+constexpr auto null_face = std::numeric_limits<uint32_t>::max();
+
+struct hull_face {
+    // Vertex indices in counter-clockwise order viewed from outside.
+    std::array<uint32_t, 3> vertices;
+    // Face across the edge from `vertices[i]` to `vertices[(i + 1) % 3]`.
+    std::array<uint32_t, 3> neighbors {null_face, null_face, null_face};
+    vector3 normal;
+    scalar offset;
+    // Points in front of this face which haven't been added to the hull.
+    std::vector<uint32_t> outside;
+    bool alive {true};
+};
+
+uint64_t edge_key(uint32_t v0, uint32_t v1) {
+    return (uint64_t(v0) << 32) | uint64_t(v1);
+}
+
+/**
+ * Incremental quickhull over a subset of a point cloud. Points are referred
+ * to by their index in the point cloud.
+ */
+class quickhull {
+public:
+    quickhull(const std::vector<vector3> &points, scalar tolerance)
+        : m_points(&points)
+        , m_tolerance(tolerance)
+    {}
+
+    bool build(const std::vector<uint32_t> &ids, size_t max_vertices);
+
+    // Indices of the points which are vertices of the hull.
+    std::vector<uint32_t> vertex_ids() const;
+
+    const std::vector<hull_face> & faces() const {
+        return m_faces;
+    }
+
+private:
+    scalar distance(const hull_face &face, uint32_t point_idx) const {
+        return dot(face.normal, (*m_points)[point_idx]) - face.offset;
+    }
+
+    uint32_t add_face(uint32_t v0, uint32_t v1, uint32_t v2);
+    bool create_simplex(const std::vector<uint32_t> &ids);
+    void assign_outside(const std::vector<uint32_t> &ids, const std::vector<uint32_t> &face_indices);
+    bool add_point(uint32_t face_idx, uint32_t point_idx);
+
+    const std::vector<vector3> *m_points;
+    scalar m_tolerance;
+    std::vector<hull_face> m_faces;
+    size_t m_num_vertices {0};
+
+    // Scratch buffers reused in each iteration.
+    std::vector<uint32_t> m_visible;
+    std::vector<std::pair<uint32_t, uint32_t>> m_horizon;
+    std::vector<uint32_t> m_new_faces;
+    std::vector<uint32_t> m_orphans;
+    std::vector<bool> m_is_visible;
+};
+
+uint32_t quickhull::add_face(uint32_t v0, uint32_t v1, uint32_t v2) {
+    auto &points = *m_points;
+    auto face = hull_face{};
+    face.vertices = {v0, v1, v2};
+    face.normal = cross(points[v1] - points[v0], points[v2] - points[v0]);
+
+    if (!try_normalize(face.normal)) {
+        // Degenerate face. Use any direction since it'll be removed once the
+        // points around it are added to the hull.
+        face.normal = vector3_y;
+    }
+
+    face.offset = dot(face.normal, points[v0]);
+
+    auto face_idx = static_cast<uint32_t>(m_faces.size());
+    m_faces.push_back(std::move(face));
+    m_is_visible.push_back(false);
+    return face_idx;
+}
+
+bool quickhull::create_simplex(const std::vector<uint32_t> &ids) {
+    auto &points = *m_points;
+
+    // Find extreme points along each axis and pick the pair which is furthest
+    // apart as the first edge.
+    std::array<uint32_t, 6> extremes;
+    extremes.fill(ids.front());
+
+    for (auto idx : ids) {
+        for (size_t i = 0; i < 3; ++i) {
+            if (points[idx][i] < points[extremes[i * 2]][i]) extremes[i * 2] = idx;
+            if (points[idx][i] > points[extremes[i * 2 + 1]][i]) extremes[i * 2 + 1] = idx;
+        }
+    }
+
+    uint32_t i0 = extremes[0], i1 = extremes[1];
+    auto max_dist_sqr = scalar(0);
+
+    for (size_t i = 0; i < extremes.size(); ++i) {
+        for (size_t j = i + 1; j < extremes.size(); ++j) {
+            auto dist_sqr = distance_sqr(points[extremes[i]], points[extremes[j]]);
+
+            if (dist_sqr > max_dist_sqr) {
+                max_dist_sqr = dist_sqr;
+                i0 = extremes[i];
+                i1 = extremes[j];
+            }
+        }
+    }
+
+    if (!(max_dist_sqr > m_tolerance * m_tolerance)) {
+        return false;
+    }
+
+    // Third point is the furthest from the line.
+    auto dir = normalize(points[i1] - points[i0]);
+    auto i2 = i0;
+    max_dist_sqr = 0;
+
+    for (auto idx : ids) {
+        auto dist_sqr = length_sqr(cross(points[idx] - points[i0], dir));
+
+        if (dist_sqr > max_dist_sqr) {
+            max_dist_sqr = dist_sqr;
+            i2 = idx;
+        }
+    }
+
+    if (!(max_dist_sqr > m_tolerance * m_tolerance)) {
+        return false;
+    }
+
+    // Fourth point is the furthest from the plane.
+    auto normal = normalize(cross(points[i1] - points[i0], points[i2] - points[i0]));
+    auto i3 = i0;
+    auto max_dist = scalar(0);
+
+    for (auto idx : ids) {
+        auto dist = std::abs(dot(points[idx] - points[i0], normal));
+
+        if (dist > max_dist) {
+            max_dist = dist;
+            i3 = idx;
+        }
+    }
+
+    if (!(max_dist > m_tolerance)) {
+        return false;
+    }
+
+    // Orient the base so that the fourth point lies behind it.
+    if (dot(points[i3] - points[i0], normal) > 0) {
+        std::swap(i1, i2);
+    }
+
+    add_face(i0, i1, i2);
+    add_face(i0, i3, i1);
+    add_face(i1, i3, i2);
+    add_face(i2, i3, i0);
+    m_num_vertices = 4;
+
+    // Link neighbors by matching each edge with its twin.
+    auto edges = std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>>{};
+
+    for (uint32_t face_idx = 0; face_idx < 4; ++face_idx) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            auto &verts = m_faces[face_idx].vertices;
+            edges[edge_key(verts[i], verts[(i + 1) % 3])] = {face_idx, i};
+        }
+    }
+
+    for (auto &face : m_faces) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            auto twin = edges.at(edge_key(face.vertices[(i + 1) % 3], face.vertices[i]));
+            face.neighbors[i] = twin.first;
+        }
+    }
+
+    auto face_indices = std::vector<uint32_t>{0, 1, 2, 3};
+    assign_outside(ids, face_indices);
+
+    return true;
+}
+
+void quickhull::assign_outside(const std::vector<uint32_t> &ids,
+                               const std::vector<uint32_t> &face_indices) {
+    for (auto idx : ids) {
+        for (auto face_idx : face_indices) {
+            auto &face = m_faces[face_idx];
+
+            if (distance(face, idx) > m_tolerance) {
+                face.outside.push_back(idx);
+                break;
+            }
+        }
+    }
+}
+
+bool quickhull::add_point(uint32_t start_face_idx, uint32_t point_idx) {
+    // Find all faces visible from the point, which form a connected region
+    // around the starting face, and the horizon edges around that region.
+    m_visible.clear();
+    m_horizon.clear();
+    m_visible.push_back(start_face_idx);
+    m_is_visible[start_face_idx] = true;
+
+    for (size_t i = 0; i < m_visible.size(); ++i) {
+        auto face_idx = m_visible[i];
+
+        for (uint32_t j = 0; j < 3; ++j) {
+            auto neighbor_idx = m_faces[face_idx].neighbors[j];
+
+            if (m_is_visible[neighbor_idx]) {
+                continue;
+            }
+
+            if (distance(m_faces[neighbor_idx], point_idx) > m_tolerance) {
+                m_is_visible[neighbor_idx] = true;
+                m_visible.push_back(neighbor_idx);
+            } else {
+                m_horizon.emplace_back(face_idx, j);
+            }
+        }
+    }
+
+    // The horizon must be a simple loop. Due to numerical imprecision it
+    // might not be, in which case the point is ignored.
+    auto next_vertex = std::unordered_map<uint32_t, uint32_t>{};
+    auto is_simple_loop = true;
+
+    for (auto [face_idx, edge_idx] : m_horizon) {
+        auto &verts = m_faces[face_idx].vertices;
+        is_simple_loop &= next_vertex.emplace(verts[edge_idx], verts[(edge_idx + 1) % 3]).second;
+    }
+
+    if (is_simple_loop && !m_horizon.empty()) {
+        auto count = size_t{0};
+        auto start = next_vertex.begin()->first;
+        auto v = start;
+
+        do {
+            auto it = next_vertex.find(v);
+
+            if (it == next_vertex.end()) {
+                break;
+            }
+
+            v = it->second;
+            ++count;
+        } while (v != start && count <= m_horizon.size());
+
+        is_simple_loop = v == start && count == m_horizon.size();
+    }
+
+    if (!is_simple_loop) {
+        for (auto face_idx : m_visible) {
+            m_is_visible[face_idx] = false;
+        }
+
+        return false;
+    }
+
+    // Vertices of visible faces which are not on the horizon become interior.
+    auto removed_vertices = std::vector<uint32_t>{};
+
+    for (auto face_idx : m_visible) {
+        for (auto v : m_faces[face_idx].vertices) {
+            if (next_vertex.count(v) == 0) {
+                removed_vertices.push_back(v);
+            }
+        }
+    }
+
+    std::sort(removed_vertices.begin(), removed_vertices.end());
+    auto num_removed = std::distance(removed_vertices.begin(),
+                                     std::unique(removed_vertices.begin(), removed_vertices.end()));
+    m_num_vertices = m_num_vertices + 1 - num_removed;
+
+    // Create a new face for each horizon edge connecting it to the point.
+    m_new_faces.clear();
+    auto face_by_first_vertex = std::unordered_map<uint32_t, uint32_t>{};
+
+    for (auto [face_idx, edge_idx] : m_horizon) {
+        auto v0 = m_faces[face_idx].vertices[edge_idx];
+        auto v1 = m_faces[face_idx].vertices[(edge_idx + 1) % 3];
+        auto neighbor_idx = m_faces[face_idx].neighbors[edge_idx];
+        auto new_face_idx = add_face(v0, v1, point_idx);
+
+        // Link with face on the other side of the horizon.
+        auto &neighbor = m_faces[neighbor_idx];
+        auto twin_idx = std::find(neighbor.neighbors.begin(), neighbor.neighbors.end(), face_idx);
+        EDYN_ASSERT(twin_idx != neighbor.neighbors.end());
+        *twin_idx = new_face_idx;
+        m_faces[new_face_idx].neighbors[0] = neighbor_idx;
+
+        face_by_first_vertex[v0] = new_face_idx;
+        m_new_faces.push_back(new_face_idx);
+    }
+
+    // Link new faces among themselves. The edge going from the second
+    // vertex to the point is shared with the face that starts at the second
+    // vertex.
+    for (auto face_idx : m_new_faces) {
+        auto &face = m_faces[face_idx];
+        auto next_face_idx = face_by_first_vertex.at(face.vertices[1]);
+        face.neighbors[1] = next_face_idx;
+        m_faces[next_face_idx].neighbors[2] = face_idx;
+    }
+
+    // Remove visible faces and move their outside points to the new faces.
+    m_orphans.clear();
+
+    for (auto face_idx : m_visible) {
+        auto &face = m_faces[face_idx];
+        face.alive = false;
+        m_orphans.insert(m_orphans.end(), face.outside.begin(), face.outside.end());
+        face.outside.clear();
+        face.outside.shrink_to_fit();
+        m_is_visible[face_idx] = false;
+    }
+
+    m_orphans.erase(std::remove(m_orphans.begin(), m_orphans.end(), point_idx), m_orphans.end());
+    assign_outside(m_orphans, m_new_faces);
+
+    return true;
+}
+
+bool quickhull::build(const std::vector<uint32_t> &ids, size_t max_vertices) {
+    m_faces.clear();
+    m_is_visible.clear();
+
+    if (ids.size() < 4 || !create_simplex(ids)) {
+        return false;
+    }
+
+    // Always add the point furthest away from the hull first. When the number
+    // of vertices is limited, this keeps the largest features of the cloud.
+    using pending_point = std::tuple<scalar, uint32_t, uint32_t>; // Distance, face, point.
+    auto pending = std::priority_queue<pending_point>{};
+
+    auto push_furthest = [&](uint32_t face_idx) {
+        auto &face = m_faces[face_idx];
+
+        if (face.outside.empty()) {
+            return;
+        }
+
+        auto furthest_it = std::max_element(face.outside.begin(), face.outside.end(),
+            [&](auto a, auto b) { return distance(face, a) < distance(face, b); });
+        pending.emplace(distance(face, *furthest_it), face_idx, *furthest_it);
+    };
+
+    for (uint32_t face_idx = 0; face_idx < 4; ++face_idx) {
+        push_furthest(face_idx);
+    }
+
+    while (!pending.empty()) {
+        if (max_vertices > 0 && m_num_vertices >= max_vertices) {
+            break;
+        }
+
+        auto [dist, face_idx, point_idx] = pending.top();
+        pending.pop();
+
+        if (!m_faces[face_idx].alive) {
+            continue;
+        }
+
+        if (add_point(face_idx, point_idx)) {
+            for (auto new_face_idx : m_new_faces) {
+                push_furthest(new_face_idx);
+            }
+        } else {
+            auto &outside = m_faces[face_idx].outside;
+            outside.erase(std::find(outside.begin(), outside.end(), point_idx));
+            push_furthest(face_idx);
+        }
+    }
+
+    return true;
+}
+
+std::vector<uint32_t> quickhull::vertex_ids() const {
+    auto ids = std::vector<uint32_t>{};
+
+    for (auto &face : m_faces) {
+        if (face.alive) {
+            ids.insert(ids.end(), face.vertices.begin(), face.vertices.end());
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+// Merges adjacent coplanar triangles into polygons and writes the result.
+// Merging only happens within numerical tolerance, since merging nearly
+// coplanar triangles can produce non-planar or concave polygons.
+void write_hull_mesh(const std::vector<vector3> &points, const std::vector<hull_face> &hull_faces,
+                     scalar merge_tolerance, std::vector<vector3> &vertices,
+                     std::vector<uint32_t> &indices, std::vector<uint32_t> &faces) {
+    // Map point indices to vertex indices.
+    auto vertex_map = std::unordered_map<uint32_t, uint32_t>{};
+
+    auto get_vertex = [&](uint32_t point_idx) {
+        auto [it, inserted] = vertex_map.emplace(point_idx, static_cast<uint32_t>(vertices.size()));
+
+        if (inserted) {
+            vertices.push_back(points[point_idx]);
+        }
+
+        return it->second;
+    };
+
+    // Group faces that lie on the plane of the first face in the group.
+    auto group = std::vector<uint32_t>(hull_faces.size(), null_face);
+    auto stack = std::vector<uint32_t>{};
+    auto group_faces = std::vector<uint32_t>{};
+    auto next_vertex = std::unordered_map<uint32_t, uint32_t>{};
+    uint32_t num_groups = 0;
+
+    for (uint32_t seed_idx = 0; seed_idx < hull_faces.size(); ++seed_idx) {
+        if (!hull_faces[seed_idx].alive || group[seed_idx] != null_face) {
+            continue;
+        }
+
+        auto &seed = hull_faces[seed_idx];
+        auto group_idx = num_groups++;
+        group[seed_idx] = group_idx;
+        group_faces.clear();
+        stack.push_back(seed_idx);
+
+        while (!stack.empty()) {
+            auto face_idx = stack.back();
+            stack.pop_back();
+            group_faces.push_back(face_idx);
+
+            for (auto neighbor_idx : hull_faces[face_idx].neighbors) {
+                if (group[neighbor_idx] != null_face) {
+                    continue;
+                }
+
+                auto &neighbor = hull_faces[neighbor_idx];
+
+                if (dot(neighbor.normal, seed.normal) < scalar(1) - convex_mesh_relevant_direction_tolerance) {
+                    continue;
+                }
+
+                auto is_coplanar = std::all_of(neighbor.vertices.begin(), neighbor.vertices.end(), [&](auto v) {
+                    return std::abs(dot(seed.normal, points[v]) - seed.offset) < merge_tolerance;
+                });
+
+                if (is_coplanar) {
+                    group[neighbor_idx] = group_idx;
+                    stack.push_back(neighbor_idx);
+                }
+            }
+        }
+
+        // Follow the boundary of the group to obtain the polygon.
+        next_vertex.clear();
+        size_t num_boundary_edges = 0;
+
+        for (auto face_idx : group_faces) {
+            auto &face = hull_faces[face_idx];
+
+            for (size_t i = 0; i < 3; ++i) {
+                if (group[face.neighbors[i]] != group_idx) {
+                    next_vertex[face.vertices[i]] = face.vertices[(i + 1) % 3];
+                    ++num_boundary_edges;
+                }
+            }
+        }
+
+        auto polygon_start = indices.size();
+        auto start = hull_faces[group_faces.front()].vertices[0];
+
+        if (next_vertex.count(start) == 0) {
+            start = next_vertex.begin()->first;
+        }
+
+        auto v = start;
+
+        do {
+            indices.push_back(get_vertex(v));
+            v = next_vertex.at(v);
+        } while (v != start && indices.size() - polygon_start <= num_boundary_edges);
+
+        if (indices.size() - polygon_start == num_boundary_edges) {
+            // Polygons can have collinear vertices along their edges. Start at
+            // the sharpest corner so the normal computed from the first edges
+            // by `convex_mesh` isn't derived from nearly parallel edges.
+            auto polygon_begin = indices.begin() + polygon_start;
+            auto best_corner = size_t{0};
+            auto best_sharpness = scalar(-1);
+
+            for (size_t i = 0; i < num_boundary_edges; ++i) {
+                auto &v0 = vertices[polygon_begin[i]];
+                auto &v1 = vertices[polygon_begin[(i + 1) % num_boundary_edges]];
+                auto &v2 = vertices[polygon_begin[(i + 2) % num_boundary_edges]];
+                auto e0 = v1 - v0;
+                auto e1 = v2 - v1;
+                auto sharpness = length_sqr(cross(e0, e1)) / (length_sqr(e0) * length_sqr(e1));
+
+                if (sharpness > best_sharpness) {
+                    best_sharpness = sharpness;
+                    best_corner = i;
+                }
+            }
+
+            std::rotate(polygon_begin, polygon_begin + best_corner, indices.end());
+            faces.push_back(polygon_start);
+            faces.push_back(num_boundary_edges);
+        } else {
+            // Boundary is not a single loop. Keep the triangles.
+            indices.resize(polygon_start);
+
+            for (auto face_idx : group_faces) {
+                faces.push_back(indices.size());
+                faces.push_back(3);
+
+                for (auto v : hull_faces[face_idx].vertices) {
+                    indices.push_back(get_vertex(v));
+                }
+            }
+        }
+    }
+}
+
+}
+
+bool make_convex_hull_mesh(const std::vector<vector3> &points,
+                           std::vector<vector3> &vertices,
+                           std::vector<uint32_t> &indices,
+                           std::vector<uint32_t> &faces,
+                           size_t max_vertices,
+                           enqueue_task_wait_t *enqueue_task_wait) {
+    if (points.size() < 4) {
+        return false;
+    }
+
+    // Tolerance proportional to the magnitude of the coordinates.
+    auto max_abs = vector3_zero;
+
+    for (auto &p : points) {
+        max_abs = max(max_abs, abs(p));
+    }
+
+    const auto tolerance = scalar(3) * std::numeric_limits<scalar>::epsilon() *
+                           (max_abs.x + max_abs.y + max_abs.z);
+
+    auto ids = std::vector<uint32_t>(points.size());
+    std::iota(ids.begin(), ids.end(), 0);
+
+    // Large point clouds are split into chunks whose hulls are calculated in
+    // parallel. Only points that are vertices of these partial hulls can be
+    // vertices of the final hull.
+    const size_t min_chunk_size = 4096;
+    const size_t max_num_chunks = 32;
+
+    if (enqueue_task_wait != nullptr && points.size() >= min_chunk_size * 2) {
+        auto num_chunks = std::min(max_num_chunks, points.size() / min_chunk_size);
+        auto chunk_ids = std::vector<std::vector<uint32_t>>(num_chunks);
+
+        auto task_func = [&](unsigned start, unsigned end) {
+            for (auto i = start; i < end; ++i) {
+                auto first = points.size() * i / num_chunks;
+                auto last = points.size() * (i + 1) / num_chunks;
+                auto subset = std::vector<uint32_t>(ids.begin() + first, ids.begin() + last);
+                auto hull = quickhull(points, tolerance);
+
+                if (hull.build(subset, 0)) {
+                    chunk_ids[i] = hull.vertex_ids();
+                } else {
+                    chunk_ids[i] = std::move(subset);
+                }
+            }
+        };
+
+        auto task = task_delegate_t(entt::connect_arg_t<&decltype(task_func)::operator()>{}, task_func);
+        (*enqueue_task_wait)(task, num_chunks);
+
+        ids.clear();
+
+        for (auto &chunk : chunk_ids) {
+            ids.insert(ids.end(), chunk.begin(), chunk.end());
+        }
+    }
+
+    auto hull = quickhull(points, tolerance);
+
+    if (!hull.build(ids, max_vertices)) {
+        return false;
+    }
+
+    vertices.clear();
+    indices.clear();
+    faces.clear();
+    write_hull_mesh(points, hull.faces(), tolerance, vertices, indices, faces);
+
+    return true;
+}
+
+}
@@ -1,248 +1,415 @@
 #include "edyn/util/shape_io.hpp"
 #include "edyn/shapes/compound_shape.hpp"
 #include "edyn/shapes/polyhedron_shape.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
 #include "edyn/util/shape_util.hpp"
+#include "edyn/serialization/mapped_file.hpp"
+#include <entt/signal/delegate.hpp>
+#include <string_view>
+#include <algorithm>
+#include <limits>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <numeric>
+#include <cmath>
 
 namespace edyn {
 
-static vector3 read_vector3(std::istringstream &iss) {
-    edyn::vector3 v;
-    iss >> v.x >> v.y >> v.z;
-    return v;
+namespace {
+
+// Files larger than twice this size are split into chunks that are parsed
+// in parallel.
+constexpr size_t obj_min_chunk_size = 1 << 18;
+constexpr size_t obj_max_num_chunks = 64;
+
+struct obj_transform {
+    vector3 pos;
+    quaternion orn;
+    vector3 scale;
+};
+
+// Part of an object contained in a chunk of an obj file.
+struct obj_object {
+    std::string name;
+    // Whether this part starts with an `o` command.
+    bool is_named {false};
+    std::vector<vector3> vertices;
+    std::vector<vector3> colors;
+    // Zero-based indices into the vertices of the entire file.
+    std::vector<uint32_t> indices;
+    // Pairs of first index in `indices` and number of indices in each face.
+    std::vector<uint32_t> faces;
+};
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char * skip_spaces(const char *first, const char *last) {
+    while (first != last && is_space(*first)) {
+        ++first;
+    }
+
+    return first;
+}
+
+const char * skip_token(const char *first, const char *last) {
+    while (first != last && !is_space(*first)) {
+        ++first;
+    }
+
+    return first;
 }
 
-static void read_face_indices(std::istringstream &iss,
-                              std::vector<uint32_t> &indices,
-                              uint32_t offset, bool triangulate) {
-    std::string idx_str;
-    auto count = size_t{};
-    uint32_t first_idx;
-    uint32_t prev_idx;
-
-    while (true) {
-        iss >> idx_str;
-        if (iss.fail()) break;
-
-        // Remove everything after the first slash to keep only the first
-        // element in the "v/vt/vn" sequence.
-        auto pos = idx_str.find_first_of('/');
-        if (pos != std::string::npos) {
-            idx_str.erase(pos);
+// Returns the end of the parsed number or null if there's no number.
+const char * parse_scalar(const char *first, const char *last, scalar &value) {
+    if (first != last && *first == '+') {
+        ++first;
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    return ec == std::errc{} ? ptr : nullptr;
+#else
+    // Floating point `from_chars` is not available in this standard library.
+    // Accumulate the decimal digits in an integer and scale it by the
+    // exponent in double precision.
+    auto it = first;
+    auto negative = it != last && *it == '-';
+
+    if (negative) {
+        ++it;
+    }
+
+    const auto max_mantissa = (std::numeric_limits<uint64_t>::max() - 9) / 10;
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    auto has_digits = false;
+
+    for (; it != last && *it >= '0' && *it <= '9'; ++it) {
+        has_digits = true;
+
+        if (mantissa < max_mantissa) {
+            mantissa = mantissa * 10 + uint64_t(*it - '0');
+        } else {
+            ++exponent;
         }
+    }
 
-        auto idx = static_cast<uint32_t>(std::stoi(idx_str));
-        EDYN_ASSERT(idx >= 1 + offset);
+    if (it != last && *it == '.') {
+        for (++it; it != last && *it >= '0' && *it <= '9'; ++it) {
+            has_digits = true;
 
-        if (triangulate && count >= 3) {
-            indices.push_back(first_idx);
-            indices.push_back(prev_idx);
+            if (mantissa < max_mantissa) {
+                mantissa = mantissa * 10 + uint64_t(*it - '0');
+                --exponent;
+            }
         }
+    }
 
-        indices.push_back(idx - 1 - offset);
+    if (!has_digits) {
+        return nullptr;
+    }
 
-        if (count == 0) {
-            first_idx = indices.back();
+    if (it != last && (*it == 'e' || *it == 'E')) {
+        auto exp_first = it + 1;
+
+        if (exp_first != last && *exp_first == '+') {
+            ++exp_first;
         }
 
-        prev_idx = indices.back();
-        ++count;
+        int exp_value;
+        auto [ptr, ec] = std::from_chars(exp_first, last, exp_value);
+
+        if (ec == std::errc{}) {
+            exponent += exp_value;
+            it = ptr;
+        }
     }
+
+    auto result = double(mantissa) * std::pow(10.0, exponent);
+    value = static_cast<scalar>(negative ? -result : result);
+    return it;
+#endif
 }
 
-static void read_face(std::istringstream &iss,
-                      std::vector<uint32_t> &indices,
-                      std::vector<uint32_t> &faces,
-                      uint32_t offset, bool triangulate) {
-    // Store where this face starts in the `indices` array.
-    faces.push_back(indices.size());
+// Parses a face vertex in the form `v`, `v/vt`, `v//vn` or `v/vt/vn` and
+// keeps only the one-based vertex index, which is converted to zero-based.
+const char * parse_face_index(const char *first, const char *last, uint32_t &index) {
+    auto [ptr, ec] = std::from_chars(first, last, index);
 
-    read_face_indices(iss, indices, offset, triangulate);
+    // Relative (i.e. negative) indices are not supported.
+    if (ec != std::errc{} || index == 0) {
+        return nullptr;
+    }
 
-    // Store the number of vertices in this face.
-    auto count = indices.size() - faces.back();
-    faces.push_back(count);
+    --index;
+    return skip_token(ptr, last);
 }
 
-template<typename Stream>
-void load_meshes_from_obj_stream(Stream &stream,
-                                 std::vector<obj_mesh> &meshes,
-                                 vector3 pos,
-                                 quaternion orn,
-                                 vector3 scale) {
-    std::string line;
-    auto mesh = obj_mesh{};
-    uint32_t index_offset = 0;
+vector3 parse_vertex(const char *&it, const char *line_end, const obj_transform &transform) {
+    auto v = vector3_zero;
 
-    while (std::getline(stream, line)) {
-        auto pos_space = line.find(" ");
+    for (size_t i = 0; i < 3; ++i) {
+        auto *next = parse_scalar(skip_spaces(it, line_end), line_end, v[i]);
 
-        if (pos_space == std::string::npos) {
-            continue;
+        if (next == nullptr) {
+            break;
         }
 
-        auto cmd = line.substr(0, pos_space);
+        it = next;
+    }
 
-        if (cmd == "o") {
-            if (!mesh.vertices.empty()) {
-                index_offset += mesh.vertices.size();
-                meshes.emplace_back(std::move(mesh));
-            }
-            auto iss = std::istringstream(line.substr(pos_space, line.size() - pos_space));
-            mesh.name = iss.str();
-        } else if (cmd == "v") {
-            auto iss = std::istringstream(line.substr(pos_space, line.size() - pos_space));
-            auto v = read_vector3(iss);
-
-            if (scale != vector3_one) {
-                v *= scale;
-            }
+    if (transform.scale != vector3_one) {
+        v *= transform.scale;
+    }
 
-            if (orn != quaternion_identity) {
-                v = rotate(orn, v);
-            }
+    if (transform.orn != quaternion_identity) {
+        v = rotate(transform.orn, v);
+    }
 
-            if (pos != vector3_zero ) {
-                v += pos;
-            }
+    if (transform.pos != vector3_zero) {
+        v += transform.pos;
+    }
 
-            mesh.vertices.push_back(v);
+    return v;
+}
 
-            if (!iss.eof()) {
-                // Try reading vertex color.
-                auto color = read_vector3(iss);
+bool parse_color(const char *it, const char *line_end, vector3 &color) {
+    for (size_t i = 0; i < 3; ++i) {
+        it = parse_scalar(skip_spaces(it, line_end), line_end, color[i]);
 
-                if (!iss.fail()) {
-                    mesh.colors.push_back(color);
-                }
-            }
-        } else if (cmd == "f") {
-            auto iss = std::istringstream(line.substr(pos_space, line.size() - pos_space));
-            read_face(iss, mesh.indices, mesh.faces, index_offset, false);
+        if (it == nullptr) {
+            return false;
         }
     }
 
-    if (!mesh.vertices.empty()) {
-        meshes.emplace_back(std::move(mesh));
-    }
+    return true;
 }
 
-bool load_meshes_from_obj(const std::string &path,
-                          std::vector<obj_mesh> &meshes,
-                          vector3 pos,
-                          quaternion orn,
-                          vector3 scale) {
-    auto file = std::ifstream(path);
+void parse_face(const char *it, const char *line_end, bool triangulate, obj_object &object) {
+    auto &indices = object.indices;
+    auto face_start = indices.size();
+    auto count = size_t{0};
+    uint32_t first_idx = 0;
+    uint32_t prev_idx = 0;
 
-    if (!file.is_open()) {
-        return false;
+    while ((it = skip_spaces(it, line_end)) != line_end) {
+        uint32_t idx;
+        it = parse_face_index(it, line_end, idx);
+
+        if (it == nullptr) {
+            break;
+        }
+
+        if (triangulate && count >= 3) {
+            indices.push_back(first_idx);
+            indices.push_back(prev_idx);
+        }
+
+        indices.push_back(idx);
+
+        if (count == 0) {
+            first_idx = idx;
+        }
+
+        prev_idx = idx;
+        ++count;
     }
 
-    load_meshes_from_obj_stream(file, meshes, pos, orn, scale);
+    if (!triangulate) {
+        object.faces.push_back(face_start);
+        object.faces.push_back(indices.size() - face_start);
+    }
+}
 
-    return true;
+// Parses a single line, without the line break, into the last object.
+void parse_obj_line(const char *first, const char *line_end, const obj_transform &transform,
+                    bool triangulate, bool split_objects, bool read_colors,
+                    std::vector<obj_object> &objects) {
+    auto *it = skip_spaces(first, line_end);
+    auto *cmd_end = skip_token(it, line_end);
+    auto cmd = std::string_view(it, cmd_end - it);
+    it = cmd_end;
+
+    if (cmd == "v") {
+        auto &object = objects.back();
+        object.vertices.push_back(parse_vertex(it, line_end, transform));
+
+        if (read_colors) {
+            auto color = vector3{};
+
+            if (parse_color(it, line_end, color)) {
+                object.colors.push_back(color);
+            }
+        }
+    } else if (cmd == "f") {
+        parse_face(it, line_end, triangulate, objects.back());
+    } else if (cmd == "o" && split_objects) {
+        auto *name_first = skip_spaces(it, line_end);
+        auto *name_last = line_end;
+
+        while (name_last != name_first && is_space(*(name_last - 1))) {
+            --name_last;
+        }
+
+        if (!objects.back().vertices.empty() || !objects.back().indices.empty() ||
+            objects.back().is_named) {
+            objects.emplace_back();
+        }
+
+        objects.back().name.assign(name_first, name_last);
+        objects.back().is_named = true;
+    }
 }
 
-void load_meshes_from_obj(std::stringstream &ss,
-                          std::vector<obj_mesh> &meshes,
-                          vector3 pos,
-                          quaternion orn,
-                          vector3 scale) {
-    load_meshes_from_obj_stream(ss, meshes, pos, orn, scale);
+// Parses a range of whole lines. The first object continues the last object
+// of the previous chunk unless it starts with an `o` command.
+void parse_obj_chunk(const char *first, const char *last, const obj_transform &transform,
+                     bool triangulate, bool split_objects, bool read_colors,
+                     std::vector<obj_object> &objects) {
+    objects.emplace_back();
+
+    while (first != last) {
+        auto *line_end = static_cast<const char *>(std::memchr(first, '\n', last - first));
+
+        if (line_end == nullptr) {
+            line_end = last;
+        }
+
+        parse_obj_line(first, line_end, transform, triangulate, split_objects, read_colors, objects);
+        first = line_end == last ? last : line_end + 1;
+    }
 }
 
-template<typename Stream>
-void load_tri_mesh_from_obj_stream(Stream &stream,
-                                   std::vector<vector3> &vertices,
-                                   std::vector<uint32_t> &indices,
-                                   std::vector<vector3> *colors,
-                                   vector3 pos,
-                                   quaternion orn,
-                                   vector3 scale) {
-    std::string line;
+// Splits the text into chunks of whole lines and parses them, in parallel if
+// possible. Returns the objects found in each chunk, in order.
+std::vector<std::vector<obj_object>> parse_obj(std::string_view text, const obj_transform &transform,
+                                               bool triangulate, bool split_objects, bool read_colors,
+                                               enqueue_task_wait_t *enqueue_task_wait) {
+    size_t num_chunks = 1;
 
-    while (std::getline(stream, line)) {
-        auto pos_space = line.find(" ");
+    if (enqueue_task_wait != nullptr) {
+        num_chunks = std::clamp(text.size() / obj_min_chunk_size, size_t{1}, obj_max_num_chunks);
+    }
+
+    auto boundaries = std::vector<size_t>(num_chunks + 1);
+    boundaries.back() = text.size();
+
+    for (size_t i = 1; i < num_chunks; ++i) {
+        auto pos = std::max(boundaries[i - 1], text.size() * i / num_chunks);
+        auto line_end = text.find('\n', pos);
+        boundaries[i] = line_end == std::string_view::npos ? text.size() : line_end + 1;
+    }
+
+    auto chunks = std::vector<std::vector<obj_object>>(num_chunks);
 
-        if (pos_space == std::string::npos) {
-            continue;
+    auto task_func = [&](unsigned start, unsigned end) {
+        for (auto i = start; i < end; ++i) {
+            parse_obj_chunk(text.data() + boundaries[i], text.data() + boundaries[i + 1],
+                            transform, triangulate, split_objects, read_colors, chunks[i]);
         }
+    };
 
-        auto cmd = line.substr(0, pos_space);
+    if (num_chunks > 1) {
+        auto task = task_delegate_t(entt::connect_arg_t<&decltype(task_func)::operator()>{}, task_func);
+        (*enqueue_task_wait)(task, num_chunks);
+    } else {
+        task_func(0, 1);
+    }
 
-        if (cmd == "v") {
-            auto iss = std::istringstream(line.substr(pos_space, line.size() - pos_space));
-            auto v = read_vector3(iss);
+    return chunks;
+}
 
-            if (scale != vector3_one) {
-                v *= scale;
-            }
+// Parses a stream one line at a time, reusing the line buffer, thus the
+// contents of the stream are never copied as a whole. Returns a single chunk.
+std::vector<std::vector<obj_object>> parse_obj(std::istream &stream, const obj_transform &transform,
+                                               bool triangulate, bool split_objects, bool read_colors) {
+    auto chunks = std::vector<std::vector<obj_object>>(1);
+    auto &objects = chunks.front();
+    objects.emplace_back();
+    auto line = std::string{};
 
-            if (orn != quaternion_identity) {
-                v = rotate(orn, v);
-            }
+    while (std::getline(stream, line)) {
+        parse_obj_line(line.data(), line.data() + line.size(), transform,
+                       triangulate, split_objects, read_colors, objects);
+    }
+
+    return chunks;
+}
 
-            if (pos != vector3_zero ) {
-                v += pos;
+void merge_obj_meshes(std::vector<std::vector<obj_object>> &chunks, std::vector<obj_mesh> &meshes) {
+    auto mesh = obj_mesh{};
+    uint32_t index_offset = 0;
+
+    for (auto &objects : chunks) {
+        for (auto &object : objects) {
+            if (object.is_named) {
+                if (!mesh.vertices.empty()) {
+                    index_offset += mesh.vertices.size();
+                    meshes.emplace_back(std::move(mesh));
+                    mesh = obj_mesh{};
+                }
+
+                mesh.name = std::move(object.name);
             }
 
-            vertices.push_back(v);
+            mesh.vertices.insert(mesh.vertices.end(), object.vertices.begin(), object.vertices.end());
+            mesh.colors.insert(mesh.colors.end(), object.colors.begin(), object.colors.end());
 
-            if (colors != nullptr && !iss.eof()) {
-                // Try reading vertex color.
-                auto color = read_vector3(iss);
+            // Make indices relative to the first vertex of the mesh.
+            auto face_offset = static_cast<uint32_t>(mesh.indices.size());
 
-                if (!iss.fail()) {
-                    colors->push_back(color);
-                }
+            for (auto idx : object.indices) {
+                EDYN_ASSERT(idx >= index_offset);
+                mesh.indices.push_back(idx - index_offset);
+            }
+
+            for (size_t i = 0; i < object.faces.size(); i += 2) {
+                mesh.faces.push_back(object.faces[i] + face_offset);
+                mesh.faces.push_back(object.faces[i + 1]);
             }
-        } else if (cmd == "f") {
-            auto iss = std::istringstream(line.substr(pos_space, line.size() - pos_space));
-            read_face_indices(iss, indices, 0, true);
         }
     }
+
+    if (!mesh.vertices.empty()) {
+        meshes.emplace_back(std::move(mesh));
+    }
 }
 
-bool load_tri_mesh_from_obj(const std::string &path,
-                            std::vector<vector3> &vertices,
-                            std::vector<uint32_t> &indices,
-                            std::vector<vector3> *colors,
-                            vector3 pos,
-                            quaternion orn,
-                            vector3 scale) {
-    auto file = std::ifstream(path);
+void merge_obj_tri_mesh(std::vector<std::vector<obj_object>> &chunks, std::vector<vector3> &vertices,
+                        std::vector<uint32_t> &indices, std::vector<vector3> *colors) {
+    size_t num_vertices = 0, num_indices = 0;
 
-    if (!file.is_open()) {
-        return false;
+    for (auto &objects : chunks) {
+        for (auto &object : objects) {
+            num_vertices += object.vertices.size();
+            num_indices += object.indices.size();
+        }
     }
 
-    load_tri_mesh_from_obj_stream(file, vertices, indices, colors, pos, orn, scale);
-    return true;
-}
+    vertices.reserve(vertices.size() + num_vertices);
+    indices.reserve(indices.size() + num_indices);
 
-void load_tri_mesh_from_obj(std::stringstream &stream,
-                            std::vector<vector3> &vertices,
-                            std::vector<uint32_t> &indices,
-                            std::vector<vector3> *colors,
-                            vector3 pos,
-                            quaternion orn,
-                            vector3 scale) {
-    load_tri_mesh_from_obj_stream(stream, vertices, indices, colors, pos, orn, scale);
-}
+    for (auto &objects : chunks) {
+        for (auto &object : objects) {
+            vertices.insert(vertices.end(), object.vertices.begin(), object.vertices.end());
+            indices.insert(indices.end(), object.indices.begin(), object.indices.end());
 
-template<typename Stream>
-std::vector<polyhedron_with_center> load_convex_polyhedrons_from_obj_stream(
-    Stream &stream,
-    const vector3 &pos,
-    const quaternion &orn,
-    const vector3 &scale) {
-
-    auto meshes = std::vector<obj_mesh>{};
+            if (colors != nullptr) {
+                colors->insert(colors->end(), object.colors.begin(), object.colors.end());
+            }
+        }
+    }
+}
 
-    load_meshes_from_obj_stream(stream, meshes, pos, orn, scale);
+std::string_view mapped_text(const mapped_file &file) {
+    return {reinterpret_cast<const char *>(file.data()), file.size()};
+}
 
+std::vector<polyhedron_with_center> make_polyhedrons(std::vector<obj_mesh> &meshes) {
     EDYN_ASSERT(!meshes.empty());
     auto polyhedrons = std::vector<polyhedron_with_center>{};
     polyhedrons.reserve(meshes.size());
@@ -275,19 +442,179 @@ std::vector<polyhedron_with_center> load_convex_polyhedrons_from_obj_stream(
     return polyhedrons;
 }
 
+compound_shape make_compound(const std::vector<polyhedron_with_center> &polyhedrons) {
+    EDYN_ASSERT(!polyhedrons.empty());
+
+    auto compound = compound_shape{};
+
+    // Create a polyhedron shape for each mesh.
+    for (auto &poly : polyhedrons) {
+        compound.add_shape(poly.shape, poly.center, quaternion_identity);
+    }
+
+    compound.finish();
+    return compound;
+}
+
+constexpr char binary_mesh_magic[4] = {'E', 'D', 'M', 'B'};
+constexpr uint32_t binary_mesh_version = 1;
+
+struct binary_mesh_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t scalar_size;
+    uint32_t reserved;
+    uint64_t num_vertices;
+    uint64_t num_indices;
+    uint64_t num_faces;
+};
+
+// The arrays follow the header without padding, thus it must keep them aligned.
+static_assert(sizeof(binary_mesh_header) % alignof(vector3) == 0);
+static_assert(sizeof(vector3) == 3 * sizeof(scalar));
+
+struct binary_mesh_view {
+    const vector3 *vertices;
+    const uint32_t *indices;
+    const uint32_t *faces;
+    size_t num_vertices;
+    size_t num_indices;
+    size_t num_faces;
+};
+
+bool read_binary_mesh(const mapped_file &file, binary_mesh_view &view) {
+    auto header = binary_mesh_header{};
+
+    if (!file.is_open() || file.size() < sizeof(header)) {
+        return false;
+    }
+
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, binary_mesh_magic, sizeof(header.magic)) != 0 ||
+        header.version != binary_mesh_version || header.scalar_size != sizeof(scalar)) {
+        return false;
+    }
+
+    // Check each count against the remaining bytes before multiplying, so
+    // corrupted counts cannot overflow the size calculation.
+    auto remaining = file.size() - sizeof(header);
+
+    if (header.num_vertices > remaining / sizeof(vector3)) {
+        return false;
+    }
+
+    remaining -= header.num_vertices * sizeof(vector3);
+
+    if (header.num_indices > remaining / sizeof(uint32_t)) {
+        return false;
+    }
+
+    remaining -= header.num_indices * sizeof(uint32_t);
+
+    if (header.num_faces > remaining / (2 * sizeof(uint32_t)) ||
+        remaining != header.num_faces * 2 * sizeof(uint32_t)) {
+        return false;
+    }
+
+    // The mapping is page aligned and the header size preserves alignment.
+    auto *data = file.data() + sizeof(header);
+    view.vertices = reinterpret_cast<const vector3 *>(data);
+    data += header.num_vertices * sizeof(vector3);
+    view.indices = reinterpret_cast<const uint32_t *>(data);
+    data += header.num_indices * sizeof(uint32_t);
+    view.faces = reinterpret_cast<const uint32_t *>(data);
+    view.num_vertices = header.num_vertices;
+    view.num_indices = header.num_indices;
+    view.num_faces = header.num_faces;
+
+    for (size_t i = 0; i < view.num_indices; ++i) {
+        if (view.indices[i] >= view.num_vertices) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < view.num_faces; ++i) {
+        if (size_t(view.faces[i * 2]) + view.faces[i * 2 + 1] > view.num_indices) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+bool load_meshes_from_obj(const std::string &path,
+                          std::vector<obj_mesh> &meshes,
+                          vector3 pos,
+                          quaternion orn,
+                          vector3 scale,
+                          enqueue_task_wait_t *enqueue_task_wait) {
+    auto file = mapped_file(path);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto chunks = parse_obj(mapped_text(file), {pos, orn, scale}, false, true, true, enqueue_task_wait);
+    merge_obj_meshes(chunks, meshes);
+
+    return true;
+}
+
+void load_meshes_from_obj(std::stringstream &ss,
+                          std::vector<obj_mesh> &meshes,
+                          vector3 pos,
+                          quaternion orn,
+                          vector3 scale) {
+    auto chunks = parse_obj(ss, {pos, orn, scale}, false, true, true);
+    merge_obj_meshes(chunks, meshes);
+}
+
+bool load_tri_mesh_from_obj(const std::string &path,
+                            std::vector<vector3> &vertices,
+                            std::vector<uint32_t> &indices,
+                            std::vector<vector3> *colors,
+                            vector3 pos,
+                            quaternion orn,
+                            vector3 scale,
+                            enqueue_task_wait_t *enqueue_task_wait) {
+    auto file = mapped_file(path);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto chunks = parse_obj(mapped_text(file), {pos, orn, scale}, true, false, colors != nullptr, enqueue_task_wait);
+    merge_obj_tri_mesh(chunks, vertices, indices, colors);
+    return true;
+}
+
+void load_tri_mesh_from_obj(std::stringstream &stream,
+                            std::vector<vector3> &vertices,
+                            std::vector<uint32_t> &indices,
+                            std::vector<vector3> *colors,
+                            vector3 pos,
+                            quaternion orn,
+                            vector3 scale) {
+    auto chunks = parse_obj(stream, {pos, orn, scale}, true, false, colors != nullptr);
+    merge_obj_tri_mesh(chunks, vertices, indices, colors);
+}
+
 std::vector<polyhedron_with_center> load_convex_polyhedrons_from_obj(
     const std::string &path_to_obj,
     const vector3 &pos,
     const quaternion &orn,
     const vector3 &scale) {
 
-    auto file = std::ifstream(path_to_obj);
+    auto meshes = std::vector<obj_mesh>{};
 
-    if (!file.is_open()) {
+    if (!load_meshes_from_obj(path_to_obj, meshes, pos, orn, scale)) {
         return {};
     }
 
-    return load_convex_polyhedrons_from_obj_stream(file, pos, orn, scale);
+    return make_polyhedrons(meshes);
 }
 
 std::vector<polyhedron_with_center> load_convex_polyhedrons_from_obj(
@@ -295,51 +622,101 @@ std::vector<polyhedron_with_center> load_convex_polyhedrons_from_obj(
     const vector3 &pos,
     const quaternion &orn,
     const vector3 &scale) {
-    return load_convex_polyhedrons_from_obj_stream(ss, pos, orn, scale);
+
+    auto meshes = std::vector<obj_mesh>{};
+    load_meshes_from_obj(ss, meshes, pos, orn, scale);
+    return make_polyhedrons(meshes);
 }
 
-template<typename Stream>
-compound_shape load_compound_shape_from_obj_stream(
-    Stream &stream,
+compound_shape load_compound_shape_from_obj(
+    const std::string &path_to_obj,
     const vector3 &pos,
     const quaternion &orn,
     const vector3 &scale) {
 
-    auto polyhedrons = load_convex_polyhedrons_from_obj_stream(stream, pos, orn, scale);
-    EDYN_ASSERT(!polyhedrons.empty());
-
-    auto compound = compound_shape{};
+    auto polyhedrons = load_convex_polyhedrons_from_obj(path_to_obj, pos, orn, scale);
 
-    // Create a polyhedron shape for each mesh.
-    for (auto &poly : polyhedrons) {
-        compound.add_shape(poly.shape, poly.center, quaternion_identity);
+    if (polyhedrons.empty()) {
+        return {};
     }
 
-    compound.finish();
-    return compound;
+    return make_compound(polyhedrons);
 }
 
 compound_shape load_compound_shape_from_obj(
-    const std::string &path_to_obj,
+    std::stringstream &ss,
     const vector3 &pos,
     const quaternion &orn,
     const vector3 &scale) {
+    return make_compound(load_convex_polyhedrons_from_obj(ss, pos, orn, scale));
+}
+
+bool write_mesh_to_binary(const std::string &path,
+                          const std::vector<vector3> &vertices,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &faces) {
+    EDYN_ASSERT(faces.size() % 2 == 0);
 
-    auto file = std::ifstream(path_to_obj);
+    auto file = std::ofstream(path, std::ios::binary | std::ios::out);
 
     if (!file.is_open()) {
-        return {};
+        return false;
     }
 
-    return load_compound_shape_from_obj_stream(file, pos, orn, scale);
+    auto header = binary_mesh_header{};
+    std::memcpy(header.magic, binary_mesh_magic, sizeof(header.magic));
+    header.version = binary_mesh_version;
+    header.scalar_size = sizeof(scalar);
+    header.reserved = 0;
+    header.num_vertices = vertices.size();
+    header.num_indices = indices.size();
+    header.num_faces = faces.size() / 2;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(vertices.data()), vertices.size() * sizeof(vector3));
+    file.write(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(faces.data()), faces.size() * sizeof(uint32_t));
+
+    return file.good();
 }
 
-compound_shape load_compound_shape_from_obj(
-    std::stringstream &ss,
-    const vector3 &pos,
-    const quaternion &orn,
-    const vector3 &scale) {
-    return load_compound_shape_from_obj_stream(ss, pos, orn, scale);
+bool load_triangle_mesh_from_binary(const std::string &path, triangle_mesh &mesh) {
+    EDYN_ASSERT(mesh.num_vertices() == 0 && mesh.num_triangles() == 0);
+
+    auto file = mapped_file(path);
+    auto view = binary_mesh_view{};
+
+    if (!read_binary_mesh(file, view) || view.num_indices % 3 != 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < view.num_faces; ++i) {
+        if (view.faces[i * 2 + 1] != 3) {
+            return false;
+        }
+    }
+
+    mesh.insert_vertices(view.vertices, view.vertices + view.num_vertices);
+    mesh.insert_indices(view.indices, view.indices + view.num_indices);
+    mesh.initialize();
+
+    return true;
+}
+
+bool load_convex_mesh_from_binary(const std::string &path, convex_mesh &mesh) {
+    auto file = mapped_file(path);
+    auto view = binary_mesh_view{};
+
+    if (!read_binary_mesh(file, view) || view.num_faces == 0) {
+        return false;
+    }
+
+    mesh.vertices.assign(view.vertices, view.vertices + view.num_vertices);
+    mesh.indices.assign(view.indices, view.indices + view.num_indices);
+    mesh.faces.assign(view.faces, view.faces + view.num_faces * 2);
+    mesh.initialize();
+
+    return true;
 }
 
 }
@@ -49,18 +49,36 @@ scalar polyhedron_support_projection(const std::vector<vector3> &vertices,
                                      const std::vector<uint32_t> &neighbors_start,
                                      const std::vector<uint32_t> &neighbor_indices,
                                      const vector3 &dir) {
-    // Starting at the first vertex, visit all neighbors and pick the neighboring
-    // vertex with higher projection. Stop when there are no more neighbors with
-    // a higher projection value than the current.
-    auto v_idx = 0u;
-    auto max_proj = dot(vertices[0], dir);
+    uint32_t vertex_idx = 0;
+    return polyhedron_support_projection(vertices, neighbors_start, neighbor_indices, dir, vertex_idx);
+}
 
+scalar polyhedron_support_projection(const std::vector<vector3> &vertices,
+                                     const std::vector<uint32_t> &neighbors_start,
+                                     const std::vector<uint32_t> &neighbor_indices,
+                                     const vector3 &dir, uint32_t &vertex_idx) {
+    vertex_idx = polyhedron_support_vertex(vertices, neighbors_start, neighbor_indices, dir, vertex_idx);
+    return dot(vertices[vertex_idx], dir);
+}
+
+uint32_t polyhedron_support_vertex(const std::vector<vector3> &vertices,
+                                   const std::vector<uint32_t> &neighbors_start,
+                                   const std::vector<uint32_t> &neighbor_indices,
+                                   const vector3 &dir, uint32_t start_idx) {
+    // Starting at the given vertex, visit all neighbors and pick the neighboring
+    // vertex with higher projection. Stop when there are no more neighbors with
+    // a higher projection value than the current. Since the polyhedron is
+    // convex, a local maximum is also the global maximum.
     EDYN_ASSERT(neighbors_start.size() == vertices.size() + 1);
+    EDYN_ASSERT(start_idx < vertices.size());
+
+    auto v_idx = start_idx;
+    auto max_proj = dot(vertices[v_idx], dir);
 
     while (true) {
         auto n_idx0 = neighbors_start[v_idx];
         auto n_idx1 = neighbors_start[v_idx + 1];
-        bool done = true;
+        auto next_idx = v_idx;
 
         for (auto i = n_idx0; i < n_idx1; ++i) {
             auto nv_idx = neighbor_indices[i];
@@ -68,17 +86,18 @@ scalar polyhedron_support_projection(const std::vector<vector3> &vertices,
 
             if (proj > max_proj) {
                 max_proj = proj;
-                v_idx = nv_idx;
-                done = false;
+                next_idx = nv_idx;
             }
         }
 
-        if (done) {
+        if (next_idx == v_idx) {
             break;
         }
+
+        v_idx = next_idx;
     }
 
-    return max_proj;
+    return v_idx;
 }
 
 vector3 point_cloud_support_point(const std::vector<vector3> &points, const vector3 &dir) {
@@ -406,4 +425,18 @@ size_t get_triangle_mesh_feature_index(const triangle_mesh &mesh, size_t tri_idx
     return SIZE_MAX;
 }
 
+size_t get_triangle_mesh_feature_index(const packed_triangle &tri, size_t tri_idx,
+                                       triangle_feature tri_feature, size_t tri_feature_idx) {
+    switch (tri_feature) {
+    case triangle_feature::face:
+        return tri_idx;
+    case triangle_feature::edge:
+        return tri.edge_indices[tri_feature_idx];
+    case triangle_feature::vertex:
+        return tri.vertex_indices[tri_feature_idx];
+    }
+
+    return SIZE_MAX;
+}
+
 }
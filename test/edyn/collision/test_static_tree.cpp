@@ -0,0 +1,155 @@
+#include "../common/common.hpp"
+#include "edyn/serialization/memory_archive.hpp"
+#include "edyn/serialization/static_tree_s11n.hpp"
+#include <set>
+
+static std::vector<edyn::AABB> make_grid_aabbs(int size) {
+    std::vector<edyn::AABB> aabbs;
+
+    for (int x = 0; x < size; ++x) {
+        for (int z = 0; z < size; ++z) {
+            auto center = edyn::vector3{edyn::scalar(x) * 2, 0, edyn::scalar(z) * 2};
+            aabbs.push_back({center - edyn::vector3_one * 0.5, center + edyn::vector3_one * 0.5});
+        }
+    }
+
+    return aabbs;
+}
+
+static void check_tree(const edyn::static_tree &tree, const std::vector<edyn::AABB> &aabbs) {
+    // Every object must be found by querying its own AABB.
+    for (uint32_t i = 0; i < aabbs.size(); ++i) {
+        auto found = false;
+
+        tree.query(aabbs[i], [&](uint32_t id) {
+            found |= id == i;
+        });
+
+        ASSERT_TRUE(found);
+    }
+}
+
+TEST(static_tree_test, build) {
+    auto aabbs = make_grid_aabbs(40);
+    auto tree = edyn::static_tree{};
+    auto report_leaf = [](edyn::static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+        ASSERT_EQ(std::distance(ids_begin, ids_end), 1);
+        node.id = *ids_begin;
+    };
+    tree.build(aabbs.begin(), aabbs.end(), report_leaf);
+    check_tree(tree, aabbs);
+}
+
+TEST(static_tree_test, build_parallel_with_leaf_size) {
+    edyn::job_dispatcher::global().start(4);
+
+    auto aabbs = make_grid_aabbs(100);
+    auto tree = edyn::static_tree{};
+    auto max_obj_per_leaf = 8u;
+    auto ids = std::multiset<uint32_t>{};
+    auto report_leaf = [&](edyn::static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+        ASSERT_LE(std::distance(ids_begin, ids_end), max_obj_per_leaf);
+        ids.insert(ids_begin, ids_end);
+        node.id = *ids_begin;
+
+        for (auto it = ids_begin; it != ids_end; ++it) {
+            ASSERT_TRUE(node.aabb.contains(aabbs[*it]));
+        }
+    };
+    tree.build(aabbs.begin(), aabbs.end(), report_leaf, max_obj_per_leaf, &edyn::enqueue_task_wait_default);
+
+    // Each object must be in exactly one leaf.
+    ASSERT_EQ(ids.size(), aabbs.size());
+    ASSERT_EQ(std::set<uint32_t>(ids.begin(), ids.end()).size(), aabbs.size());
+
+    edyn::job_dispatcher::global().stop();
+}
+
+TEST(static_tree_test, build_parallel_matches_serial_with_large_leaves) {
+    edyn::job_dispatcher::global().start(4);
+
+    auto aabbs = make_grid_aabbs(100);
+    auto max_obj_per_leaf = 2048u;
+
+    auto build_leaves = [&](edyn::enqueue_task_wait_t *enqueue_task_wait) {
+        auto leaf_sizes = std::multiset<size_t>{};
+        auto report_leaf = [&](edyn::static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+            leaf_sizes.insert(std::distance(ids_begin, ids_end));
+            node.id = *ids_begin;
+        };
+        auto tree = edyn::static_tree{};
+        tree.build(aabbs.begin(), aabbs.end(), report_leaf, max_obj_per_leaf, enqueue_task_wait);
+        return leaf_sizes;
+    };
+
+    auto serial_leaves = build_leaves(nullptr);
+    auto parallel_leaves = build_leaves(&edyn::enqueue_task_wait_default);
+    ASSERT_EQ(serial_leaves, parallel_leaves);
+    ASSERT_LE(*serial_leaves.rbegin(), max_obj_per_leaf);
+
+    edyn::job_dispatcher::global().stop();
+}
+
+TEST(static_tree_test, raycast) {
+    auto aabbs = make_grid_aabbs(40);
+    auto tree = edyn::static_tree{};
+    auto report_leaf = [](edyn::static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+        node.id = *ids_begin;
+    };
+    tree.build(aabbs.begin(), aabbs.end(), report_leaf);
+
+    // Segment going through the first row of boxes along the x axis.
+    auto p0 = edyn::vector3{-1, 0, 0};
+    auto p1 = edyn::vector3{100, 0, 0};
+    auto ids = std::set<uint32_t>{};
+
+    tree.raycast(p0, p1, [&](uint32_t id) {
+        ids.insert(id);
+    });
+
+    // The segment must hit every box with z equals zero. Others might be
+    // visited since node bounds are conservative.
+    for (uint32_t x = 0; x < 40; ++x) {
+        ASSERT_TRUE(ids.count(x * 40));
+    }
+}
+
+TEST(static_tree_test, serialization) {
+    auto aabbs = make_grid_aabbs(20);
+    auto tree = edyn::static_tree{};
+    auto report_leaf = [](edyn::static_tree::tree_node &node, auto ids_begin, auto ids_end) {
+        node.id = *ids_begin;
+    };
+    tree.build(aabbs.begin(), aabbs.end(), report_leaf);
+
+    auto data = std::vector<uint8_t>{};
+
+    {
+        auto output = edyn::memory_output_archive(data);
+        output(tree);
+
+        // Tree in the legacy format, which starts with the number of nodes,
+        // followed by more data.
+        uint16_t num_nodes = 1;
+        auto aabb_min = edyn::vector3_zero;
+        auto aabb_max = edyn::vector3_one;
+        uint32_t child1 = edyn::EDYN_NULL_NODE;
+        uint32_t id = 0;
+        uint32_t sentinel = 1234;
+        output(num_nodes, aabb_min, aabb_max, child1, id, sentinel);
+    }
+
+    auto input = edyn::memory_input_archive(data.data(), data.size());
+    auto input_tree = edyn::static_tree{};
+    input(input_tree);
+    ASSERT_EQ(input_tree.num_nodes(), tree.num_nodes());
+    check_tree(input_tree, aabbs);
+
+    // Legacy trees are skipped and left empty.
+    auto legacy_tree = edyn::static_tree{};
+    uint32_t sentinel = 0;
+    input(legacy_tree, sentinel);
+    ASSERT_TRUE(legacy_tree.empty());
+    ASSERT_EQ(sentinel, 1234);
+    ASSERT_FALSE(input.failed());
+}
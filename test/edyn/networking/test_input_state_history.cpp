@@ -96,3 +96,27 @@ TEST(networking_test, input_state_history) {
     ASSERT_EQ(registry2.get<input>(emap.at(ent0)).value, -98);
     ASSERT_EQ(registry2.get<input>(emap.at(ent2)).value, 77);
 }
+
+TEST(networking_test, input_state_history_out_of_order) {
+    auto history = edyn::internal::component_history<input>{};
+
+    // Insert more entries than the initial capacity to exercise growth.
+    for (int i = 0; i < 40; ++i) {
+        history.push(input{i}, i);
+    }
+
+    // Late arrival must be inserted in order.
+    history.push(input{-1}, 10.5);
+    ASSERT_EQ(history.size(), 41);
+    ASSERT_EQ(history.component(history.upper_bound(10.5) - 1).value, -1);
+
+    for (size_t i = 1; i < history.size(); ++i) {
+        ASSERT_LE(history.timestamp(i - 1), history.timestamp(i));
+    }
+
+    history.erase_until(20);
+    ASSERT_EQ(history.size(), 19);
+    ASSERT_EQ(history.timestamp(0), 21);
+    ASSERT_EQ(history.lower_bound(30), 9);
+    ASSERT_EQ(history.upper_bound(30), 10);
+}
@@ -1,5 +1,8 @@
 #include "../common/common.hpp"
 #include "edyn/util/shape_util.hpp"
+#include "edyn/serialization/s11n.hpp"
+#include "edyn/shapes/create_paged_triangle_mesh.hpp"
+#include <cstdio>
 
 TEST(triangle_mesh_serialization, test) {
     // Create triangle mesh.
@@ -70,3 +73,71 @@ TEST(triangle_mesh_serialization, test) {
         ASSERT_EQ(trimesh.is_convex_edge(i), input_trimesh.is_convex_edge(i));
     }
 }
+
+TEST(triangle_mesh_serialization, paged_embedded) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+    edyn::make_plane_mesh(4, 4, 8, 8, vertices, indices);
+
+    auto loader = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>();
+    auto trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh(trimesh, vertices.begin(), vertices.end(), indices.begin(), indices.end(), 8, {}, {});
+    ASSERT_GT(trimesh.num_submeshes(), 1);
+
+    auto filename = "paged_trimesh.bin";
+
+    {
+        auto output = edyn::paged_triangle_mesh_file_output_archive(filename, edyn::paged_triangle_mesh_serialization_mode::embedded);
+        edyn::serialize(output, trimesh);
+    }
+
+    auto input = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>(filename, nullptr);
+    auto input_trimesh = edyn::paged_triangle_mesh(input);
+    edyn::serialize(*input, input_trimesh);
+    ASSERT_TRUE(input->is_valid());
+    ASSERT_EQ(trimesh.num_submeshes(), input_trimesh.num_submeshes());
+
+    // Load all pages from the file.
+    input_trimesh.visit_submeshes(input_trimesh.get_aabb(), [](size_t) {});
+
+    for (size_t i = 0; i < trimesh.num_submeshes(); ++i) {
+        auto submesh = trimesh.get_submesh(i);
+        auto input_submesh = input_trimesh.get_submesh(i);
+        ASSERT_TRUE(input_submesh);
+        ASSERT_EQ(submesh->num_vertices(), input_submesh->num_vertices());
+        ASSERT_EQ(submesh->num_triangles(), input_submesh->num_triangles());
+        ASSERT_EQ(submesh->num_edges(), input_submesh->num_edges());
+
+        for (size_t j = 0; j < submesh->num_vertices(); ++j) {
+            ASSERT_EQ(submesh->get_vertex_position(j), input_submesh->get_vertex_position(j));
+        }
+
+        for (size_t j = 0; j < submesh->num_triangles(); ++j) {
+            for (size_t k = 0; k < 3; ++k) {
+                ASSERT_EQ(submesh->get_face_vertex_index(j, k), input_submesh->get_face_vertex_index(j, k));
+            }
+        }
+    }
+
+    std::remove(filename);
+}
+
+TEST(triangle_mesh_serialization, paged_rejects_legacy_file) {
+    auto filename = "paged_trimesh_legacy.bin";
+
+    {
+        // Files written before the header was added start with the thickness.
+        auto output = edyn::file_output_archive(filename);
+        auto thickness = edyn::scalar(0.1);
+        size_t num_submeshes = 0;
+        output(thickness, num_submeshes);
+    }
+
+    auto input = std::make_shared<edyn::paged_triangle_mesh_file_input_archive>(filename, nullptr);
+    auto input_trimesh = edyn::paged_triangle_mesh(input);
+    edyn::serialize(*input, input_trimesh);
+    ASSERT_FALSE(input->is_valid());
+    ASSERT_EQ(input_trimesh.num_submeshes(), 0);
+
+    std::remove(filename);
+}
@@ -0,0 +1,92 @@
+#include "../common/common.hpp"
+#include "edyn/util/shape_util.hpp"
+#include "edyn/util/aabb_util.hpp"
+#include <random>
+
+// Creates a prism with a regular polygon as its base.
+static void make_prism_mesh(size_t num_sides, edyn::convex_mesh &mesh) {
+    for (size_t i = 0; i < num_sides; ++i) {
+        auto angle = edyn::scalar(i) / edyn::scalar(num_sides) * edyn::pi2;
+        auto x = std::cos(angle);
+        auto z = std::sin(angle);
+        mesh.vertices.push_back({x, -1, z});
+        mesh.vertices.push_back({x, 1, z});
+    }
+
+    auto add_face = [&](std::vector<uint32_t> face_indices) {
+        mesh.faces.push_back(mesh.indices.size());
+        mesh.faces.push_back(face_indices.size());
+        mesh.indices.insert(mesh.indices.end(), face_indices.begin(), face_indices.end());
+    };
+
+    // Side faces.
+    for (uint32_t i = 0; i < num_sides; ++i) {
+        auto j = (i + 1) % num_sides;
+        add_face({i * 2, i * 2 + 1, j * 2 + 1, j * 2});
+    }
+
+    // Bottom and top faces.
+    std::vector<uint32_t> bottom, top;
+
+    for (uint32_t i = 0; i < num_sides; ++i) {
+        bottom.push_back(i * 2);
+        top.push_back((num_sides - i - 1) * 2 + 1);
+    }
+
+    add_face(bottom);
+    add_face(top);
+}
+
+TEST(test_convex_mesh, neighbors) {
+    auto mesh = edyn::convex_mesh{};
+    make_prism_mesh(24, mesh);
+    mesh.initialize();
+
+    ASSERT_EQ(mesh.neighbors_start.size(), mesh.vertices.size() + 1);
+    ASSERT_EQ(mesh.neighbor_indices.size(), mesh.num_edges() * 2);
+
+    // Each vertex of a prism has three neighbors.
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        ASSERT_EQ(mesh.neighbors_start[i + 1] - mesh.neighbors_start[i], 3);
+    }
+}
+
+TEST(test_convex_mesh, support_hill_climbing) {
+    auto mesh = edyn::convex_mesh{};
+    make_prism_mesh(200, mesh);
+    mesh.initialize();
+
+    auto rng = std::mt19937{};
+    auto dist = std::uniform_real_distribution<edyn::scalar>(-1, 1);
+    uint32_t vertex_idx = 0;
+
+    for (size_t i = 0; i < 500; ++i) {
+        auto dir = edyn::vector3{dist(rng), dist(rng), dist(rng)};
+
+        if (!edyn::try_normalize(dir)) {
+            continue;
+        }
+
+        auto expected = edyn::point_cloud_support_projection(mesh.vertices, dir);
+        auto proj = edyn::polyhedron_support_projection(mesh.vertices, mesh.neighbors_start,
+                                                        mesh.neighbor_indices, dir, vertex_idx);
+        ASSERT_SCALAR_EQ(proj, expected);
+        ASSERT_SCALAR_EQ(edyn::dot(mesh.vertices[vertex_idx], dir), expected);
+    }
+}
+
+TEST(test_convex_mesh, polyhedron_aabb) {
+    auto mesh = std::make_shared<edyn::convex_mesh>();
+    make_prism_mesh(64, *mesh);
+    mesh->initialize();
+
+    auto shape = edyn::polyhedron_shape(mesh);
+
+    auto pos = edyn::vector3{2, -3, 0.5};
+    auto orn = edyn::quaternion_axis_angle(edyn::normalize(edyn::vector3{1, 2, -0.4}), 0.7);
+    auto aabb = edyn::shape_aabb(shape, pos, orn);
+    auto expected = edyn::point_cloud_aabb(mesh->vertices, pos, orn);
+
+    ASSERT_VECTOR3_EQ(aabb.min, expected.min);
+    ASSERT_VECTOR3_EQ(aabb.max, expected.max);
+}
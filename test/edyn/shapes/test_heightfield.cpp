@@ -0,0 +1,299 @@
+#include "../common/common.hpp"
+#include "edyn/shapes/heightfield.hpp"
+#include "edyn/collision/raycast.hpp"
+#include <random>
+#include <map>
+#include <set>
+#include <algorithm>
+
+static edyn::scalar terrain_height(edyn::scalar x, edyn::scalar z) {
+    return edyn::scalar(0.4) * std::sin(x * edyn::scalar(0.7)) * std::cos(z * edyn::scalar(0.5)) +
+           edyn::scalar(0.05) * std::sin(x * edyn::scalar(5.3) + z * edyn::scalar(3.1));
+}
+
+static std::vector<edyn::scalar> make_terrain_heights(size_t num_columns, size_t num_rows, edyn::vector2 cell_size) {
+    auto heights = std::vector<edyn::scalar>{};
+
+    for (size_t j = 0; j < num_rows; ++j) {
+        for (size_t i = 0; i < num_columns; ++i) {
+            heights.push_back(terrain_height(edyn::scalar(i) * cell_size.x, edyn::scalar(j) * cell_size.y));
+        }
+    }
+
+    return heights;
+}
+
+// Builds a triangle mesh with the same triangles as the heightfield.
+static std::shared_ptr<edyn::triangle_mesh> make_equivalent_mesh(const edyn::heightfield &field) {
+    auto vertices = std::vector<edyn::vector3>{};
+    auto indices = std::vector<uint32_t>{};
+    auto nx = static_cast<uint32_t>(field.num_columns());
+    auto nz = static_cast<uint32_t>(field.num_rows());
+    auto origin = field.get_origin();
+    auto cell_size = field.get_cell_size();
+
+    for (uint32_t j = 0; j < nz; ++j) {
+        for (uint32_t i = 0; i < nx; ++i) {
+            vertices.push_back({origin.x + edyn::scalar(i) * cell_size.x,
+                                origin.y + field.get_height(i, j),
+                                origin.z + edyn::scalar(j) * cell_size.y});
+        }
+    }
+
+    for (uint32_t j = 0; j + 1 < nz; ++j) {
+        for (uint32_t i = 0; i + 1 < nx; ++i) {
+            auto v00 = j * nx + i;
+            indices.insert(indices.end(), {v00, v00 + nx, v00 + nx + 1});
+            indices.insert(indices.end(), {v00, v00 + nx + 1, v00 + 1});
+        }
+    }
+
+    auto mesh = std::make_shared<edyn::triangle_mesh>();
+    mesh->insert_vertices(vertices.begin(), vertices.end());
+    mesh->insert_indices(indices.begin(), indices.end());
+    mesh->initialize();
+    return mesh;
+}
+
+// Loads pages synchronously from an array of heights.
+class heightfield_test_loader : public edyn::heightfield_page_loader_base {
+public:
+    heightfield_test_loader(std::vector<edyn::scalar> heights)
+        : m_heights(std::move(heights))
+    {}
+
+    void load(edyn::heightfield *field, size_t page_index) override {
+        auto ext = field->get_page_extent(page_index);
+        auto page_heights = std::vector<edyn::scalar>{};
+
+        for (size_t j = ext.row; j < ext.row + ext.num_rows; ++j) {
+            for (size_t i = ext.column; i < ext.column + ext.num_columns; ++i) {
+                page_heights.push_back(m_heights[j * field->num_columns() + i]);
+            }
+        }
+
+        ++num_loads;
+        field->assign_page(page_index, page_heights);
+    }
+
+    size_t num_loads {0};
+
+private:
+    std::vector<edyn::scalar> m_heights;
+};
+
+TEST(test_heightfield, triangles_match_mesh) {
+    const auto cell_size = edyn::vector2{0.5, 0.75};
+    const auto origin = edyn::vector3{-3, 0.5, -4};
+    auto heights = make_terrain_heights(21, 13, cell_size);
+    // Small pages to have edges across page borders.
+    auto field = edyn::heightfield(21, 13, cell_size, origin, false, 4);
+    field.insert_heights(heights.begin(), heights.end());
+    auto mesh = make_equivalent_mesh(field);
+
+    ASSERT_EQ(field.num_pages(), 5 * 3);
+    ASSERT_EQ(field.num_triangles(), mesh->num_triangles());
+    ASSERT_VECTOR3_EQ(field.get_aabb().min, mesh->get_aabb().min);
+    ASSERT_VECTOR3_EQ(field.get_aabb().max, mesh->get_aabb().max);
+
+    // Mesh triangles are reordered, thus match them by vertex indices.
+    auto mesh_triangles = std::map<std::array<uint32_t, 3>, size_t>{};
+
+    for (size_t tri_idx = 0; tri_idx < mesh->num_triangles(); ++tri_idx) {
+        auto tri = mesh->make_packed_triangle(tri_idx);
+        mesh_triangles[tri.vertex_indices] = tri_idx;
+    }
+
+    for (size_t tri_idx = 0; tri_idx < field.num_triangles(); ++tri_idx) {
+        auto tri = field.make_packed_triangle(tri_idx);
+        auto mesh_tri = mesh->make_packed_triangle(mesh_triangles.at(tri.vertex_indices));
+        ASSERT_VECTOR3_EQ(tri.normal, mesh_tri.normal);
+        ASSERT_EQ(tri.convex_edges, mesh_tri.convex_edges);
+
+        for (size_t i = 0; i < 3; ++i) {
+            ASSERT_VECTOR3_EQ(tri.vertices[i], mesh_tri.vertices[i]);
+            ASSERT_VECTOR3_EQ(tri.adjacent_normals[i], mesh_tri.adjacent_normals[i]);
+        }
+
+        auto vertices = field.get_triangle_vertices(tri_idx);
+        ASSERT_VECTOR3_EQ(vertices[2], tri.vertices[2]);
+    }
+}
+
+TEST(test_heightfield, quantized) {
+    const auto cell_size = edyn::vector2{1, 1};
+    auto heights = make_terrain_heights(33, 33, cell_size);
+    auto field = edyn::heightfield(33, 33, cell_size, edyn::vector3_zero, true, 8);
+    field.insert_heights(heights.begin(), heights.end());
+    ASSERT_TRUE(field.is_quantized());
+
+    auto [min_it, max_it] = std::minmax_element(heights.begin(), heights.end());
+    auto step = (*max_it - *min_it) / edyn::scalar(65535);
+
+    for (size_t j = 0; j < 33; ++j) {
+        for (size_t i = 0; i < 33; ++i) {
+            ASSERT_NEAR(field.get_height(i, j), heights[j * 33 + i], step);
+        }
+    }
+
+    // Samples on page borders are shared, thus neighboring triangles in
+    // different pages have matching vertices.
+    auto tri_a = field.make_packed_triangle((8 * 32 + 7) * 2 + 1);
+    auto tri_b = field.make_packed_triangle((8 * 32 + 8) * 2);
+    ASSERT_VECTOR3_EQ(tri_a.vertices[1], tri_b.vertices[1]);
+    ASSERT_VECTOR3_EQ(tri_a.vertices[2], tri_b.vertices[0]);
+}
+
+TEST(test_heightfield, collision_matches_mesh) {
+    const auto cell_size = edyn::vector2{0.5, 0.5};
+    auto heights = make_terrain_heights(41, 41, cell_size);
+    auto field = std::make_shared<edyn::heightfield>(41, 41, cell_size, edyn::vector3_zero, false, 8);
+    field->insert_heights(heights.begin(), heights.end());
+    auto mesh = make_equivalent_mesh(*field);
+    auto shape = edyn::heightfield_shape{field};
+
+    auto rng = std::mt19937(3);
+    auto dist = std::uniform_real_distribution<edyn::scalar>(0, 1);
+    auto box = edyn::box_shape{{0.4, 0.3, 0.5}};
+    auto sphere = edyn::sphere_shape{0.4};
+    auto capsule = edyn::capsule_shape{0.25, 0.4, edyn::coordinate_axis::x};
+    size_t num_points = 0;
+
+    for (int i = 0; i < 200; ++i) {
+        auto ctx = edyn::collision_context{};
+        ctx.posA = {1 + dist(rng) * 18, 0, 1 + dist(rng) * 18};
+        ctx.posA.y = terrain_height(ctx.posA.x, ctx.posA.z) + dist(rng) * 0.6;
+        ctx.ornA = edyn::normalize(edyn::quaternion{dist(rng), dist(rng), dist(rng), dist(rng) + 1});
+        ctx.posB = edyn::vector3_zero;
+        ctx.ornB = edyn::quaternion_identity;
+        ctx.aabbB = field->get_aabb();
+        ctx.threshold = 0.02;
+
+        auto compare = [&](auto &&sh) {
+            ctx.aabbA = edyn::shape_aabb(sh, ctx.posA, ctx.ornA);
+
+            // Same triangles are candidates for collision.
+            auto field_triangles = std::set<std::array<uint32_t, 3>>{};
+            auto mesh_triangles = std::set<std::array<uint32_t, 3>>{};
+            field->visit_packed_triangles(ctx.aabbA, ctx.aabbA, ctx.threshold, [&](auto, auto &tri) {
+                field_triangles.insert(tri.vertex_indices);
+            });
+            mesh->visit_packed_triangles(ctx.aabbA, ctx.aabbA, ctx.threshold, [&](auto, auto &tri) {
+                mesh_triangles.insert(tri.vertex_indices);
+            });
+            ASSERT_EQ(field_triangles, mesh_triangles);
+
+            auto field_result = edyn::collision_result{};
+            auto mesh_result = edyn::collision_result{};
+            edyn::collide(sh, shape, ctx, field_result);
+            edyn::collide(sh, *mesh, ctx, mesh_result);
+
+            // Triangles are visited in a different order, which can lead to
+            // a different selection of contact points. The deepest point
+            // must be at about the same depth though.
+            ASSERT_EQ(field_result.num_points > 0, mesh_result.num_points > 0);
+            auto min_distance = [](const edyn::collision_result &result) {
+                auto distance = edyn::large_scalar;
+
+                for (size_t j = 0; j < result.num_points; ++j) {
+                    distance = std::min(distance, result.point[j].distance);
+                }
+
+                return distance;
+            };
+
+            ASSERT_NEAR(min_distance(field_result), min_distance(mesh_result), 0.005);
+
+            num_points += field_result.num_points;
+        };
+
+        compare(box);
+        compare(sphere);
+        compare(capsule);
+    }
+
+    ASSERT_GT(num_points, 0);
+}
+
+TEST(test_heightfield, raycast) {
+    const auto cell_size = edyn::vector2{0.5, 0.5};
+    auto heights = make_terrain_heights(41, 41, cell_size);
+    auto field = std::make_shared<edyn::heightfield>(41, 41, cell_size, edyn::vector3{-10, 0, -10});
+    field->insert_heights(heights.begin(), heights.end());
+    auto mesh = edyn::mesh_shape{make_equivalent_mesh(*field)};
+    auto shape = edyn::heightfield_shape{field};
+
+    auto rng = std::mt19937(5);
+    auto dist = std::uniform_real_distribution<edyn::scalar>(-12, 12);
+    size_t num_hits = 0;
+
+    for (int i = 0; i < 500; ++i) {
+        auto ctx = edyn::raycast_context{};
+        ctx.pos = edyn::vector3_zero;
+        ctx.orn = edyn::quaternion_identity;
+        ctx.p0 = {dist(rng), 1 + std::abs(dist(rng)) * edyn::scalar(0.2), dist(rng)};
+        ctx.p1 = {dist(rng), -1 - std::abs(dist(rng)) * edyn::scalar(0.2), dist(rng)};
+
+        auto field_result = edyn::shape_raycast(shape, ctx);
+        auto mesh_result = edyn::shape_raycast(mesh, ctx);
+        ASSERT_EQ(field_result.fraction < 1, mesh_result.fraction < 1);
+
+        if (mesh_result.fraction < 1) {
+            ASSERT_NEAR(field_result.fraction, mesh_result.fraction, 1e-5);
+            ASSERT_TRUE(std::holds_alternative<edyn::heightfield_raycast_info>(field_result.info_var));
+            ++num_hits;
+        }
+    }
+
+    ASSERT_GT(num_hits, 100);
+
+    // Vertical ray.
+    auto ctx = edyn::raycast_context{};
+    ctx.p0 = {0.01, 5, 0.01};
+    ctx.p1 = {0.01, -5, 0.01};
+    auto result = edyn::shape_raycast(shape, ctx);
+    ASSERT_NEAR(edyn::lerp(ctx.p0, ctx.p1, result.fraction).y, field->get_height(20, 20), 0.01);
+}
+
+TEST(test_heightfield, paging) {
+    const auto cell_size = edyn::vector2{1, 1};
+    auto heights = make_terrain_heights(65, 65, cell_size);
+    auto loader = std::make_shared<heightfield_test_loader>(heights);
+    auto field = edyn::heightfield(65, 65, cell_size, edyn::vector3_zero, false, 16);
+    auto [min_it, max_it] = std::minmax_element(heights.begin(), heights.end());
+    field.set_page_loader(loader, *min_it, *max_it);
+
+    ASSERT_EQ(field.num_pages(), 16);
+    ASSERT_EQ(field.cache_num_bytes(), 0);
+
+    auto visit_count = [&](edyn::AABB aabb) {
+        size_t count = 0;
+        field.visit_packed_triangles(aabb, aabb, edyn::large_scalar, [&](auto, auto &) { ++count; });
+        return count;
+    };
+
+    // First page gets loaded and visited.
+    auto aabb = edyn::AABB{{1, -1, 1}, {3, 1, 3}};
+    ASSERT_GT(visit_count(aabb), 0);
+    ASSERT_EQ(loader->num_loads, 1);
+    ASSERT_TRUE(field.is_page_loaded(0));
+    auto page_bytes = field.cache_num_bytes();
+    ASSERT_GT(page_bytes, 0);
+
+    // Only keep two pages around.
+    field.m_max_cache_num_bytes = page_bytes * 2;
+    visit_count({{17, -1, 1}, {18, 1, 2}});
+    visit_count({{33, -1, 1}, {34, 1, 2}});
+    ASSERT_EQ(loader->num_loads, 3);
+    ASSERT_FALSE(field.is_page_loaded(0));
+    ASSERT_TRUE(field.is_page_loaded(1));
+    ASSERT_TRUE(field.is_page_loaded(2));
+    ASSERT_LE(field.cache_num_bytes(), field.m_max_cache_num_bytes);
+
+    field.prefetch({{1, -1, 17}, {2, 1, 18}});
+    ASSERT_TRUE(field.is_page_loaded(4));
+
+    field.clear_cache();
+    ASSERT_EQ(field.cache_num_bytes(), 0);
+    ASSERT_FALSE(field.is_page_loaded(4));
+}
@@ -1,6 +1,7 @@
 #include "../common/common.hpp"
 #include "edyn/parallel/job_dispatcher.hpp"
 #include "edyn/shapes/create_paged_triangle_mesh.hpp"
+#include "edyn/serialization/triangle_mesh_s11n.hpp"
 
 class triangle_mesh_page_loader: public edyn::triangle_mesh_page_loader_base {
 public:
@@ -47,3 +48,97 @@ TEST(test_paged_trimesh, voronoi_regions) {
 
     edyn::job_dispatcher::global().stop();
 }
+
+class in_memory_page_loader: public edyn::triangle_mesh_page_loader_base {
+public:
+    void load(edyn::paged_triangle_mesh *trimesh, size_t index) override {
+        trimesh->assign_mesh(index, pages[index]);
+    }
+
+    std::vector<std::shared_ptr<edyn::triangle_mesh>> pages;
+};
+
+TEST(test_paged_trimesh, cache_accounting) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<edyn::triangle_mesh::index_type> indices;
+
+    for (int i = 0; i < 8; ++i) {
+        vertices.push_back({edyn::scalar(i), 0, 0});
+        vertices.push_back({edyn::scalar(i), 0, 1});
+    }
+
+    for (int i = 0; i < 7; ++i) {
+        auto j = static_cast<edyn::triangle_mesh::index_type>(i * 2);
+        indices.insert(indices.end(), {j, j + 1, j + 2});
+        indices.insert(indices.end(), {j + 1, j + 3, j + 2});
+    }
+
+    auto loader = std::make_shared<in_memory_page_loader>();
+    auto trimesh = edyn::paged_triangle_mesh(loader);
+    edyn::create_paged_triangle_mesh(trimesh, vertices.begin(), vertices.end(), indices.begin(), indices.end(), 2, {}, {});
+    ASSERT_GT(trimesh.num_submeshes(), 1);
+
+    // All submeshes are in the cache after creation.
+    size_t total_vertices = 0;
+    size_t max_submesh_vertices = 0;
+
+    for (size_t i = 0; i < trimesh.num_submeshes(); ++i) {
+        auto submesh = trimesh.get_submesh(i);
+        ASSERT_TRUE(submesh);
+        total_vertices += submesh->num_vertices();
+        max_submesh_vertices = std::max(max_submesh_vertices, submesh->num_vertices());
+        loader->pages.push_back(submesh);
+    }
+
+    ASSERT_EQ(trimesh.cache_num_vertices(), total_vertices);
+    ASSERT_GT(trimesh.cache_num_bytes(), 0);
+
+    trimesh.clear_cache();
+    ASSERT_EQ(trimesh.cache_num_vertices(), 0);
+    ASSERT_EQ(trimesh.cache_num_bytes(), 0);
+
+    // Allow a single submesh in the cache at a time.
+    trimesh.m_max_cache_num_vertices = max_submesh_vertices + 1;
+    size_t num_visited = 0;
+
+    trimesh.visit_submeshes(trimesh.get_aabb(), [&](size_t) {
+        ++num_visited;
+    });
+
+    ASSERT_EQ(num_visited, trimesh.num_submeshes());
+
+    size_t num_loaded = 0;
+    size_t loaded_vertices = 0;
+
+    for (size_t i = 0; i < trimesh.num_submeshes(); ++i) {
+        if (auto submesh = trimesh.get_submesh(i)) {
+            ++num_loaded;
+            loaded_vertices += submesh->num_vertices();
+        }
+    }
+
+    ASSERT_EQ(num_loaded, 1);
+    ASSERT_EQ(trimesh.cache_num_vertices(), loaded_vertices);
+    ASSERT_LE(trimesh.cache_num_vertices(), trimesh.m_max_cache_num_vertices);
+
+    // Prefetching loads without exceeding the budget either.
+    trimesh.clear_cache();
+    trimesh.prefetch(trimesh.get_aabb());
+    ASSERT_LE(trimesh.cache_num_vertices(), trimesh.m_max_cache_num_vertices);
+    ASSERT_GT(trimesh.cache_num_vertices(), 0);
+
+    // The byte budget is respected after each load, even though the size of
+    // a submesh is only known once it's loaded.
+    trimesh.clear_cache();
+    trimesh.m_max_cache_num_vertices = total_vertices + 1;
+    size_t max_submesh_bytes = 0;
+
+    for (auto &page : loader->pages) {
+        max_submesh_bytes = std::max(max_submesh_bytes, edyn::serialization_sizeof(*page));
+    }
+
+    trimesh.m_max_cache_num_bytes = max_submesh_bytes * 3 / 2;
+    trimesh.visit_submeshes(trimesh.get_aabb(), [&](size_t) {});
+    ASSERT_LE(trimesh.cache_num_bytes(), trimesh.m_max_cache_num_bytes);
+    ASSERT_GT(trimesh.cache_num_bytes(), 0);
+}
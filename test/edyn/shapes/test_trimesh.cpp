@@ -1,4 +1,6 @@
 #include "../common/common.hpp"
+#include "edyn/util/shape_util.hpp"
+#include <algorithm>
 
 TEST(test_trimesh, voronoi_regions) {
     auto vertices = std::vector<edyn::vector3>{};
@@ -39,3 +41,195 @@ TEST(test_trimesh, voronoi_regions) {
     ASSERT_VECTOR3_EQ(trimesh.get_aabb().min, {-1, 0, -1});
     ASSERT_VECTOR3_EQ(trimesh.get_aabb().max, {2, 1, 1});
 }
+
+TEST(test_trimesh, plane_edges) {
+    size_t num_vertices_x = 21;
+    size_t num_vertices_z = 13;
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    edyn::make_plane_mesh(4, 4, num_vertices_x, num_vertices_z, vertices, indices);
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    // Euler characteristic of a disc: V - E + F = 1.
+    ASSERT_EQ(trimesh.num_edges(), trimesh.num_vertices() + trimesh.num_triangles() - 1);
+
+    size_t num_boundary_edges = 0;
+
+    for (size_t i = 0; i < trimesh.num_edges(); ++i) {
+        num_boundary_edges += trimesh.is_boundary_edge(i);
+    }
+
+    ASSERT_EQ(num_boundary_edges, 2 * (num_vertices_x - 1) + 2 * (num_vertices_z - 1));
+
+    // Each face edge must connect the vertices of the face.
+    for (size_t tri_idx = 0; tri_idx < trimesh.num_triangles(); ++tri_idx) {
+        for (size_t i = 0; i < 3; ++i) {
+            auto edge_vertices = trimesh.get_edge_vertex_indices(trimesh.get_face_edge_index(tri_idx, i));
+            auto v0 = trimesh.get_face_vertex_index(tri_idx, i);
+            auto v1 = trimesh.get_face_vertex_index(tri_idx, (i + 1) % 3);
+            ASSERT_TRUE((edge_vertices[0] == v0 && edge_vertices[1] == v1) ||
+                        (edge_vertices[0] == v1 && edge_vertices[1] == v0));
+            // The edge must refer back to this face.
+            auto edge_faces = trimesh.get_edge_face_indices(trimesh.get_face_edge_index(tri_idx, i));
+            ASSERT_TRUE(edge_faces[0] == tri_idx || edge_faces[1] == tri_idx);
+        }
+    }
+}
+
+TEST(test_trimesh, fan_edges) {
+    // A single vertex shared by all triangles in a closed fan.
+    uint32_t num_triangles = 500;
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    vertices.push_back(edyn::vector3_zero);
+
+    for (uint32_t i = 0; i < num_triangles; ++i) {
+        auto angle = edyn::scalar(i) / edyn::scalar(num_triangles) * edyn::pi2;
+        vertices.push_back({std::cos(angle), 0, std::sin(angle)});
+    }
+
+    for (uint32_t i = 0; i < num_triangles; ++i) {
+        auto next = (i + 1) % num_triangles;
+        indices.insert(indices.end(), {0, next + 1, i + 1});
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    // One spoke and one rim edge per triangle.
+    ASSERT_EQ(trimesh.num_edges(), 2 * num_triangles);
+
+    // Each spoke is shared by two triangles and each rim edge is on the
+    // boundary.
+    size_t num_boundary_edges = 0;
+
+    for (size_t i = 0; i < trimesh.num_edges(); ++i) {
+        num_boundary_edges += trimesh.is_boundary_edge(i);
+    }
+
+    ASSERT_EQ(num_boundary_edges, num_triangles);
+
+    // The first spoke of each triangle is the last spoke of the next one.
+    for (uint32_t tri_idx = 0; tri_idx < num_triangles; ++tri_idx) {
+        auto next_idx = (tri_idx + 1) % num_triangles;
+        ASSERT_EQ(trimesh.get_face_edge_index(tri_idx, 0), trimesh.get_face_edge_index(next_idx, 2));
+    }
+}
+
+TEST(test_trimesh, queries_report_input_indices) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    edyn::make_plane_mesh(4, 4, 9, 9, vertices, indices);
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+
+    // Triangles keep their input order, thus indices reported by queries can
+    // be used to look up per-triangle user data.
+    for (size_t tri_idx = 0; tri_idx < trimesh.num_triangles(); ++tri_idx) {
+        for (size_t i = 0; i < 3; ++i) {
+            ASSERT_EQ(trimesh.get_face_vertex_index(tri_idx, i), indices[tri_idx * 3 + i]);
+        }
+
+        auto tri_vertices = trimesh.get_triangle_vertices(tri_idx);
+        auto center = (tri_vertices[0] + tri_vertices[1] + tri_vertices[2]) / edyn::scalar(3);
+        auto found_raycast = false;
+        auto found_query = false;
+
+        trimesh.raycast(center + edyn::vector3_y, center - edyn::vector3_y, [&](auto idx) {
+            found_raycast |= idx == tri_idx;
+        });
+
+        trimesh.visit_triangles({center - edyn::vector3_one * 0.01, center + edyn::vector3_one * 0.01}, [&](auto idx) {
+            found_query |= idx == tri_idx;
+        });
+
+        ASSERT_TRUE(found_raycast);
+        ASSERT_TRUE(found_query);
+    }
+}
+
+TEST(test_trimesh, packed_triangles) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    edyn::make_plane_mesh(4, 4, 9, 9, vertices, indices);
+
+    // Raise a ridge along the middle to have concave and convex edges.
+    for (auto &v : vertices) {
+        v.y = std::abs(v.x) < 0.1 ? 0.5 : 0;
+    }
+
+    auto trimesh = edyn::triangle_mesh{};
+    trimesh.insert_vertices(vertices.begin(), vertices.end());
+    trimesh.insert_indices(indices.begin(), indices.end());
+    trimesh.initialize();
+    ASSERT_FALSE(trimesh.has_triangle_cache());
+
+    for (size_t tri_idx = 0; tri_idx < trimesh.num_triangles(); ++tri_idx) {
+        auto tri = trimesh.make_packed_triangle(tri_idx);
+        auto tri_vertices = trimesh.get_triangle_vertices(tri_idx);
+        ASSERT_VECTOR3_EQ(tri.normal, trimesh.get_triangle_normal(tri_idx));
+
+        for (size_t i = 0; i < 3; ++i) {
+            auto edge_idx = trimesh.get_face_edge_index(tri_idx, i);
+            ASSERT_VECTOR3_EQ(tri.vertices[i], tri_vertices[i]);
+            ASSERT_VECTOR3_EQ(tri.adjacent_normals[i], trimesh.get_adjacent_face_normal(tri_idx, i));
+            ASSERT_EQ(tri.vertex_indices[i], trimesh.get_face_vertex_index(tri_idx, i));
+            ASSERT_EQ(tri.edge_indices[i], edge_idx);
+            ASSERT_EQ(tri.is_convex_edge(i), trimesh.is_convex_edge(edge_idx));
+        }
+    }
+
+    // Query a region under the ridge with a box that is above the flat part.
+    auto query_aabb = edyn::AABB{{-0.6, -0.1, -0.6}, {0.6, 0.8, 0.6}};
+    auto shape_aabb = edyn::AABB{{-0.5, 0.3, -0.5}, {0.5, 0.8, 0.5}};
+    auto threshold = edyn::scalar(0.02);
+
+    auto visit = [&]() {
+        auto visited = std::vector<size_t>{};
+        trimesh.visit_packed_triangles(query_aabb, shape_aabb, threshold, [&](auto tri_idx, auto &tri) {
+            if (tri.normal == trimesh.get_triangle_normal(tri_idx)) {
+                visited.push_back(tri_idx);
+            }
+        });
+        return visited;
+    };
+
+    auto visited = visit();
+    auto all = std::vector<size_t>{};
+    trimesh.visit_triangles(query_aabb, [&](auto tri_idx) { all.push_back(tri_idx); });
+    ASSERT_GT(visited.size(), 0);
+    ASSERT_LT(visited.size(), all.size());
+
+    // Triangles that were skipped must be separated by their face normal.
+    for (auto tri_idx : all) {
+        if (std::find(visited.begin(), visited.end(), tri_idx) != visited.end()) {
+            continue;
+        }
+
+        auto normal = trimesh.get_triangle_normal(tri_idx);
+        auto vertex = trimesh.get_vertex_position(trimesh.get_face_vertex_index(tri_idx, 0));
+        auto support = edyn::vector3{
+            normal.x > 0 ? shape_aabb.min.x : shape_aabb.max.x,
+            normal.y > 0 ? shape_aabb.min.y : shape_aabb.max.y,
+            normal.z > 0 ? shape_aabb.min.z : shape_aabb.max.z,
+        };
+        ASSERT_GT(edyn::dot(support - vertex, normal), threshold);
+    }
+
+    // The cache must not change the result.
+    trimesh.build_triangle_cache();
+    ASSERT_TRUE(trimesh.has_triangle_cache());
+    ASSERT_EQ(visit(), visited);
+
+    trimesh.clear_triangle_cache();
+    ASSERT_FALSE(trimesh.has_triangle_cache());
+}
@@ -0,0 +1,154 @@
+#include "../common/common.hpp"
+#include <edyn/util/island_util.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+static void make_bodies(entt::registry &registry) {
+    auto floor_def = edyn::rigidbody_def();
+    floor_def.kind = edyn::rigidbody_kind::rb_static;
+    floor_def.shape = edyn::plane_shape{{0, 1, 0}, 0};
+    edyn::make_rigidbody(registry, floor_def);
+
+    // Separate boxes resting on the floor, interleaving ones that can fall
+    // asleep with ones that can't, so they're mixed up in the pools.
+    auto def = edyn::rigidbody_def();
+    def.shape = edyn::box_shape{0.2, 0.2, 0.2};
+
+    for (int i = 0; i < 20; ++i) {
+        def.position = {edyn::scalar(i), edyn::scalar(0.2), 0};
+        def.sleeping_disabled = i % 2 == 0;
+        edyn::make_rigidbody(registry, def);
+    }
+}
+
+static void step(entt::registry &registry, int first_step, int last_step) {
+    for (int i = first_step; i < last_step; ++i) {
+        edyn::step_simulation(registry, edyn::scalar(i) / 60);
+    }
+}
+
+static size_t count_sleeping_bodies(entt::registry &registry) {
+    auto view = registry.view<edyn::dynamic_tag, edyn::sleeping_tag>();
+    return static_cast<size_t>(std::distance(view.begin(), view.end()));
+}
+
+static bool is_dormant(entt::registry &registry, entt::entity entity) {
+    return registry.any_of<edyn::sleeping_tag, edyn::disabled_tag>(entity);
+}
+
+static void check_awake_entities_first(entt::registry &registry) {
+    auto &sleeping = registry.storage<edyn::sleeping_tag>();
+    auto num_dormant = size_t{0};
+
+    const entt::sparse_set &positions = registry.storage<edyn::position>();
+
+    for (auto entity : positions) {
+        if (is_dormant(registry, entity)) {
+            ++num_dormant;
+        } else {
+            // No awake entity after the first dormant one.
+            ASSERT_EQ(num_dormant, 0);
+        }
+    }
+
+    for (auto entity : registry.view<edyn::linvel, edyn::dynamic_tag>(edyn::exclude_sleeping_disabled)) {
+        ASSERT_FALSE(sleeping.contains(entity));
+    }
+}
+
+TEST(test_compact_sleeping_pools, awake_entities_first) {
+    entt::registry registry;
+
+    auto config = edyn::init_config{};
+    config.execution_mode = edyn::execution_mode::sequential;
+    edyn::attach(registry, config);
+    edyn::set_compact_sleeping_pools(registry, true);
+    edyn::set_paused(registry, true);
+
+    make_bodies(registry);
+
+    // Enough time to fall asleep.
+    step(registry, 0, 240);
+    ASSERT_EQ(count_sleeping_bodies(registry), 10);
+    check_awake_entities_first(registry);
+
+    // Destroying a sleeping body moves the last entity of each pool, which is
+    // awake, into its slot on the dormant side.
+    auto sleeping_view = registry.view<edyn::dynamic_tag, edyn::sleeping_tag>();
+    registry.destroy(*sleeping_view.begin());
+    step(registry, 240, 241);
+    check_awake_entities_first(registry);
+
+    edyn::detach(registry);
+}
+
+TEST(test_compact_sleeping_pools, compact_when_enabled) {
+    entt::registry registry;
+
+    auto config = edyn::init_config{};
+    config.execution_mode = edyn::execution_mode::sequential;
+    edyn::attach(registry, config);
+    edyn::set_paused(registry, true);
+
+    make_bodies(registry);
+    step(registry, 0, 240);
+
+    // Pools are partitioned in the first step after enabling, even though
+    // no island changes state anymore.
+    ASSERT_EQ(count_sleeping_bodies(registry), 10);
+    edyn::set_compact_sleeping_pools(registry, true);
+    step(registry, 240, 241);
+    check_awake_entities_first(registry);
+
+    edyn::detach(registry);
+}
+
+TEST(test_compact_sleeping_pools, disable_and_enable_entity) {
+    entt::registry registry;
+
+    auto config = edyn::init_config{};
+    config.execution_mode = edyn::execution_mode::sequential;
+    edyn::attach(registry, config);
+    edyn::set_compact_sleeping_pools(registry, true);
+    edyn::set_paused(registry, true);
+
+    make_bodies(registry);
+
+    // A body floating on its own island, which never falls asleep.
+    auto def = edyn::rigidbody_def();
+    def.shape = edyn::box_shape{0.2, 0.2, 0.2};
+    def.position = {0, 10, 0};
+    def.gravity = edyn::vector3_zero;
+    def.sleeping_disabled = true;
+    auto entity = edyn::make_rigidbody(registry, def);
+
+    step(registry, 0, 240);
+    ASSERT_EQ(count_sleeping_bodies(registry), 10);
+    check_awake_entities_first(registry);
+    ASSERT_FALSE(is_dormant(registry, entity));
+
+    // Disabling the body together with its island moves it to the dormant
+    // side of the pools.
+    auto island_entity = registry.get<edyn::island_resident>(entity).island_entity;
+    registry.emplace<edyn::disabled_tag>(entity);
+    registry.emplace<edyn::disabled_tag>(island_entity);
+    step(registry, 240, 241);
+    check_awake_entities_first(registry);
+
+    // And enabling it moves it back to the awake side.
+    registry.remove<edyn::disabled_tag>(entity);
+    registry.remove<edyn::disabled_tag>(island_entity);
+    step(registry, 241, 242);
+    check_awake_entities_first(registry);
+    ASSERT_FALSE(is_dormant(registry, entity));
+
+    // It's moved across the boundary with a single swap, thus it's now the
+    // first awake entity in the packed array.
+    const entt::sparse_set &positions = registry.storage<edyn::position>();
+    auto num_dormant = static_cast<size_t>(std::count_if(positions.begin(), positions.end(),
+        [&](auto other) { return is_dormant(registry, other); }));
+    ASSERT_EQ(positions.index(entity), num_dormant);
+
+    edyn::detach(registry);
+}
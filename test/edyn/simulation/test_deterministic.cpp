@@ -0,0 +1,83 @@
+#include "../common/common.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+template<typename T>
+static void hash_bytes(uint64_t &hash, const T &value) {
+    // FNV-1a.
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+
+    for (auto byte : bytes) {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    }
+}
+
+static uint64_t simulate_and_hash(edyn::execution_mode mode, size_t num_worker_threads) {
+    entt::registry registry;
+
+    auto config = edyn::init_config{};
+    config.execution_mode = mode;
+    config.num_worker_threads = num_worker_threads;
+    edyn::attach(registry, config);
+    edyn::set_deterministic(registry, true);
+    edyn::set_paused(registry, true);
+
+    auto floor_def = edyn::rigidbody_def();
+    floor_def.kind = edyn::rigidbody_kind::rb_static;
+    floor_def.shape = edyn::plane_shape{{0, 1, 0}, 0};
+    edyn::make_rigidbody(registry, floor_def);
+
+    // Enough bodies and contacts to take the parallel paths in broadphase,
+    // narrowphase and solver when running multi-threaded.
+    auto bodies = std::vector<entt::entity>{};
+    auto def = edyn::rigidbody_def();
+    def.mass = 10;
+
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            for (int k = 0; k < 4; ++k) {
+                if ((i + j + k) % 2 == 0) {
+                    def.shape = edyn::box_shape{0.2, 0.2, 0.2};
+                } else {
+                    def.shape = edyn::sphere_shape{0.2};
+                }
+
+                def.position = {edyn::scalar(j) * edyn::scalar(0.41) + edyn::scalar(i) * edyn::scalar(0.03),
+                                edyn::scalar(0.2) + edyn::scalar(i) * edyn::scalar(0.42),
+                                edyn::scalar(k) * edyn::scalar(0.41)};
+                def.orientation = edyn::quaternion_axis_angle({0, 1, 0}, edyn::scalar(i + j + k) * edyn::scalar(0.1));
+                bodies.push_back(edyn::make_rigidbody(registry, def));
+            }
+        }
+    }
+
+    for (int i = 0; i < 120; ++i) {
+        edyn::step_simulation(registry, edyn::scalar(i) / 60);
+    }
+
+    uint64_t hash = 0xcbf29ce484222325;
+
+    for (auto entity : bodies) {
+        auto [pos, orn, v, w] = registry.get<edyn::position, edyn::orientation, edyn::linvel, edyn::angvel>(entity);
+        hash_bytes(hash, static_cast<edyn::vector3>(pos));
+        hash_bytes(hash, static_cast<edyn::quaternion>(orn));
+        hash_bytes(hash, static_cast<edyn::vector3>(v));
+        hash_bytes(hash, static_cast<edyn::vector3>(w));
+    }
+
+    edyn::detach(registry);
+
+    return hash;
+}
+
+TEST(test_deterministic, same_state_across_thread_counts) {
+    auto hash_seq = simulate_and_hash(edyn::execution_mode::sequential, 0);
+    auto hash_mt1 = simulate_and_hash(edyn::execution_mode::sequential_multithreaded, 1);
+    auto hash_mt8 = simulate_and_hash(edyn::execution_mode::sequential_multithreaded, 8);
+
+    ASSERT_EQ(hash_mt1, hash_mt8);
+    ASSERT_EQ(hash_seq, hash_mt1);
+}
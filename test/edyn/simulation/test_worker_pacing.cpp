@@ -0,0 +1,73 @@
+#include "../common/common.hpp"
+#include "edyn/simulation/worker_pacing_stats.hpp"
+
+// Clock which advances by a fixed amount every time it's read.
+static double fake_time = 0;
+static double fake_time_step = 0;
+
+static double fake_time_func() {
+    auto time = fake_time;
+    fake_time += fake_time_step;
+    return time;
+}
+
+TEST(test_worker_pacing, deadline_sequence) {
+    auto fixed_dt = 0.01;
+    auto deadline = 0.0;
+
+    // Updates on time advance the deadline by exactly one step, without
+    // accumulating the lateness of each wake up.
+    deadline = edyn::next_pacing_deadline(deadline, 0.0, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.01);
+    deadline = edyn::next_pacing_deadline(deadline, 0.0102, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.02);
+    deadline = edyn::next_pacing_deadline(deadline, 0.0201, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.03);
+
+    // An update triggered by a message keeps the same deadline.
+    deadline = edyn::next_pacing_deadline(deadline, 0.025, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.03);
+    deadline = edyn::next_pacing_deadline(deadline, 0.03, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.04);
+
+    // After falling behind by more than a step, restart from the current time.
+    deadline = edyn::next_pacing_deadline(deadline, 0.075, fixed_dt);
+    ASSERT_DOUBLE_EQ(deadline, 0.085);
+}
+
+TEST(test_worker_pacing, spin_until) {
+    fake_time = 0;
+    fake_time_step = 0.0003;
+
+    auto now = edyn::spin_until(0.001, &fake_time_func);
+    ASSERT_GE(now, 0.001);
+    ASSERT_LT(now, 0.001 + fake_time_step);
+
+    // Deadlines in the past return immediately.
+    auto past = edyn::spin_until(0, &fake_time_func);
+    ASSERT_DOUBLE_EQ(past, now + fake_time_step);
+}
+
+TEST(test_worker_pacing, record_pacing_error) {
+    auto stats = edyn::worker_pacing_stats{};
+
+    // The first error initializes the average.
+    edyn::record_pacing_error(stats, 0.002);
+    ASSERT_DOUBLE_EQ(stats.last_error, 0.002);
+    ASSERT_DOUBLE_EQ(stats.average_error, 0.002);
+    ASSERT_DOUBLE_EQ(stats.max_error, 0.002);
+    ASSERT_EQ(stats.num_updates, 1);
+
+    // Early wake ups have negative errors and count by magnitude.
+    edyn::record_pacing_error(stats, -0.004);
+    ASSERT_DOUBLE_EQ(stats.last_error, -0.004);
+    ASSERT_DOUBLE_EQ(stats.average_error, 0.002 + (0.004 - 0.002) * 0.05);
+    ASSERT_DOUBLE_EQ(stats.max_error, 0.004);
+    ASSERT_EQ(stats.num_updates, 2);
+
+    edyn::record_pacing_error(stats, 0.001);
+    ASSERT_DOUBLE_EQ(stats.last_error, 0.001);
+    ASSERT_DOUBLE_EQ(stats.max_error, 0.004);
+    ASSERT_EQ(stats.num_updates, 3);
+    ASSERT_EQ(stats.num_early_wakeups, 0);
+}
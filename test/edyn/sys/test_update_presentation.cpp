@@ -0,0 +1,156 @@
+#include "../common/common.hpp"
+#include <edyn/sys/update_presentation.hpp>
+#include <random>
+#include <vector>
+
+static entt::entity make_presentation_body(entt::registry &registry,
+                                           const edyn::vector3 &pos, const edyn::quaternion &orn,
+                                           const edyn::vector3 &v, const edyn::vector3 &w) {
+    auto entity = registry.create();
+    registry.emplace<edyn::position>(entity, pos);
+    registry.emplace<edyn::orientation>(entity, orn);
+    registry.emplace<edyn::linvel>(entity, v);
+    registry.emplace<edyn::angvel>(entity, w);
+    registry.emplace<edyn::present_position>(entity, pos);
+    registry.emplace<edyn::present_orientation>(entity, orn);
+    registry.emplace<edyn::procedural_tag>(entity);
+    return entity;
+}
+
+TEST(update_presentation, batches_match_integrate) {
+    entt::registry registry;
+    registry.ctx().emplace<edyn::settings>();
+
+    auto rng = std::mt19937(7);
+    auto dist = std::uniform_real_distribution<edyn::scalar>(-2, 2);
+    auto entities = std::vector<entt::entity>{};
+
+    // Not a multiple of the batch size. Includes bodies with tiny angular
+    // velocity, which take the other branch in `integrate`.
+    for (int i = 0; i < 19; ++i) {
+        auto pos = edyn::vector3{dist(rng), dist(rng), dist(rng)};
+        auto orn = edyn::normalize(edyn::quaternion{dist(rng), dist(rng), dist(rng), dist(rng) + 3});
+        auto v = edyn::vector3{dist(rng), dist(rng), dist(rng)};
+        auto w = i % 4 == 0 ? edyn::vector3{0.0001, 0, 0} : edyn::vector3{dist(rng), dist(rng), dist(rng)};
+        entities.push_back(make_presentation_body(registry, pos, orn, v, w));
+    }
+
+    // Sleeping and non-procedural bodies are left untouched.
+    auto sleeping = make_presentation_body(registry, edyn::vector3_zero, edyn::quaternion_identity,
+                                           {1, 0, 0}, {0, 1, 0});
+    registry.emplace<edyn::sleeping_tag>(sleeping);
+    auto kinematic = make_presentation_body(registry, edyn::vector3_zero, edyn::quaternion_identity,
+                                            {1, 0, 0}, {0, 1, 0});
+    registry.remove<edyn::procedural_tag>(kinematic);
+
+    const auto dt = edyn::scalar(0.01);
+    auto buffer = std::vector<edyn::presentation_transform>(8);
+    auto output = edyn::presentation_output{buffer.data(), buffer.size()};
+    edyn::update_presentation(registry, 1, 1 + dt, dt, 0, &output);
+
+    ASSERT_EQ(output.size, entities.size());
+
+    for (auto entity : entities) {
+        auto [pos, orn, v, w] = registry.get<edyn::position, edyn::orientation, edyn::linvel, edyn::angvel>(entity);
+        auto expected_orn = edyn::integrate(orn, w, dt);
+        auto &p_pos = registry.get<edyn::present_position>(entity);
+        auto &p_orn = registry.get<edyn::present_orientation>(entity);
+
+        ASSERT_NEAR(p_pos.x, pos.x + v.x * dt, 1e-5);
+        ASSERT_NEAR(p_pos.y, pos.y + v.y * dt, 1e-5);
+        ASSERT_NEAR(p_pos.z, pos.z + v.z * dt, 1e-5);
+        ASSERT_NEAR(p_orn.x, expected_orn.x, 1e-5);
+        ASSERT_NEAR(p_orn.y, expected_orn.y, 1e-5);
+        ASSERT_NEAR(p_orn.z, expected_orn.z, 1e-5);
+        ASSERT_NEAR(p_orn.w, expected_orn.w, 1e-5);
+    }
+
+    // Only as many as fit in the buffer are written.
+    for (auto &transform : buffer) {
+        ASSERT_TRUE(registry.all_of<edyn::procedural_tag>(transform.entity));
+        ASSERT_VECTOR3_EQ(transform.position, registry.get<edyn::present_position>(transform.entity));
+    }
+
+    ASSERT_VECTOR3_EQ(registry.get<edyn::present_position>(sleeping), edyn::vector3_zero);
+    ASSERT_VECTOR3_EQ(registry.get<edyn::present_position>(kinematic), edyn::vector3_zero);
+}
+
+TEST(update_presentation, output_set_in_settings) {
+    entt::registry registry;
+    registry.ctx().emplace<edyn::settings>();
+
+    auto entity = make_presentation_body(registry, edyn::vector3_zero, edyn::quaternion_identity,
+                                         {1, 0, 0}, edyn::vector3_zero);
+
+    auto buffer = std::vector<edyn::presentation_transform>(4);
+    auto output = edyn::presentation_output{buffer.data(), buffer.size()};
+    edyn::set_presentation_output(registry, &output);
+
+    const auto dt = edyn::scalar(0.01);
+    edyn::update_presentation(registry, 1, 1 + dt, dt, 0);
+
+    ASSERT_EQ(output.size, 1);
+    ASSERT_EQ(buffer[0].entity, entity);
+    ASSERT_VECTOR3_EQ(buffer[0].position, registry.get<edyn::present_position>(entity));
+
+    // Nothing is written after it's unset.
+    edyn::set_presentation_output(registry, nullptr);
+    registry.replace<edyn::linvel>(entity, edyn::vector3{2, 0, 0});
+    edyn::update_presentation(registry, 1, 1 + dt, dt, 0);
+    ASSERT_VECTOR3_EQ(registry.get<edyn::present_position>(entity), edyn::vector3{2 * dt, 0, 0});
+    ASSERT_VECTOR3_EQ(buffer[0].position, edyn::vector3{dt, 0, 0});
+
+TEST(update_presentation, exporter_stable_slots) {
+    entt::registry registry;
+    registry.ctx().emplace<edyn::settings>();
+    auto &exporter = registry.ctx().emplace<edyn::presentation_exporter>(registry);
+
+    auto entities = std::vector<entt::entity>{};
+
+    for (int i = 0; i < 10; ++i) {
+        auto pos = edyn::vector3{edyn::scalar(i), 0, 0};
+        entities.push_back(make_presentation_body(registry, pos, edyn::quaternion_identity,
+                                                  {0, 1, 0}, edyn::vector3_zero));
+    }
+
+    edyn::update_presentation(registry, 1, 1.01, 0.01, 0);
+
+    ASSERT_EQ(exporter.size(), entities.size());
+    ASSERT_EQ(exporter.dirty_ranges().size(), 1);
+    ASSERT_EQ(exporter.dirty_ranges()[0].begin, 0);
+    ASSERT_EQ(exporter.dirty_ranges()[0].end, entities.size());
+
+    for (auto entity : entities) {
+        auto &transform = exporter.data()[exporter.index_of(entity)];
+        ASSERT_EQ(transform.entity, entity);
+        ASSERT_VECTOR3_EQ(transform.position, registry.get<edyn::present_position>(entity));
+    }
+
+    exporter.clear_dirty_ranges();
+
+    // Other bodies keep their slots when one is destroyed.
+    auto destroyed_index = exporter.index_of(entities[3]);
+    auto last_index = exporter.index_of(entities.back());
+    registry.destroy(entities[3]);
+    ASSERT_EQ(exporter.data()[destroyed_index].entity, entt::null);
+    ASSERT_EQ(exporter.index_of(entities.back()), last_index);
+
+    // Sleeping bodies are not rewritten.
+    registry.emplace<edyn::sleeping_tag>(entities[0]);
+    registry.emplace<edyn::sleeping_tag>(entities[1]);
+    exporter.clear_dirty_ranges();
+    edyn::update_presentation(registry, 1, 1.01, 0.01, 0);
+
+    for (auto &range : exporter.dirty_ranges()) {
+        ASSERT_GE(range.begin, exporter.index_of(entities[2]));
+    }
+
+    // Vacant slot is reused.
+    auto entity = make_presentation_body(registry, {5, 5, 5}, edyn::quaternion_identity,
+                                         edyn::vector3_zero, edyn::vector3_zero);
+    registry.emplace<edyn::sleeping_tag>(entity);
+    edyn::update_presentation(registry, 1, 1.01, 0.01, 0);
+    ASSERT_EQ(exporter.index_of(entity), destroyed_index);
+    ASSERT_EQ(exporter.size(), entities.size());
+    ASSERT_VECTOR3_EQ(exporter.data()[destroyed_index].position, edyn::vector3{5, 5, 5});
+}
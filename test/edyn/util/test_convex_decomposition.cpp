@@ -0,0 +1,127 @@
+#include "../common/common.hpp"
+#include "edyn/util/convex_decomposition.hpp"
+#include "edyn/util/shape_io.hpp"
+#include "edyn/util/shape_util.hpp"
+#include <filesystem>
+
+static void make_torus_mesh(edyn::scalar major_radius, edyn::scalar minor_radius,
+                            uint32_t num_rings, uint32_t num_sides,
+                            std::vector<edyn::vector3> &vertices,
+                            std::vector<uint32_t> &indices) {
+    for (uint32_t i = 0; i < num_rings; ++i) {
+        for (uint32_t j = 0; j < num_sides; ++j) {
+            auto a = edyn::scalar(i) / edyn::scalar(num_rings) * edyn::pi2;
+            auto b = edyn::scalar(j) / edyn::scalar(num_sides) * edyn::pi2;
+            auto r = major_radius + minor_radius * std::cos(b);
+            vertices.push_back({r * std::cos(a), r * std::sin(a), minor_radius * std::sin(b)});
+        }
+    }
+
+    for (uint32_t i = 0; i < num_rings; ++i) {
+        for (uint32_t j = 0; j < num_sides; ++j) {
+            auto i1 = (i + 1) % num_rings;
+            auto j1 = (j + 1) % num_sides;
+            indices.insert(indices.end(), {i * num_sides + j, i1 * num_sides + j, i1 * num_sides + j1});
+            indices.insert(indices.end(), {i * num_sides + j, i1 * num_sides + j1, i * num_sides + j1});
+        }
+    }
+}
+
+static edyn::scalar compound_volume(const edyn::compound_shape &compound) {
+    auto volume = edyn::scalar(0);
+
+    for (auto &node : compound.nodes) {
+        auto &mesh = *std::get<edyn::polyhedron_shape>(node.shape_var).mesh;
+
+        for (size_t i = 0; i < mesh.num_faces(); ++i) {
+            auto first = mesh.faces[i * 2];
+            auto count = mesh.faces[i * 2 + 1];
+            auto &v0 = mesh.vertices[mesh.indices[first]];
+
+            for (size_t j = 1; j + 1 < count; ++j) {
+                auto &v1 = mesh.vertices[mesh.indices[first + j]];
+                auto &v2 = mesh.vertices[mesh.indices[first + j + 1]];
+                volume += edyn::dot(v0, edyn::cross(v1, v2)) / 6;
+            }
+        }
+    }
+
+    return volume;
+}
+
+TEST(test_convex_decomposition, box) {
+    auto mesh = edyn::obj_mesh{};
+    edyn::make_box_mesh({1, 2, 3}, mesh.vertices, mesh.indices, mesh.faces);
+
+    auto compound = edyn::decompose_convex(mesh);
+    ASSERT_EQ(compound.nodes.size(), 1);
+    ASSERT_NEAR(compound_volume(compound), 48, 0.01);
+    ASSERT_VECTOR3_EQ(compound.nodes.front().position, edyn::vector3_zero);
+}
+
+TEST(test_convex_decomposition, torus) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    make_torus_mesh(2, 0.5, 64, 32, vertices, indices);
+
+    auto settings = edyn::convex_decomposition_settings{};
+    settings.resolution = 50000;
+    settings.max_hulls = 24;
+    auto compound = edyn::decompose_convex(vertices, indices, settings);
+
+    // The hole must not be filled.
+    ASSERT_GT(compound.nodes.size(), 4);
+    ASSERT_LE(compound.nodes.size(), settings.max_hulls);
+
+    auto volume = compound_volume(compound);
+    auto torus_volume = 2 * edyn::pi * edyn::pi * 2 * 0.5 * 0.5;
+    ASSERT_GT(volume, torus_volume * 0.9);
+    ASSERT_LT(volume, torus_volume * 1.4);
+
+    for (auto &node : compound.nodes) {
+        auto &mesh = *std::get<edyn::polyhedron_shape>(node.shape_var).mesh;
+        ASSERT_TRUE(mesh.validate());
+        ASSERT_LE(mesh.vertices.size(), settings.max_hull_vertices);
+        ASSERT_LT(edyn::distance(edyn::vector3_zero, node.position), 2.5);
+        ASSERT_GT(edyn::distance(edyn::vector3_zero, node.position), 1);
+    }
+}
+
+TEST(test_convex_decomposition, cache) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    make_torus_mesh(2, 0.5, 32, 16, vertices, indices);
+
+    auto settings = edyn::convex_decomposition_settings{};
+    settings.resolution = 20000;
+    settings.max_hulls = 8;
+    settings.cache_path = (std::filesystem::temp_directory_path() / "edyn_convex_decomposition.bin").string();
+    std::filesystem::remove(settings.cache_path);
+
+    auto compound = edyn::decompose_convex(vertices, indices, settings);
+    auto cached = edyn::decompose_convex(vertices, indices, settings);
+
+    ASSERT_EQ(compound.nodes.size(), cached.nodes.size());
+
+    for (size_t i = 0; i < compound.nodes.size(); ++i) {
+        auto &mesh = *std::get<edyn::polyhedron_shape>(compound.nodes[i].shape_var).mesh;
+        auto &cached_mesh = *std::get<edyn::polyhedron_shape>(cached.nodes[i].shape_var).mesh;
+        ASSERT_VECTOR3_EQ(compound.nodes[i].position, cached.nodes[i].position);
+        ASSERT_EQ(mesh.vertices.size(), cached_mesh.vertices.size());
+        ASSERT_EQ(mesh.indices, cached_mesh.indices);
+    }
+
+    // A truncated cache file is a cache miss and gets rewritten.
+    auto cache_size = std::filesystem::file_size(settings.cache_path);
+    std::filesystem::resize_file(settings.cache_path, cache_size / 2);
+    auto recomputed = edyn::decompose_convex(vertices, indices, settings);
+    ASSERT_EQ(compound.nodes.size(), recomputed.nodes.size());
+    ASSERT_EQ(std::filesystem::file_size(settings.cache_path), cache_size);
+
+    // Different settings must not use the cached decomposition.
+    settings.max_hulls = 2;
+    auto other = edyn::decompose_convex(vertices, indices, settings);
+    ASSERT_EQ(other.nodes.size(), 2);
+
+    std::filesystem::remove(settings.cache_path);
+}
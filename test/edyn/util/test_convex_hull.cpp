@@ -0,0 +1,117 @@
+#include "../common/common.hpp"
+#include "edyn/util/convex_hull.hpp"
+#include <random>
+
+static void make_hull(const std::vector<edyn::vector3> &points, edyn::convex_mesh &mesh,
+                      size_t max_vertices = 0) {
+    auto ok = edyn::make_convex_hull_mesh(points, mesh.vertices, mesh.indices, mesh.faces, max_vertices);
+    ASSERT_TRUE(ok);
+
+    // Check containment before the mesh is shifted to its centroid.
+    if (max_vertices == 0) {
+        for (size_t i = 0; i < mesh.num_faces(); ++i) {
+            auto first = mesh.indices[mesh.faces[i * 2]];
+            auto v0 = mesh.vertices[first];
+            auto v1 = mesh.vertices[mesh.indices[mesh.faces[i * 2] + 1]];
+            auto v2 = mesh.vertices[mesh.indices[mesh.faces[i * 2] + 2]];
+            auto normal = edyn::normalize(edyn::cross(v1 - v0, v2 - v0));
+
+            for (auto &p : points) {
+                ASSERT_LT(edyn::dot(p - v0, normal), edyn::scalar(0.001));
+            }
+        }
+    }
+
+    mesh.initialize();
+    ASSERT_TRUE(mesh.validate());
+
+    // Euler characteristic of a convex polyhedron.
+    ASSERT_EQ(mesh.vertices.size() + mesh.num_faces(), mesh.num_edges() + 2);
+}
+
+TEST(test_convex_hull, box) {
+    auto rng = std::mt19937{};
+    auto dist = std::uniform_real_distribution<edyn::scalar>(-1, 1);
+    auto points = std::vector<edyn::vector3>{};
+
+    for (auto x : {-1, 1}) {
+        for (auto y : {-2, 2}) {
+            for (auto z : {-3, 3}) {
+                points.push_back(edyn::vector3{edyn::scalar(x), edyn::scalar(y), edyn::scalar(z)});
+            }
+        }
+    }
+
+    for (size_t i = 0; i < 1000; ++i) {
+        points.push_back({dist(rng), dist(rng) * 2, dist(rng) * 3});
+    }
+
+    auto mesh = edyn::convex_mesh{};
+    make_hull(points, mesh);
+
+    // Coplanar triangles are merged into the six faces of the box.
+    ASSERT_EQ(mesh.vertices.size(), 8);
+    ASSERT_EQ(mesh.num_faces(), 6);
+
+    for (size_t i = 0; i < mesh.num_faces(); ++i) {
+        ASSERT_EQ(mesh.faces[i * 2 + 1], 4);
+    }
+}
+
+TEST(test_convex_hull, cylinder) {
+    const size_t num_sides = 32;
+    auto points = std::vector<edyn::vector3>{};
+
+    for (size_t i = 0; i < num_sides; ++i) {
+        auto angle = edyn::scalar(i) / edyn::scalar(num_sides) * edyn::pi2;
+        auto x = std::cos(angle);
+        auto z = std::sin(angle);
+        points.push_back({x, -1, z});
+        points.push_back({x, 1, z});
+        points.push_back({x * edyn::scalar(0.5), 0, z * edyn::scalar(0.5)});
+    }
+
+    auto mesh = edyn::convex_mesh{};
+    make_hull(points, mesh);
+
+    ASSERT_EQ(mesh.vertices.size(), num_sides * 2);
+    ASSERT_EQ(mesh.num_faces(), num_sides + 2);
+}
+
+TEST(test_convex_hull, sphere_cloud) {
+    auto rng = std::mt19937{};
+    auto dist = std::normal_distribution<edyn::scalar>();
+    auto points = std::vector<edyn::vector3>{};
+
+    for (size_t i = 0; i < 5000; ++i) {
+        auto p = edyn::vector3{dist(rng), dist(rng), dist(rng)};
+
+        if (edyn::try_normalize(p)) {
+            // Push a quarter of the points inwards.
+            points.push_back(p * (i % 4 == 0 ? edyn::scalar(1.5) : edyn::scalar(2)));
+        }
+    }
+
+    auto mesh = edyn::convex_mesh{};
+    make_hull(points, mesh);
+    ASSERT_GT(mesh.vertices.size(), 1000);
+
+    auto simplified = edyn::convex_mesh{};
+    make_hull(points, simplified, 64);
+    ASSERT_LE(simplified.vertices.size(), 64);
+}
+
+TEST(test_convex_hull, degenerate) {
+    auto points = std::vector<edyn::vector3>{};
+
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < 10; ++j) {
+            points.push_back({edyn::scalar(i), 2, edyn::scalar(j)});
+        }
+    }
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices, faces;
+    ASSERT_FALSE(edyn::make_convex_hull_mesh(points, vertices, indices, faces));
+    ASSERT_FALSE(edyn::make_convex_hull_mesh({{0, 0, 0}, {1, 0, 0}, {2, 0, 0}}, vertices, indices, faces));
+}
@@ -1,6 +1,8 @@
 #include "../common/common.hpp"
 #include "edyn/replication/registry_operation.hpp"
 #include "edyn/replication/registry_operation_builder.hpp"
+#include "edyn/replication/registry_operation_pool.hpp"
+#include "edyn/replication/transform_sync.hpp"
 #include <entt/core/type_info.hpp>
 #include <entt/meta/factory.hpp>
 #include <entt/core/hashed_string.hpp>
@@ -164,3 +166,154 @@ TEST(test_registry_operation, test_impl) {
 
     ASSERT_FALSE(reg1.all_of<another_comp>(ent11));
 }
+
+TEST(test_registry_operation, test_coalesce_replacements) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+    auto emap = edyn::entity_map{};
+
+    auto ent0 = reg0.create();
+    reg0.emplace<edyn::position>(ent0, edyn::vector3{1, 0, 0});
+    reg0.emplace<edyn::linvel>(ent0, edyn::vector3{2, 0, 0});
+
+    auto builder = edyn::registry_operation_builder_impl<edyn::position, edyn::linvel>(reg0);
+    builder.create(ent0);
+    builder.emplace<edyn::position>(ent0);
+    builder.emplace<edyn::linvel>(ent0);
+
+    // Simulate multiple steps replacing the same components.
+    for (int i = 0; i < 3; ++i) {
+        reg0.get<edyn::position>(ent0).x += 1;
+        builder.replace<edyn::position>(ent0);
+    }
+
+    builder.replace<edyn::linvel>(ent0);
+
+    auto ops = builder.finish();
+    ASSERT_EQ(ops.operations.size(), 7);
+    ops.coalesce_replacements();
+
+    // Only the last replace of each component remains and the order of the
+    // remaining operations is kept.
+    ASSERT_EQ(ops.operations.size(), 5);
+    ASSERT_EQ(ops.operations[0]->operation_type(), edyn::registry_operation_type::create);
+    ASSERT_EQ(ops.operations[1]->operation_type(), edyn::registry_operation_type::emplace);
+    ASSERT_EQ(ops.operations[2]->operation_type(), edyn::registry_operation_type::emplace);
+    ASSERT_TRUE(ops.operations[3]->payload_type_any_of<edyn::position>());
+    ASSERT_TRUE(ops.operations[4]->payload_type_any_of<edyn::linvel>());
+
+    ops.execute(reg1, emap);
+    auto ent1 = emap.at(ent0);
+    ASSERT_VECTOR3_EQ(reg1.get<edyn::position>(ent1), reg0.get<edyn::position>(ent0));
+    ASSERT_VECTOR3_EQ(reg1.get<edyn::linvel>(ent1), reg0.get<edyn::linvel>(ent0));
+}
+
+TEST(test_registry_operation, test_runs_and_reuse) {
+    auto reg0 = entt::registry{};
+    auto reg1 = entt::registry{};
+    auto emap = edyn::entity_map{};
+
+    auto entities = std::vector<entt::entity>(100);
+    reg0.create(entities.begin(), entities.end());
+
+    for (auto entity : entities) {
+        reg0.emplace<edyn::position>(entity, edyn::vector3{1, 2, 3});
+        reg0.emplace<edyn::linvel>(entity, edyn::vector3{4, 5, 6});
+    }
+
+    auto builder = edyn::registry_operation_builder_impl<edyn::position, edyn::linvel>(reg0);
+    builder.create(entities.begin(), entities.end());
+    builder.emplace<edyn::position>(entities.begin(), entities.end());
+    builder.emplace<edyn::linvel>(entities.begin(), entities.end());
+
+    auto ops = builder.finish();
+    size_t num_callbacks = 0;
+
+    // Consecutive operations of the same kind are executed together but the
+    // callback is still invoked for each of them, in order.
+    ops.execute(reg1, emap, [&](edyn::operation_base *op) {
+        ASSERT_EQ(op, ops.operations[num_callbacks]);
+        ++num_callbacks;
+    });
+
+    ASSERT_EQ(num_callbacks, entities.size() * 3);
+
+    for (auto entity : entities) {
+        auto local_entity = emap.at(entity);
+        ASSERT_VECTOR3_EQ(reg1.get<edyn::position>(local_entity), (edyn::vector3{1, 2, 3}));
+        ASSERT_VECTOR3_EQ(reg1.get<edyn::linvel>(local_entity), (edyn::vector3{4, 5, 6}));
+    }
+
+    // Executed operations go back to the builder through the pool and their
+    // data blocks are reused.
+    auto pool = edyn::registry_operation_pool{};
+    auto num_blocks = ops.data_blocks.size();
+    auto *first_block = ops.data_blocks.front().data();
+    pool.release(std::move(ops));
+
+    auto recycled = pool.acquire();
+    ASSERT_TRUE(recycled.has_value());
+    ASSERT_TRUE(recycled->empty());
+    ASSERT_FALSE(pool.acquire().has_value());
+    builder.reuse(std::move(*recycled));
+
+    for (auto entity : entities) {
+        reg0.get<edyn::position>(entity).x = 7;
+    }
+
+    builder.replace<edyn::position>(entities.begin(), entities.end());
+    ops = builder.finish();
+    ASSERT_EQ(ops.data_blocks.size(), num_blocks);
+    ASSERT_EQ(ops.data_blocks.front().data(), first_block);
+
+    ops.execute(reg1, emap);
+
+    for (auto entity : entities) {
+        ASSERT_SCALAR_EQ(reg1.get<edyn::position>(emap.at(entity)).x, 7);
+    }
+}
+
+TEST(test_registry_operation, test_transform_sync) {
+    auto registry = entt::registry{};
+    auto ent0 = registry.create();
+    auto ent1 = registry.create();
+    auto ent2 = registry.create();
+
+    for (auto entity : {ent0, ent1}) {
+        registry.emplace<edyn::position>(entity, edyn::vector3_zero);
+        registry.emplace<edyn::orientation>(entity, edyn::quaternion_identity);
+        registry.emplace<edyn::linvel>(entity, edyn::vector3_zero);
+        registry.emplace<edyn::angvel>(entity, edyn::vector3_zero);
+    }
+
+    unsigned num_updates = 0;
+    auto on_update = [&](entt::registry &, entt::entity) { ++num_updates; };
+    registry.on_update<edyn::position>().connect<&decltype(on_update)::operator()>(on_update);
+
+    auto channel = edyn::transform_sync_channel{};
+    auto buffer = channel.acquire();
+    ASSERT_TRUE(buffer.empty());
+
+    auto orn = edyn::quaternion_axis_angle({0, 1, 0}, 0.5);
+    buffer.push_back(ent1, {edyn::vector3{1, 2, 3}}, {orn}, {edyn::vector3{4, 5, 6}}, {edyn::vector3{7, 8, 9}});
+    // Destroyed entities and entities without transforms are skipped.
+    buffer.push_back(ent2, {edyn::vector3_one}, {orn}, {edyn::vector3_one}, {edyn::vector3_one});
+    registry.destroy(ent2);
+    ASSERT_EQ(buffer.size(), 2);
+
+    edyn::apply_transform_sync(registry, buffer);
+
+    ASSERT_EQ(num_updates, 1);
+    ASSERT_VECTOR3_EQ(registry.get<edyn::position>(ent0), edyn::vector3_zero);
+    ASSERT_VECTOR3_EQ(registry.get<edyn::position>(ent1), (edyn::vector3{1, 2, 3}));
+    ASSERT_VECTOR3_EQ(registry.get<edyn::linvel>(ent1), (edyn::vector3{4, 5, 6}));
+    ASSERT_VECTOR3_EQ(registry.get<edyn::angvel>(ent1), (edyn::vector3{7, 8, 9}));
+    ASSERT_SCALAR_EQ(registry.get<edyn::orientation>(ent1).w, orn.w);
+
+    // Released buffers are handed out again empty, keeping their memory.
+    auto capacity = buffer.entities.capacity();
+    channel.release(std::move(buffer));
+    auto recycled = channel.acquire();
+    ASSERT_TRUE(recycled.empty());
+    ASSERT_EQ(recycled.entities.capacity(), capacity);
+}
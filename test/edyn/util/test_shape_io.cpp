@@ -0,0 +1,169 @@
+#include "../common/common.hpp"
+#include "edyn/util/shape_io.hpp"
+#include "edyn/util/shape_util.hpp"
+#include "edyn/shapes/triangle_mesh.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+// Runs all tasks in the calling thread, which still splits the input into
+// chunks.
+static void enqueue_task_wait_inline(edyn::task_delegate_t task, unsigned size) {
+    for (unsigned i = 0; i < size; ++i) {
+        task(i, i + 1);
+    }
+}
+
+TEST(test_shape_io, obj_meshes) {
+    auto ss = std::stringstream{};
+    ss << "# Comment\r\n";
+    ss << "o first \r\n";
+    ss << "v 0 0 0 1 0 0\r\n";
+    ss << "v 1.5 0 0 0 1 0\r\n";
+    ss << "v 1.5 2e-1 0 0 0 1\r\n";
+    ss << "v -0 +1 -3.25E+1 1 1 1\r\n";
+    ss << "vn 0 0 1\r\n";
+    ss << "f 1/1/1 2/2/1 3/3/1 4/4/1\r\n";
+    ss << "o second\n";
+    ss << "v 0 0 0\n";
+    ss << "v 1 0 0\n";
+    ss << "v 0 1 0\n";
+    ss << "f 5//1 6//1 7//1\n";
+
+    auto meshes = std::vector<edyn::obj_mesh>{};
+    edyn::load_meshes_from_obj(ss, meshes);
+
+    ASSERT_EQ(meshes.size(), 2);
+    ASSERT_EQ(meshes[0].name, "first");
+    ASSERT_EQ(meshes[1].name, "second");
+
+    ASSERT_EQ(meshes[0].vertices.size(), 4);
+    ASSERT_EQ(meshes[0].colors.size(), 4);
+    ASSERT_VECTOR3_EQ(meshes[0].vertices[2], edyn::vector3{1.5, 0.2, 0});
+    ASSERT_VECTOR3_EQ(meshes[0].vertices[3], edyn::vector3{0, 1, -32.5});
+    ASSERT_VECTOR3_EQ(meshes[0].colors[1], edyn::vector3{0, 1, 0});
+    ASSERT_EQ(meshes[0].indices, (std::vector<uint32_t>{0, 1, 2, 3}));
+    ASSERT_EQ(meshes[0].faces, (std::vector<uint32_t>{0, 4}));
+
+    // Indices are relative to the first vertex of each mesh.
+    ASSERT_EQ(meshes[1].vertices.size(), 3);
+    ASSERT_TRUE(meshes[1].colors.empty());
+    ASSERT_EQ(meshes[1].indices, (std::vector<uint32_t>{0, 1, 2}));
+}
+
+TEST(test_shape_io, obj_tri_mesh_chunks) {
+    // Make a file large enough to be split into several chunks.
+    const uint32_t size = 200;
+    auto ss = std::stringstream{};
+
+    for (uint32_t z = 0; z < size; ++z) {
+        for (uint32_t x = 0; x < size; ++x) {
+            ss << "v " << x * 0.25 << " " << (x + z) % 7 * 0.125 << " " << z * 0.25 << "\n";
+        }
+    }
+
+    for (uint32_t z = 0; z + 1 < size; ++z) {
+        for (uint32_t x = 0; x + 1 < size; ++x) {
+            auto i = z * size + x + 1;
+            ss << "f " << i << " " << i + size << " " << i + size + 1 << " " << i + 1 << "\n";
+        }
+    }
+
+    auto path = "test_shape_io.obj";
+
+    {
+        auto file = std::ofstream(path);
+        file << ss.str();
+    }
+
+    std::vector<edyn::vector3> vertices, chunked_vertices;
+    std::vector<uint32_t> indices, chunked_indices;
+    edyn::load_tri_mesh_from_obj(ss, vertices, indices);
+    ASSERT_TRUE(edyn::load_tri_mesh_from_obj(path, chunked_vertices, chunked_indices, nullptr,
+                                             edyn::vector3_zero, edyn::quaternion_identity,
+                                             edyn::vector3_one, &enqueue_task_wait_inline));
+
+    // Quads are split in two triangles.
+    ASSERT_EQ(vertices.size(), size * size);
+    ASSERT_EQ(indices.size(), (size - 1) * (size - 1) * 6);
+    ASSERT_EQ(indices, chunked_indices);
+    ASSERT_EQ(vertices.size(), chunked_vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        ASSERT_VECTOR3_EQ(vertices[i], chunked_vertices[i]);
+    }
+
+    std::remove(path);
+}
+
+TEST(test_shape_io, binary_mesh) {
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices, faces;
+    edyn::make_box_mesh({1, 2, 3}, vertices, indices, faces);
+
+    auto path = "test_shape_io_box.bin";
+    ASSERT_TRUE(edyn::write_mesh_to_binary(path, vertices, indices, faces));
+
+    auto mesh = edyn::convex_mesh{};
+    ASSERT_TRUE(edyn::load_convex_mesh_from_binary(path, mesh));
+    ASSERT_EQ(mesh.vertices.size(), vertices.size());
+    ASSERT_EQ(mesh.indices, indices);
+    ASSERT_EQ(mesh.faces, faces);
+    ASSERT_EQ(mesh.normals.size(), 6);
+
+    // Box has quads thus it can't be loaded as a triangle mesh.
+    auto trimesh = edyn::triangle_mesh{};
+    ASSERT_FALSE(edyn::load_triangle_mesh_from_binary(path, trimesh));
+
+    std::vector<edyn::vector3> plane_vertices;
+    std::vector<uint32_t> plane_indices;
+    edyn::make_plane_mesh(4, 4, 5, 5, plane_vertices, plane_indices);
+    ASSERT_TRUE(edyn::write_mesh_to_binary(path, plane_vertices, plane_indices));
+    ASSERT_TRUE(edyn::load_triangle_mesh_from_binary(path, trimesh));
+    ASSERT_EQ(trimesh.num_vertices(), plane_vertices.size());
+    ASSERT_EQ(trimesh.num_triangles(), plane_indices.size() / 3);
+
+    // Binary meshes are validated.
+    {
+        auto file = std::ofstream(path, std::ios::binary);
+        file << "EDMB";
+    }
+
+    ASSERT_FALSE(edyn::load_convex_mesh_from_binary(path, mesh));
+
+    // Counts whose total size overflows must be rejected.
+    {
+        uint32_t header_fields[] = {1, sizeof(edyn::scalar), 0};
+        uint64_t counts[] = {(uint64_t(1) << 62) + 1, 0, 0};
+        auto file = std::ofstream(path, std::ios::binary);
+        file.write("EDMB", 4);
+        file.write(reinterpret_cast<const char *>(header_fields), sizeof(header_fields));
+        file.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+    }
+
+    ASSERT_FALSE(edyn::load_convex_mesh_from_binary(path, mesh));
+    ASSERT_FALSE(edyn::load_triangle_mesh_from_binary(path, trimesh));
+
+    std::remove(path);
+}
+
+TEST(test_shape_io, empty_obj_file) {
+    auto path = "test_shape_io_empty.obj";
+
+    {
+        auto file = std::ofstream(path);
+    }
+
+    // An empty file is valid and has no meshes.
+    auto meshes = std::vector<edyn::obj_mesh>{};
+    ASSERT_TRUE(edyn::load_meshes_from_obj(path, meshes));
+    ASSERT_TRUE(meshes.empty());
+
+    std::vector<edyn::vector3> vertices;
+    std::vector<uint32_t> indices;
+    ASSERT_TRUE(edyn::load_tri_mesh_from_obj(path, vertices, indices));
+    ASSERT_TRUE(vertices.empty());
+    ASSERT_TRUE(indices.empty());
+
+    std::remove(path);
+}